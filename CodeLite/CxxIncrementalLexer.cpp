@@ -0,0 +1,169 @@
+#include "CxxIncrementalLexer.h"
+#include <algorithm>
+#include <iterator>
+
+CxxIncrementalLexer::CxxIncrementalLexer(size_t options, int checkpointInterval)
+    : m_options(options)
+    , m_checkpointInterval(checkpointInterval)
+    , m_linesLexed(0)
+{
+}
+
+CxxIncrementalLexer::~CxxIncrementalLexer() {}
+
+void CxxIncrementalLexer::Clear()
+{
+    m_buffer.clear();
+    m_tokens.clear();
+    m_checkpoints.clear();
+    m_linesLexed = 0;
+}
+
+void CxxIncrementalLexer::DoLexAll(const wxString& buffer)
+{
+    Clear();
+    m_buffer = buffer;
+    if(buffer.empty()) { return; }
+
+    Scanner_t scanner = ::LexerNew(buffer, m_options);
+    ::LexerSetCheckpointInterval(scanner, m_checkpointInterval);
+    while(true) {
+        CxxLexerToken token;
+        if(!::LexerNext(scanner, token)) { break; }
+        m_tokens.push_back(token);
+    }
+    m_checkpoints = ::LexerGetUserData(scanner)->GetCheckpoints();
+    ::LexerDestroy(&scanner);
+    m_linesLexed = std::count(buffer.begin(), buffer.end(), '\n') + 1;
+}
+
+void CxxIncrementalLexer::Update(const wxString& buffer)
+{
+    if(m_buffer.empty() || buffer.empty()) {
+        DoLexAll(buffer);
+        return;
+    }
+
+    // Find the common prefix of the old and new buffers. While doing so, keep the last checkpoint found
+    // in the prefix: this is where we resume lexing
+    size_t oldLen = m_buffer.length();
+    size_t newLen = buffer.length();
+    size_t minLen = std::min(oldLen, newLen);
+
+    CxxLexerState resume; // start of the buffer
+    size_t resumeOffset = 0;
+    size_t nextCheckpoint = 0;
+    int line = 0;
+    size_t prefix = 0;
+    wxString::const_iterator oldIter = m_buffer.begin();
+    wxString::const_iterator newIter = buffer.begin();
+    for(; (prefix < minLen) && (*oldIter == *newIter); ++prefix, ++oldIter, ++newIter) {
+        if(*newIter != '\n') { continue; }
+        ++line;
+        while((nextCheckpoint < m_checkpoints.size()) && (m_checkpoints[nextCheckpoint].lineNumber < line)) {
+            ++nextCheckpoint;
+        }
+        if((nextCheckpoint < m_checkpoints.size()) && (m_checkpoints[nextCheckpoint].lineNumber == line)) {
+            resume = m_checkpoints[nextCheckpoint];
+            resumeOffset = prefix + 1;
+        }
+    }
+
+    if((prefix == oldLen) && (prefix == newLen)) {
+        // nothing changed
+        m_linesLexed = 0;
+        return;
+    }
+
+    // And the common suffix
+    size_t suffix = 0;
+    wxString::const_reverse_iterator oldRIter = m_buffer.rbegin();
+    wxString::const_reverse_iterator newRIter = buffer.rbegin();
+    for(; (suffix < (minLen - prefix)) && (*oldRIter == *newRIter); ++suffix, ++oldRIter, ++newRIter) {}
+
+    // Lines after 'lastChangedLine' are not modified, they moved by 'delta' lines
+    int oldChangedLines = std::count(oldIter, oldIter + (oldLen - suffix - prefix), '\n');
+    int newChangedLines = std::count(newIter, newIter + (newLen - suffix - prefix), '\n');
+    int delta = newChangedLines - oldChangedLines;
+    int lastChangedLine = line + newChangedLines;
+
+    wxString text = buffer.Mid(resumeOffset);
+    Scanner_t scanner = ::LexerNew(text, m_options, resume);
+    // record every line so we notice as soon as the state converges with the previous run
+    ::LexerSetCheckpointInterval(scanner, 1);
+    CppLexerUserData* userData = ::LexerGetUserData(scanner);
+
+    CxxLexerToken::Vect_t lexed;
+    CxxLexerState::Vec_t newCheckpoints;
+    int lastCheckpointLine = resume.lineNumber;
+    size_t processed = 0;
+    bool converged = false;
+    CxxLexerState convergedAt, oldConvergedAt;
+    while(!converged) {
+        CxxLexerToken token;
+        bool more = ::LexerNext(scanner, token);
+
+        const CxxLexerState::Vec_t& checkpoints = userData->GetCheckpoints();
+        for(; processed < checkpoints.size(); ++processed) {
+            const CxxLexerState& checkpoint = checkpoints[processed];
+            if(checkpoint.lineNumber > lastChangedLine) {
+                int oldLine = checkpoint.lineNumber - delta;
+                CxxLexerState::Vec_t::const_iterator iter =
+                    std::lower_bound(m_checkpoints.begin(), m_checkpoints.end(), oldLine,
+                                     [](const CxxLexerState& state, int l) { return state.lineNumber < l; });
+                if((iter != m_checkpoints.end()) && (iter->lineNumber == oldLine) &&
+                   iter->IsSameScannerState(checkpoint)) {
+                    // From here on, the previous run tokens are valid
+                    converged = true;
+                    convergedAt = checkpoint;
+                    oldConvergedAt = *iter;
+                    break;
+                }
+            }
+            if((checkpoint.lineNumber - lastCheckpointLine) >= m_checkpointInterval) {
+                lastCheckpointLine = checkpoint.lineNumber;
+                newCheckpoints.push_back(checkpoint);
+            }
+        }
+
+        // the current token was returned after the convergence point
+        if(!more || converged) { break; }
+        lexed.push_back(token); // copy: the token text points into the scanner buffer
+    }
+    ::LexerDestroy(&scanner);
+
+    // Replace the tokens between the resume point and the convergence point
+    size_t lastReplaced = converged ? oldConvergedAt.tokenIndex : m_tokens.size();
+    if(converged && delta) {
+        for(size_t i = lastReplaced; i < m_tokens.size(); ++i) {
+            m_tokens[i].SetLineNumber(m_tokens[i].GetLineNumber() + delta);
+        }
+    }
+    m_tokens.erase(m_tokens.begin() + resume.tokenIndex, m_tokens.begin() + lastReplaced);
+    m_tokens.insert(m_tokens.begin() + resume.tokenIndex, std::make_move_iterator(lexed.begin()),
+                    std::make_move_iterator(lexed.end()));
+
+    // And the checkpoints
+    CxxLexerState::Vec_t::iterator resumeIter =
+        std::upper_bound(m_checkpoints.begin(), m_checkpoints.end(), resume.lineNumber,
+                         [](int l, const CxxLexerState& state) { return l < state.lineNumber; });
+    CxxLexerState::Vec_t checkpoints(m_checkpoints.begin(), resumeIter);
+    checkpoints.insert(checkpoints.end(), newCheckpoints.begin(), newCheckpoints.end());
+    if(converged) {
+        long tokensDelta = (long)convergedAt.tokenIndex - (long)oldConvergedAt.tokenIndex;
+        CxxLexerState::Vec_t::iterator iter =
+            std::lower_bound(m_checkpoints.begin(), m_checkpoints.end(), oldConvergedAt.lineNumber,
+                             [](const CxxLexerState& state, int l) { return state.lineNumber < l; });
+        for(; iter != m_checkpoints.end(); ++iter) {
+            CxxLexerState checkpoint = *iter;
+            checkpoint.lineNumber += delta;
+            checkpoint.tokenIndex += tokensDelta;
+            checkpoints.push_back(checkpoint);
+        }
+        m_linesLexed = convergedAt.lineNumber - resume.lineNumber;
+    } else {
+        m_linesLexed = std::count(text.begin(), text.end(), '\n') + 1;
+    }
+    m_checkpoints.swap(checkpoints);
+    m_buffer = buffer;
+}
@@ -0,0 +1,48 @@
+#ifndef CXXINCREMENTALLEXER_H
+#define CXXINCREMENTALLEXER_H
+
+#include "CxxLexerAPI.h"
+#include "codelite_exports.h"
+
+/**
+ * @class CxxIncrementalLexer
+ * @brief keeps the tokens of a buffer and updates them after the buffer is modified.
+ * The lexer state is recorded every few lines while lexing. After an edit, lexing resumes from the last
+ * checkpoint before the modified text and stops as soon as the lexer state converges with the previous run:
+ * the remaining tokens are taken from the previous run
+ */
+class WXDLLIMPEXP_CL CxxIncrementalLexer
+{
+    size_t m_options;
+    int m_checkpointInterval;
+    wxString m_buffer;
+    CxxLexerToken::Vect_t m_tokens;
+    CxxLexerState::Vec_t m_checkpoints;
+    size_t m_linesLexed;
+
+protected:
+    void DoLexAll(const wxString& buffer);
+
+public:
+    CxxIncrementalLexer(size_t options = kLexerOpt_None, int checkpointInterval = 50);
+    virtual ~CxxIncrementalLexer();
+
+    /**
+     * @brief update the tokens to match 'buffer'
+     */
+    void Update(const wxString& buffer);
+
+    /**
+     * @brief forget the current buffer, the next update lexes the whole buffer
+     */
+    void Clear();
+
+    const CxxLexerToken::Vect_t& GetTokens() const { return m_tokens; }
+    const wxString& GetBuffer() const { return m_buffer; }
+    /**
+     * @brief return the number of lines lexed by the last update
+     */
+    size_t GetLinesLexed() const { return m_linesLexed; }
+};
+
+#endif // CXXINCREMENTALLEXER_H
@@ -993,7 +993,14 @@ extern "C" int yywrap(void*) { return 1; }
 #define P(s) 
 
 #define YY_NO_UNISTD_H
-#define YY_USER_ACTION  yycolumn += yyleng;
+#define YY_USER_ACTION                                                  \
+    if(((CppLexerUserData*)yyg->yyextra_r)->IsRecordingCheckpoints()) { \
+        LexerRecordCheckpoint(yyg);                                     \
+    }                                                                   \
+    yycolumn += yyleng;
+
+struct yyguts_t;
+static void LexerRecordCheckpoint(struct yyguts_t* yyg);
 #define RETURN_WHITESPACE()                                         \
     CppLexerUserData* userData = (CppLexerUserData*)yyg->yyextra_r; \
     if(userData->IsCollectingWhitespace()) {                        \
@@ -3329,10 +3336,28 @@ void* LexerNew(const wxString& content, size_t options )
     
     wxCharBuffer cb = content.mb_str(wxConvUTF8);
     yy_switch_to_buffer(yy_scan_string(cb.data(),scanner),scanner);
+    // yy_scan_string does not initialize the line number
+    yylineno = 0;
     yycolumn = 1;
     return scanner;
 }
 
+void* LexerNew(const wxString& content, size_t options, const CxxLexerState& state)
+{
+    void* scanner = LexerNew(content, options);
+    struct yyguts_t * yyg = (struct yyguts_t*)scanner;
+    CppLexerUserData *userData = (CppLexerUserData*)yyg->yyextra_r;
+    
+    // restore the state of the original scanner at the start of the line
+    BEGIN(state.startCondition);
+    userData->SetPreProcessorSection(state.inPreProcessor);
+    userData->SetTokensCount(state.tokenIndex);
+    userData->SetLastCheckpointLine(state.lineNumber);
+    yylineno = state.lineNumber;
+    yycolumn = state.column;
+    return scanner;
+}
+
 void* LexerNew(const wxFileName& filename, size_t options )
 {
     wxFileName fn = filename;
@@ -3372,6 +3397,10 @@ void LexerUnget(void* scanner)
 {
     // return the entire token back to the input stream
     struct yyguts_t * yyg = (struct yyguts_t*)scanner;
+    CppLexerUserData* userData = (CppLexerUserData*)yyg->yyextra_r;
+    userData->DecrementTokensCount();
+    // we no longer know if the next match starts a line
+    userData->SetAtLineStart(false);
     yyless(0);
 }
 
@@ -3382,6 +3411,7 @@ bool LexerNext(void* scanner, CxxLexerToken& token)
     if(!token.IsEOF()) {
         struct yyguts_t * yyg = (struct yyguts_t*)scanner;
         CppLexerUserData* userData = (CppLexerUserData*)yyg->yyextra_r;
+        userData->IncrementTokensCount();
         switch(token.GetType()) {
         case T_CXX_COMMENT:
             // One line up for CXX comments
@@ -3415,6 +3445,37 @@ wxString LexerCurrentToken(void* scanner)
     return yytext;
 }
 
+void LexerSetCheckpointInterval(void* scanner, int interval)
+{
+    struct yyguts_t * yyg = (struct yyguts_t*)scanner;
+    ((CppLexerUserData*)yyg->yyextra_r)->SetCheckpointInterval(interval);
+}
+
+// Called before every rule action. When the previous match ended with a new line, the current
+// match starts a line and the scanner state is the state at the start of that line
+static void LexerRecordCheckpoint(struct yyguts_t* yyg)
+{
+    CppLexerUserData* userData = (CppLexerUserData*)yyg->yyextra_r;
+    if(userData->IsAtLineStart()) {
+        // A comment spanning multiple lines can't be resumed if we are collecting it
+        bool inComment = (YY_START == C_COMMENT) || (YY_START == CPP_COMMENT);
+        if(!inComment || !userData->IsCollectingComments()) {
+            CxxLexerState state;
+            state.startCondition = YY_START;
+            state.lineNumber = yylineno;
+            for(int i = 0; i < yyleng; ++i) {
+                if(yytext[i] == '\n') { --state.lineNumber; }
+            }
+            // the column is not advanced yet for this match: this is the column at the start of the line
+            state.column = yycolumn;
+            state.inPreProcessor = userData->IsInPreProcessorSection();
+            state.tokenIndex = userData->GetTokensCount();
+            userData->AddCheckpoint(state);
+        }
+    }
+    userData->SetAtLineStart((yyleng > 0) && (yytext[yyleng - 1] == '\n'));
+}
+
 CppLexerUserData* LexerGetUserData(void* scanner)
 {
     struct yyguts_t * yyg = (struct yyguts_t*)scanner;
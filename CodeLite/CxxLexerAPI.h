@@ -138,6 +138,8 @@ public:
     }
 
     CxxLexerToken(const CxxLexerToken& other)
+        : text(NULL)
+        , m_owned(false)
     {
         if(this == &other) return;
         *this = other;
@@ -145,10 +147,12 @@ public:
 
     CxxLexerToken& operator=(const CxxLexerToken& other)
     {
+        if(this == &other) return *this;
         deleteText();
         lineNumber = other.lineNumber;
         column = other.column;
         type = other.type;
+        comment = other.comment;
         if(other.text) {
             m_owned = true;
 #ifdef __WXMSW__
@@ -160,6 +164,33 @@ public:
         return *this;
     }
 
+    CxxLexerToken(CxxLexerToken&& other)
+        : lineNumber(other.lineNumber)
+        , column(other.column)
+        , text(other.text)
+        , type(other.type)
+        , comment(std::move(other.comment))
+        , m_owned(other.m_owned)
+    {
+        other.text = NULL;
+        other.m_owned = false;
+    }
+
+    CxxLexerToken& operator=(CxxLexerToken&& other)
+    {
+        if(this == &other) return *this;
+        deleteText();
+        lineNumber = other.lineNumber;
+        column = other.column;
+        type = other.type;
+        comment = std::move(other.comment);
+        text = other.text;
+        m_owned = other.m_owned;
+        other.text = NULL;
+        other.m_owned = false;
+        return *this;
+    }
+
     ~CxxLexerToken() { deleteText(); }
     bool IsEOF() const { return type == 0; }
 
@@ -178,6 +209,40 @@ struct WXDLLIMPEXP_CL CxxPreProcessorToken
     }
     typedef std::unordered_map<wxString, CxxPreProcessorToken> Map_t;
 };
+
+/**
+ * @class CxxLexerState
+ * @brief the scanner state at the start of a line. A scanner created with this state over the text that starts at
+ * this line returns exactly the tokens that the original scanner returned from this line on
+ */
+struct WXDLLIMPEXP_CL CxxLexerState
+{
+    int startCondition;  ///< the flex start condition (INITIAL, PREPR...)
+    int lineNumber;      ///< 0 based, like the tokens line numbers
+    int column;          ///< the scanner column at the start of the line
+    bool inPreProcessor; ///< kLexerState_InPreProcessor
+    size_t tokenIndex;   ///< the number of tokens returned before this line
+
+    CxxLexerState()
+        : startCondition(0)
+        , lineNumber(0)
+        , column(1)
+        , inPreProcessor(false)
+        , tokenIndex(0)
+    {
+    }
+
+    /**
+     * @brief do both states lex the rest of the line the same way?
+     */
+    bool IsSameScannerState(const CxxLexerState& other) const
+    {
+        return startCondition == other.startCondition && inPreProcessor == other.inPreProcessor &&
+               column == other.column;
+    }
+    typedef std::vector<CxxLexerState> Vec_t;
+};
+
 /**
  * @class CppLexerUserData
  */
@@ -191,6 +256,13 @@ private:
     int m_commentEndLine;
     FILE* m_currentPF;
 
+    // Checkpoints
+    int m_checkpointInterval;
+    int m_lastCheckpointLine;
+    bool m_atLineStart;
+    size_t m_tokensCount;
+    CxxLexerState::Vec_t m_checkpoints;
+
 public:
     void Clear()
     {
@@ -208,6 +280,10 @@ public:
         , m_commentStartLine(wxNOT_FOUND)
         , m_commentEndLine(wxNOT_FOUND)
         , m_currentPF(NULL)
+        , m_checkpointInterval(0)
+        , m_lastCheckpointLine(0)
+        , m_atLineStart(false)
+        , m_tokensCount(0)
     {
     }
 
@@ -245,6 +321,32 @@ public:
         m_commentStartLine = wxNOT_FOUND;
         m_commentEndLine = wxNOT_FOUND;
     }
+
+    //==--------------------
+    // Checkpoints
+    //==--------------------
+    bool IsRecordingCheckpoints() const { return m_checkpointInterval > 0; }
+    void SetCheckpointInterval(int interval) { this->m_checkpointInterval = interval; }
+    void SetLastCheckpointLine(int line) { this->m_lastCheckpointLine = line; }
+    void SetAtLineStart(bool b) { this->m_atLineStart = b; }
+    bool IsAtLineStart() const { return m_atLineStart; }
+    void SetTokensCount(size_t count) { this->m_tokensCount = count; }
+    size_t GetTokensCount() const { return m_tokensCount; }
+    void IncrementTokensCount() { ++m_tokensCount; }
+    void DecrementTokensCount()
+    {
+        if(m_tokensCount) { --m_tokensCount; }
+    }
+    /**
+     * @brief keep the state if it is at least 'interval' lines after the previous checkpoint
+     */
+    void AddCheckpoint(const CxxLexerState& state)
+    {
+        if((state.lineNumber - m_lastCheckpointLine) < m_checkpointInterval) { return; }
+        m_lastCheckpointLine = state.lineNumber;
+        m_checkpoints.push_back(state);
+    }
+    const CxxLexerState::Vec_t& GetCheckpoints() const { return m_checkpoints; }
 };
 
 typedef void* Scanner_t;
@@ -253,6 +355,18 @@ typedef void* Scanner_t;
  */
 WXDLLIMPEXP_CL Scanner_t LexerNew(const wxString& buffer, size_t options = kLexerOpt_None);
 
+/**
+ * @brief create a Lexer that resumes scanning from a checkpoint. 'buffer' is the text that starts at the
+ * checkpoint line
+ */
+WXDLLIMPEXP_CL Scanner_t LexerNew(const wxString& buffer, size_t options, const CxxLexerState& state);
+
+/**
+ * @brief record the scanner state at the start of a line, at most once every 'interval' lines.
+ * The recorded states are available from LexerGetUserData(scanner)->GetCheckpoints()
+ */
+WXDLLIMPEXP_CL void LexerSetCheckpointInterval(Scanner_t scanner, int interval);
+
 /**
  * @brief create a scanner for a given file name
  */
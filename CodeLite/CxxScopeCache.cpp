@@ -0,0 +1,206 @@
+#include "CxxScopeCache.h"
+#include "CxxLexerAPI.h"
+#include "CxxScannerTokens.h"
+#include "CxxVariableScanner.h"
+#include "clPerfTrace.h"
+#include "language.h"
+#include <vector>
+
+// Upper limit for the number of files kept in the cache
+#define SCOPE_CACHE_MAX_FILES 20
+
+CxxScopeCache::CxxScopeCache() {}
+
+CxxScopeCache::~CxxScopeCache() {}
+
+CxxScopeCache& CxxScopeCache::Get()
+{
+    static CxxScopeCache theCache;
+    return theCache;
+}
+
+size_t CxxScopeCache::DoFindLastTopLevelLine(const wxString& text, int& namespaceDepth)
+{
+    namespaceDepth = 0;
+    Scanner_t scanner = ::LexerNew(text);
+    if(!scanner) { return 0; }
+
+    // Record the scanner state at the start of every line
+    ::LexerSetCheckpointInterval(scanner, 1);
+    CppLexerUserData* userData = ::LexerGetUserData(scanner);
+
+    // The blocks of 'namespace X {' and 'extern "C" {' are not counted in 'depth': the declarations they contain are
+    // at the top level
+    std::vector<bool> braces; // true for a namespace block
+    bool namespaceHeader = false;
+    bool namespaceOpened = false; // the last token opened a namespace block
+    int depth = 0;
+    int currentNamespaceDepth = 0;
+    int lastType = 0;    // the last token outside of the pre-processor sections
+    int lastAnyType = 0; // the last token, lambdas are detected by looking at it
+    int topLevelLine = 0;
+    size_t processed = 0;
+    CxxLexerToken token;
+    while(::LexerNext(scanner, token)) {
+        // The checkpoints recorded while reading this token are for lines that start before it
+        const CxxLexerState::Vec_t& checkpoints = userData->GetCheckpoints();
+        for(; processed < checkpoints.size(); ++processed) {
+            const CxxLexerState& state = checkpoints[processed];
+            if((depth == 0) && (state.startCondition == 0 /* INITIAL */) && !state.inPreProcessor &&
+               ((lastType == ';') || (lastType == '}') || namespaceOpened) && (lastAnyType != ']')) {
+                topLevelLine = state.lineNumber;
+                namespaceDepth = currentNamespaceDepth;
+            }
+        }
+
+        lastAnyType = token.GetType();
+        if(userData->IsInPreProcessorSection() || (token.GetType() == T_PP_STATE_EXIT)) { continue; }
+        namespaceOpened = false;
+        switch(token.GetType()) {
+        case T_NAMESPACE:
+            namespaceHeader = true;
+            break;
+        case T_STRING:
+            namespaceHeader = (lastType == T_EXTERN);
+            break;
+        case T_IDENTIFIER:
+        case T_DOUBLE_COLONS:
+            break;
+        case '{':
+            braces.push_back(namespaceHeader && (depth == 0));
+            if(braces.back()) {
+                ++currentNamespaceDepth;
+                namespaceOpened = true;
+            } else {
+                ++depth;
+            }
+            namespaceHeader = false;
+            break;
+        case '}':
+            // An unmatched brace closes a block opened before 'text'
+            if(braces.empty() || braces.back()) {
+                --currentNamespaceDepth;
+            } else {
+                --depth;
+            }
+            if(!braces.empty()) { braces.pop_back(); }
+            namespaceHeader = false;
+            break;
+        case '(':
+            ++depth;
+            namespaceHeader = false;
+            break;
+        case ')':
+            --depth;
+            namespaceHeader = false;
+            break;
+        default:
+            namespaceHeader = false;
+            break;
+        }
+        lastType = token.GetType();
+    }
+    ::LexerDestroy(&scanner);
+
+    // Convert the line into an offset
+    size_t offset = 0;
+    for(int line = 0; (line < topLevelLine) && (offset < text.length()); ++offset) {
+        if(text[offset] == '\n') { ++line; }
+    }
+    return offset;
+}
+
+bool CxxScopeCache::DoAnalyse(const wxString& text, const wxStringTable_t& ignoreTokens, Entry& entry)
+{
+    // Only the text after the prefix needs to be scanned
+    wxString rest = text.Mid(entry.m_prefix.length());
+    CxxVariableScanner scanner(wxEmptyString, eCxxStandard::kCxx11, ignoreTokens, false);
+
+    // Move the prefix forward, up to the function the caret is in. The prefix may end inside namespace blocks: the
+    // analysis of the text that follows is then appended to theirs
+    wxString head, headScope, headStripped;
+    int namespaceDepth = 0;
+    size_t offset = DoFindLastTopLevelLine(rest, namespaceDepth);
+    if((offset > 0) && (namespaceDepth >= 0)) {
+        head = rest.Left(offset);
+        int scopeBlocks = wxNOT_FOUND;
+        int strippedBlocks = scanner.OptimizeBuffer(head, headStripped);
+        if(!Language::DoOptimizeScope(head, headScope, &scopeBlocks) || (scopeBlocks != namespaceDepth) ||
+           (strippedBlocks != namespaceDepth)) {
+            head.clear();
+        }
+    }
+
+    // When the rest closes a block opened in the prefix, the analysis of the whole text is not the concatenation of
+    // the two
+    wxString restScope, restStripped;
+    bool scopeOk = Language::DoOptimizeScope(rest.Mid(head.length()), restScope);
+    bool strippedOk = (scanner.OptimizeBuffer(rest.Mid(head.length()), restStripped) != wxNOT_FOUND);
+    if((!scopeOk || !strippedOk) && !head.IsEmpty()) {
+        head.clear();
+        scopeOk = Language::DoOptimizeScope(rest, restScope);
+        strippedOk = (scanner.OptimizeBuffer(rest, restStripped) != wxNOT_FOUND);
+    }
+    if((!scopeOk || !strippedOk) && !entry.m_prefix.IsEmpty()) { return false; }
+
+    if(!head.IsEmpty()) {
+        entry.m_prefix << head;
+        entry.m_prefixScope << headScope;
+        entry.m_prefixStripped << headStripped;
+        rest.Remove(0, head.length());
+    }
+    CL_TRACE_COUNTER("completion", "Scope analysis scanned chars", rest.length());
+
+    entry.m_analysis.m_optimizedScope.clear();
+    if(scopeOk) { entry.m_analysis.m_optimizedScope << entry.m_prefixScope << restScope; }
+    entry.m_analysis.m_visibleScope.clear();
+    entry.m_analysis.m_visibleScope << entry.m_prefixStripped << restStripped;
+    entry.m_text = text;
+    return true;
+}
+
+void CxxScopeCache::GetAnalysis(const wxString& filename, const wxString& text, const wxStringTable_t& ignoreTokens,
+                                Analysis& analysis)
+{
+    CL_TRACE_SCOPE("completion", "CxxScopeCache::GetAnalysis");
+    Entry entry;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::unordered_map<wxString, Entry>::const_iterator iter = m_entries.find(filename);
+        if(iter != m_entries.end()) {
+            const Entry& cached = iter->second;
+            if(cached.m_text == text) {
+                analysis = cached.m_analysis;
+                return;
+            }
+            if(text.StartsWith(cached.m_prefix)) {
+                entry.m_prefix = cached.m_prefix;
+                entry.m_prefixScope = cached.m_prefixScope;
+                entry.m_prefixStripped = cached.m_prefixStripped;
+            }
+        }
+    }
+
+    if(!DoAnalyse(text, ignoreTokens, entry)) {
+        // The cached prefix can not be used, start over from the beginning of the text
+        entry = Entry();
+        DoAnalyse(text, ignoreTokens, entry);
+    }
+    analysis = entry.m_analysis;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if((m_entries.size() >= SCOPE_CACHE_MAX_FILES) && (m_entries.count(filename) == 0)) { m_entries.clear(); }
+    m_entries[filename] = entry;
+}
+
+void CxxScopeCache::Remove(const wxString& filename)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.erase(filename);
+}
+
+void CxxScopeCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+}
@@ -0,0 +1,76 @@
+#ifndef CXXSCOPECACHE_H
+#define CXXSCOPECACHE_H
+
+#include "codelite_exports.h"
+#include "macros.h"
+#include "wxStringHash.h"
+#include <mutex>
+#include <wx/string.h>
+
+/**
+ * @class CxxScopeCache
+ * @brief caches the scope analysis of the editors text (the text from the start of the file up to the caret)
+ * For every file, we keep the analysis of the text that comes before the function the caret is in. As long as this
+ * prefix is not modified, only the text that follows it is scanned again. The cache is refreshed from the parser
+ * thread after the user edits a file, so code completion usually finds the analysis ready
+ */
+class WXDLLIMPEXP_CL CxxScopeCache
+{
+public:
+    struct Analysis {
+        wxString m_optimizedScope; ///< The visible scope, see Language::OptimizeScope()
+        wxString m_visibleScope;   ///< The text stripped from unreachable blocks, see CxxVariableScanner::OptimizeBuffer()
+    };
+
+protected:
+    struct Entry {
+        wxString m_prefix;         ///< The text before the current function, only namespace blocks are open at its end
+        wxString m_prefixScope;    ///< Language::OptimizeScope() of the prefix
+        wxString m_prefixStripped; ///< CxxVariableScanner::OptimizeBuffer() of the prefix
+        wxString m_text;           ///< The text of the last analysis
+        Analysis m_analysis;
+    };
+    std::unordered_map<wxString, Entry> m_entries;
+    std::mutex m_mutex;
+
+protected:
+    /**
+     * @brief return the offset of the last line in 'text' that starts outside of any block (namespace blocks
+     * excepted) and right after a ';', a '}' or the '{' of a namespace. Return 0 if there is no such line
+     * @param namespaceDepth [output] the number of namespace blocks that are open at the start of the line
+     */
+    static size_t DoFindLastTopLevelLine(const wxString& text, int& namespaceDepth);
+
+    /**
+     * @brief analyse 'text', starting after the prefix of 'entry'. The prefix is moved forward and the analysis is
+     * stored in 'entry'. Return false if the prefix can not be used for 'text'
+     */
+    static bool DoAnalyse(const wxString& text, const wxStringTable_t& ignoreTokens, Entry& entry);
+
+private:
+    CxxScopeCache();
+    ~CxxScopeCache();
+
+public:
+    static CxxScopeCache& Get();
+
+    /**
+     * @brief return the analysis of 'text', the content of 'filename' up to the caret. Only the text that follows the
+     * cached prefix of the file is scanned. 'ignoreTokens' are the tokens the variable scanner should ignore. This
+     * method can be called from any thread
+     */
+    void GetAnalysis(const wxString& filename, const wxString& text, const wxStringTable_t& ignoreTokens,
+                     Analysis& analysis);
+
+    /**
+     * @brief remove the cached analysis of a file
+     */
+    void Remove(const wxString& filename);
+
+    /**
+     * @brief clear the cache
+     */
+    void Clear();
+};
+
+#endif // CXXSCOPECACHE_H
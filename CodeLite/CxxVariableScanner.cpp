@@ -387,13 +387,13 @@ bool CxxVariableScanner::GetNextToken(CxxLexerToken& token)
     return res;
 }
 
-void CxxVariableScanner::OptimizeBuffer(const wxString& buffer, wxString& stripped_buffer)
+int CxxVariableScanner::OptimizeBuffer(const wxString& buffer, wxString& stripped_buffer)
 {
     stripped_buffer.Clear();
     Scanner_t sc = ::LexerNew(buffer);
     if(!sc) {
         clWARNING() << "CxxVariableScanner::OptimizeBuffer(): failed to create Scanner_t" << clEndl;
-        return; // Failed to allocate scanner
+        return wxNOT_FOUND; // Failed to allocate scanner
     }
 
     CppLexerUserData* userData = ::LexerGetUserData(sc);
@@ -404,6 +404,7 @@ void CxxVariableScanner::OptimizeBuffer(const wxString& buffer, wxString& stripp
     m_buffers.clear();
     PushBuffer();
     int parenthesisDepth = 0;
+    bool unmatchedBrace = false;
     while(::LexerNext(sc, tok)) {
         // Skip prep processing state
         if(userData && userData->IsInPreProcessorSection()) { continue; }
@@ -441,12 +442,14 @@ void CxxVariableScanner::OptimizeBuffer(const wxString& buffer, wxString& stripp
             PushBuffer();
             break;
         case '}':
+            if(m_buffers.size() == 1) { unmatchedBrace = true; }
             buffer = PopBuffer();
             // The closing curly bracket is added *after* we switch buffers
             buffer << tok.GetWXString();
             break;
         case ')':
             --parenthesisDepth;
+            if(m_buffers.size() == 1) { unmatchedBrace = true; }
             buffer = PopBuffer();
             buffer << ")";
             // The closing curly bracket is added *after* we switch buffers
@@ -466,6 +469,7 @@ void CxxVariableScanner::OptimizeBuffer(const wxString& buffer, wxString& stripp
     // Merge the buffers
     stripped_buffer.Clear();
     std::for_each(m_buffers.rbegin(), m_buffers.rend(), [&](const wxString& buffer) { stripped_buffer << buffer; });
+    return unmatchedBrace ? wxNOT_FOUND : (int)m_buffers.size() - 1;
 }
 
 CxxVariable::Vec_t CxxVariableScanner::DoGetVariables(const wxString& buffer, bool sort)
@@ -521,9 +525,16 @@ bool CxxVariableScanner::TypeHasIdentifier(const CxxVariable::LexerToken::Vec_t&
     return (iter != type.end());
 }
 
-CxxVariable::Map_t CxxVariableScanner::GetVariablesMap()
+CxxVariable::Map_t CxxVariableScanner::GetVariablesMap(bool isOptimized)
 {
-    CxxVariable::Vec_t l = GetVariables(true);
+    CxxVariable::Vec_t l;
+    if(isOptimized) {
+        l = DoGetVariables(m_buffer, true);
+        std::sort(l.begin(), l.end(),
+                  [&](CxxVariable::Ptr_t a, CxxVariable::Ptr_t b) { return a->GetName() < b->GetName(); });
+    } else {
+        l = GetVariables(true);
+    }
     CxxVariable::Map_t m;
     std::for_each(l.begin(), l.end(), [&](CxxVariable::Ptr_t v) {
         if(m.count(v->GetName()) == 0) { m.insert(std::make_pair(v->GetName(), v)); }
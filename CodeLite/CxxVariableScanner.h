@@ -67,8 +67,11 @@ public:
 
     /**
      * @brief strip buffer from unreachable code blocks (assuming the caret is at the last position of the bufer)
+     * @return the number of blocks and parentheses still open at the end of the buffer, or wxNOT_FOUND if it
+     * closes a block it did not open. The stripped version of a buffer that starts with 'buffer' is 'strippedBuffer'
+     * followed by the stripped version of the remaining text, as long as that text does not close what is still open
      */
-    void OptimizeBuffer(const wxString& buffer, wxString& strippedBuffer);
+    int OptimizeBuffer(const wxString& buffer, wxString& strippedBuffer);
 
     /**
      * @brief parse the buffer and return list of variables
@@ -84,8 +87,9 @@ public:
 
     /**
      * @brief parse the buffer and return a unique set of variables
+     * @param isOptimized set to true if the buffer was already stripped by OptimizeBuffer()
      */
-    CxxVariable::Map_t GetVariablesMap();
+    CxxVariable::Map_t GetVariablesMap(bool isOptimized = false);
 };
 
 #endif // CXXVARIABLESCANNER_H
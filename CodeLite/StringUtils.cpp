@@ -277,3 +277,172 @@ wxArrayString StringUtils::BuildArgv(const wxString& str)
     }
     return arrArgv;
 }
+
+// Skip the quantifier (if any) found at "pos" and return the position following it
+// "optional" is set to true if the quantified atom may match zero times
+static size_t SkipQuantifier(const wxString& pattern, size_t pos, bool& optional, bool& quantified)
+{
+    optional = false;
+    quantified = false;
+    if(pos >= pattern.length()) { return pos; }
+
+    wxChar ch = pattern[pos];
+    if(ch == '?' || ch == '*') {
+        optional = true;
+        quantified = true;
+        ++pos;
+
+    } else if(ch == '+') {
+        quantified = true;
+        ++pos;
+
+    } else if(ch == '{') {
+        size_t closePos = pattern.find('}', pos);
+        if(closePos == wxString::npos) { return pos; }
+        long minCount = 0;
+        wxString range = pattern.Mid(pos + 1, closePos - pos - 1).BeforeFirst(',');
+        if(!range.ToLong(&minCount)) { return pos; }
+        optional = (minCount == 0);
+        quantified = true;
+        pos = closePos + 1;
+
+    } else {
+        return pos;
+    }
+
+    // non-greedy quantifier
+    if(pos < pattern.length() && pattern[pos] == '?') { ++pos; }
+    return pos;
+}
+
+// Return the position following the bracket expression that starts at "pos" (the position of its '[')
+// or wxString::npos if the expression is not terminated
+static size_t SkipBracketExpression(const wxString& pattern, size_t pos)
+{
+    ++pos;
+    if(pos < pattern.length() && pattern[pos] == '^') { ++pos; }
+    // a leading ']' is part of the set: "[]abc]" or "[^]abc]"
+    if(pos < pattern.length() && pattern[pos] == ']') { ++pos; }
+    while(pos < pattern.length() && pattern[pos] != ']') {
+        if(pattern[pos] == '\\') {
+            // advanced regular expressions allow escapes inside bracket expressions: "[^\\]]"
+            pos += 2;
+        } else if(pattern[pos] == '[' && (pos + 1) < pattern.length() &&
+                  (pattern[pos + 1] == ':' || pattern[pos + 1] == '.' || pattern[pos + 1] == '=')) {
+            // [:class:], [.coll.] or [=equiv=]
+            wxString terminator;
+            terminator << pattern[pos + 1] << "]";
+            size_t endPos = pattern.find(terminator, pos + 2);
+            if(endPos == wxString::npos) { return wxString::npos; }
+            pos = endPos + 2;
+        } else {
+            ++pos;
+        }
+    }
+    return (pos < pattern.length()) ? pos + 1 : wxString::npos;
+}
+
+// Return the longest literal that must appear in any string matched by the expression starting at "pos"
+// The parsing stops at the end of the enclosing group
+static wxString DoGetRequiredLiteral(const wxString& pattern, size_t& pos, bool& hasAlternation)
+{
+    wxString best, run;
+    hasAlternation = false;
+    auto flushRun = [&]() {
+        if(run.length() > best.length()) { best = run; }
+        run.clear();
+    };
+
+    bool optional = false;
+    bool quantified = false;
+    while(pos < pattern.length()) {
+        wxChar ch = pattern[pos];
+        if(ch == ')') {
+            ++pos;
+            break;
+
+        } else if(ch == '(') {
+            flushRun();
+            ++pos;
+            bool lookAround = false;
+            if(pattern.Mid(pos, 2) == "?:") {
+                pos += 2;
+            } else if(pos < pattern.length() && pattern[pos] == '?') {
+                // look-ahead groups do not consume any text
+                lookAround = true;
+                pos += 2;
+            }
+            bool groupHasAlternation = false;
+            wxString groupLiteral = DoGetRequiredLiteral(pattern, pos, groupHasAlternation);
+            pos = SkipQuantifier(pattern, pos, optional, quantified);
+            if(!lookAround && !optional && !groupHasAlternation && (groupLiteral.length() > best.length())) {
+                best = groupLiteral;
+            }
+
+        } else if(ch == '[') {
+            flushRun();
+            pos = SkipBracketExpression(pattern, pos);
+            if(pos == wxString::npos) {
+                // we can not tell where the bracket expression ends
+                hasAlternation = true;
+                break;
+            }
+            pos = SkipQuantifier(pattern, pos, optional, quantified);
+
+        } else if(ch == '|') {
+            hasAlternation = true;
+            flushRun();
+            ++pos;
+
+        } else if(ch == '.' || ch == '^' || ch == '$') {
+            flushRun();
+            pos = SkipQuantifier(pattern, pos + 1, optional, quantified);
+
+        } else {
+            wxChar literal = ch;
+            bool isClass = false;
+            if(ch == '\\') {
+                if((pos + 1) >= pattern.length()) {
+                    flushRun();
+                    break;
+                }
+                wxChar escaped = pattern[pos + 1];
+                pos += 2;
+                if(escaped == 't') {
+                    literal = '\t';
+                } else if(escaped == 'n') {
+                    literal = '\n';
+                } else if(wxIsalnum(escaped)) {
+                    // class shorthand (\d, \w ...), back reference or a numeric escape
+                    isClass = true;
+                } else {
+                    literal = escaped;
+                }
+            } else {
+                ++pos;
+            }
+
+            pos = SkipQuantifier(pattern, pos, optional, quantified);
+            if(isClass || optional) {
+                flushRun();
+            } else if(quantified) {
+                run << literal;
+                flushRun();
+            } else {
+                run << literal;
+            }
+        }
+    }
+    flushRun();
+    return hasAlternation ? wxString() : best;
+}
+
+wxString StringUtils::GetRegexRequiredLiteral(const wxString& pattern)
+{
+    size_t pos = 0;
+    bool hasAlternation = false;
+    wxString literal = DoGetRequiredLiteral(pattern, pos, hasAlternation);
+    // a stray ')' stops the parsing before the end of the pattern, in this case we can not tell
+    if(pos != pattern.length()) { return wxEmptyString; }
+    return literal;
+}
@@ -62,6 +62,12 @@ public:
      * @brief free argv created by StringUtils::BuildArgv method
      */
     static void FreeArgv(char** argv, int argc);
+
+    /**
+     * @brief return the longest literal that must appear in any string matched by the regular expression
+     * "pattern" (wxRE_ADVANCED syntax). Return an empty string if no such literal can be determined
+     */
+    static wxString GetRegexRequiredLiteral(const wxString& pattern);
 };
 
 #endif // STRINGUTILS_H
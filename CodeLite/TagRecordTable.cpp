@@ -0,0 +1,198 @@
+#include "TagRecordTable.h"
+#include <string.h>
+
+namespace
+{
+struct KindName {
+    TagRecordTable::eKind kind;
+    const char* name;
+};
+
+const KindName s_kinds[] = {
+    { TagRecordTable::kKindClass, KIND_CLASS },         { TagRecordTable::kKindStruct, KIND_STRUCT },
+    { TagRecordTable::kKindUnion, KIND_UNION },         { TagRecordTable::kKindNamespace, KIND_NAMESPACE },
+    { TagRecordTable::kKindFunction, KIND_FUNCTION },   { TagRecordTable::kKindPrototype, KIND_PROTOTYPE },
+    { TagRecordTable::kKindMember, KIND_MEMBER },       { TagRecordTable::kKindVariable, KIND_VARIABLE },
+    { TagRecordTable::kKindEnum, KIND_ENUM },           { TagRecordTable::kKindClassEnum, KIND_CLASS_ENUM },
+    { TagRecordTable::kKindEnumerator, KIND_ENUMERATOR }, { TagRecordTable::kKindTypedef, KIND_TYPEDEF },
+    { TagRecordTable::kKindMacro, KIND_MACRO },         { TagRecordTable::kKindFile, KIND_FILE },
+};
+
+const char* s_access[] = { "", "", "public", "protected", "private" };
+} // namespace
+
+TagRecordTable::TagRecordTable() { Clear(); }
+
+TagRecordTable::~TagRecordTable() {}
+
+TagRecordTable::eKind TagRecordTable::KindFromString(const wxString& kind)
+{
+    for(size_t i = 0; i < sizeof(s_kinds) / sizeof(s_kinds[0]); ++i) {
+        if(kind == s_kinds[i].name) { return s_kinds[i].kind; }
+    }
+    return kKindOther;
+}
+
+TagRecordTable::eAccess TagRecordTable::AccessFromString(const wxString& access)
+{
+    for(int i = kAccessNone; i < kAccessLast; ++i) {
+        if(access == s_access[i]) { return (eAccess)i; }
+    }
+    return kAccessOther;
+}
+
+void TagRecordTable::Clear()
+{
+    std::vector<Record>().swap(m_records);
+    std::string().swap(m_text);
+    m_shared.clear();
+    m_files.clear();
+    m_fileIds.clear();
+    m_otherKinds.clear();
+    m_ids.clear();
+
+    // offset 0 is the empty string
+    m_text.push_back('\0');
+}
+
+uint32_t TagRecordTable::DoAddText(const wxString& str)
+{
+    if(str.IsEmpty()) { return 0; }
+    const wxCharBuffer utf8 = str.ToUTF8();
+    uint32_t offset = (uint32_t)m_text.length();
+    m_text.append(utf8.data(), strlen(utf8.data()) + 1);
+    return offset;
+}
+
+uint32_t TagRecordTable::DoAddSharedText(const wxString& str)
+{
+    if(str.IsEmpty()) { return 0; }
+    std::string utf8(str.ToUTF8().data());
+    std::unordered_map<std::string, uint32_t>::const_iterator iter = m_shared.find(utf8);
+    if(iter != m_shared.end()) { return iter->second; }
+
+    uint32_t offset = (uint32_t)m_text.length();
+    m_text.append(utf8.c_str(), utf8.length() + 1);
+    m_shared.insert(std::make_pair(utf8, offset));
+    return offset;
+}
+
+wxString TagRecordTable::DoGetText(uint32_t offset) const { return wxString::FromUTF8(m_text.c_str() + offset); }
+
+uint16_t TagRecordTable::DoGetOtherKindIndex(const wxString& str)
+{
+    for(size_t i = 0; i < m_otherKinds.size(); ++i) {
+        if(m_otherKinds[i] == str) { return (uint16_t)i; }
+    }
+    m_otherKinds.push_back(str);
+    return (uint16_t)(m_otherKinds.size() - 1);
+}
+
+size_t TagRecordTable::Add(const Columns& columns)
+{
+    if(columns.id != wxNOT_FOUND) {
+        int index = Find(columns.id);
+        if(index != wxNOT_FOUND) { return index; }
+    }
+
+    Record record;
+    record.m_id = columns.id;
+    record.m_line = columns.line;
+
+    uint32_t fileOffset = DoAddSharedText(columns.file);
+    std::unordered_map<uint32_t, uint32_t>::const_iterator iter = m_fileIds.find(fileOffset);
+    if(iter == m_fileIds.end()) {
+        m_files.push_back(fileOffset);
+        iter = m_fileIds.insert(std::make_pair(fileOffset, (uint32_t)m_files.size() - 1)).first;
+    }
+    record.m_fileId = iter->second;
+
+    eKind kind = KindFromString(columns.kind);
+    record.m_kind = (kind == kKindOther) ? (kKindLast + DoGetOtherKindIndex(columns.kind)) : kind;
+    eAccess access = AccessFromString(columns.access);
+    record.m_access = (access == kAccessOther) ? (kAccessLast + DoGetOtherKindIndex(columns.access)) : access;
+
+    record.m_name = DoAddText(columns.name);
+    record.m_signature = DoAddText(columns.signature);
+    record.m_pattern = DoAddText(columns.pattern);
+    record.m_parent = DoAddSharedText(columns.parent);
+    record.m_inherits = DoAddSharedText(columns.inherits);
+    record.m_path = DoAddText(columns.path);
+    record.m_typeref = DoAddSharedText(columns.typeref);
+    record.m_scope = DoAddSharedText(columns.scope);
+    record.m_returns = DoAddSharedText(columns.returns);
+
+    m_records.push_back(record);
+    if(columns.id != wxNOT_FOUND) { m_ids.insert(std::make_pair(columns.id, (uint32_t)m_records.size() - 1)); }
+    return m_records.size() - 1;
+}
+
+int TagRecordTable::Find(int id) const
+{
+    std::unordered_map<int, uint32_t>::const_iterator iter = m_ids.find(id);
+    return (iter == m_ids.end()) ? wxNOT_FOUND : (int)iter->second;
+}
+
+TagRecordTable::eKind TagRecordTable::GetKind(size_t index) const
+{
+    uint16_t kind = m_records[index].m_kind;
+    return (kind >= kKindLast) ? kKindOther : (eKind)kind;
+}
+
+TagRecordTable::eAccess TagRecordTable::GetAccess(size_t index) const
+{
+    uint16_t access = m_records[index].m_access;
+    return (access >= kAccessLast) ? kAccessOther : (eAccess)access;
+}
+
+TagEntryPtr TagRecordTable::Get(size_t index) const
+{
+    const Record& record = m_records[index];
+
+    wxString kind;
+    if(record.m_kind >= kKindLast) {
+        kind = m_otherKinds[record.m_kind - kKindLast];
+    } else {
+        for(size_t i = 0; i < sizeof(s_kinds) / sizeof(s_kinds[0]); ++i) {
+            if(s_kinds[i].kind == record.m_kind) {
+                kind = s_kinds[i].name;
+                break;
+            }
+        }
+    }
+    wxString access = (record.m_access >= kAccessLast) ? m_otherKinds[record.m_access - kAccessLast]
+                                                       : wxString(s_access[record.m_access]);
+
+    // Same order as TagsStorageSQLite::FromSQLite3ResultSet()
+    TagEntryPtr entry(new TagEntry());
+    entry->SetId(record.m_id);
+    entry->SetName(DoGetText(record.m_name));
+    entry->SetFile(GetFile(record.m_fileId));
+    entry->SetLine(record.m_line);
+    entry->SetKind(kind);
+    entry->SetAccess(access);
+    entry->SetSignature(DoGetText(record.m_signature));
+    entry->SetPattern(DoGetText(record.m_pattern));
+    entry->SetParent(DoGetText(record.m_parent));
+    entry->SetInherits(DoGetText(record.m_inherits));
+    entry->SetPath(DoGetText(record.m_path));
+    entry->SetTyperef(DoGetText(record.m_typeref));
+    entry->SetScope(DoGetText(record.m_scope));
+    entry->SetReturnValue(DoGetText(record.m_returns));
+    return entry;
+}
+
+size_t TagRecordTable::GetMemoryUsage() const
+{
+    // The hash tables are estimated: one node (key, value and next pointer) per element plus the buckets
+    size_t usage = m_records.capacity() * sizeof(Record) + m_text.capacity() + m_files.capacity() * sizeof(uint32_t);
+    for(std::unordered_map<std::string, uint32_t>::const_iterator iter = m_shared.begin(); iter != m_shared.end();
+        ++iter) {
+        usage += sizeof(std::pair<const std::string, uint32_t>) + sizeof(void*);
+        if(iter->first.capacity() >= sizeof(std::string)) { usage += iter->first.capacity() + 1; }
+    }
+    usage += m_shared.bucket_count() * sizeof(void*);
+    usage += (m_fileIds.size() + m_ids.size()) * (sizeof(std::pair<const int, uint32_t>) + sizeof(void*));
+    usage += (m_fileIds.bucket_count() + m_ids.bucket_count()) * sizeof(void*);
+    return usage;
+}
@@ -0,0 +1,149 @@
+#ifndef TAGRECORDTABLE_H
+#define TAGRECORDTABLE_H
+
+#include "codelite_exports.h"
+#include "entry.h"
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <wx/string.h>
+
+/**
+ * @class TagRecordTable
+ * @brief a compact store for the tags read from the tags database.
+ * Every tag is kept as a fixed size record: its kind and access are enums, its file is an index into the file table
+ * and its other strings are offsets into a single UTF-8 text arena. The strings that repeat from one tag to another
+ * (file, scope, parent, inherits, typeref and return value) are stored once. A TagEntry is only created when a tag is
+ * requested with Get().
+ * The table is owned by its user (the tags storage keeps one for its cache) and is not thread safe
+ */
+class WXDLLIMPEXP_CL TagRecordTable
+{
+public:
+    enum eKind {
+        kKindOther = 0, // the kind is not one of the below, it is kept in m_otherKinds
+        kKindClass,
+        kKindStruct,
+        kKindUnion,
+        kKindNamespace,
+        kKindFunction,
+        kKindPrototype,
+        kKindMember,
+        kKindVariable,
+        kKindEnum,
+        kKindClassEnum,
+        kKindEnumerator,
+        kKindTypedef,
+        kKindMacro,
+        kKindFile,
+        kKindLast,
+    };
+
+    enum eAccess {
+        kAccessOther = 0, // the access is not one of the below, it is kept in m_otherKinds
+        kAccessNone,
+        kAccessPublic,
+        kAccessProtected,
+        kAccessPrivate,
+        kAccessLast,
+    };
+
+    /**
+     * @brief the columns of a row of the 'tags' table, see TagsStorageSQLite::FromSQLite3ResultSet()
+     */
+    struct Columns {
+        int id;
+        wxString name;
+        wxString file;
+        int line;
+        wxString kind;
+        wxString access;
+        wxString signature;
+        wxString pattern;
+        wxString parent;
+        wxString inherits;
+        wxString path;
+        wxString typeref;
+        wxString scope;
+        wxString returns;
+
+        Columns()
+            : id(wxNOT_FOUND)
+            , line(wxNOT_FOUND)
+        {
+        }
+    };
+
+protected:
+    struct Record {
+        int m_id;
+        int m_line;
+        uint32_t m_fileId;
+        uint16_t m_kind;   // eKind, or kKindLast + index in m_otherKinds
+        uint16_t m_access; // eAccess, or kAccessLast + index in m_otherKinds
+        // offsets in m_text
+        uint32_t m_name;
+        uint32_t m_signature;
+        uint32_t m_pattern;
+        uint32_t m_parent;
+        uint32_t m_inherits;
+        uint32_t m_path;
+        uint32_t m_typeref;
+        uint32_t m_scope;
+        uint32_t m_returns;
+    };
+
+    std::vector<Record> m_records;
+    std::string m_text;                                  // NUL terminated UTF-8 strings
+    std::unordered_map<std::string, uint32_t> m_shared; // the strings of m_text that are stored once
+    std::vector<uint32_t> m_files;                       // file ID -> offset in m_text
+    std::unordered_map<uint32_t, uint32_t> m_fileIds;    // offset in m_text -> file ID
+    std::vector<wxString> m_otherKinds;
+    std::unordered_map<int, uint32_t> m_ids; // database ID -> record index
+
+protected:
+    uint32_t DoAddText(const wxString& str);
+    uint32_t DoAddSharedText(const wxString& str);
+    wxString DoGetText(uint32_t offset) const;
+    uint16_t DoGetOtherKindIndex(const wxString& str);
+
+public:
+    TagRecordTable();
+    virtual ~TagRecordTable();
+
+    /**
+     * @brief add a tag and return its index. A tag with the ID of a tag already in the table is not added again,
+     * the index of the existing tag is returned
+     */
+    size_t Add(const Columns& columns);
+
+    /**
+     * @brief return the index of the tag with the given database ID, or wxNOT_FOUND
+     */
+    int Find(int id) const;
+
+    /**
+     * @brief create a TagEntry for the tag at 'index'. The tag is identical to the one
+     * TagsStorageSQLite::FromSQLite3ResultSet() creates from the same row
+     */
+    TagEntryPtr Get(size_t index) const;
+
+    eKind GetKind(size_t index) const;
+    eAccess GetAccess(size_t index) const;
+    uint32_t GetFileId(size_t index) const { return m_records[index].m_fileId; }
+    wxString GetFile(uint32_t fileId) const { return DoGetText(m_files[fileId]); }
+
+    /**
+     * @brief return the number of bytes allocated by the table
+     */
+    size_t GetMemoryUsage() const;
+
+    size_t GetCount() const { return m_records.size(); }
+    void Clear();
+
+    static eKind KindFromString(const wxString& kind);
+    static eAccess AccessFromString(const wxString& access);
+};
+
+#endif // TAGRECORDTABLE_H
@@ -0,0 +1,192 @@
+#include "clPerfTrace.h"
+#include "file_logger.h"
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <wx/ffile.h>
+#include <wx/utils.h>
+
+// Upper limit for the number of events kept per thread
+#define PERF_TRACE_MAX_EVENTS_PER_THREAD 500000
+
+// The reference point for all the timestamps
+static const std::chrono::steady_clock::time_point s_traceEpoch = std::chrono::steady_clock::now();
+
+// The calling thread buffer, registered when the thread records its first event
+static thread_local clPerfTrace::ThreadBufferPtr_t s_threadBuffer;
+
+// The calling thread name, kept here until the thread has a buffer
+static thread_local wxString s_threadName;
+
+static wxString EscapeJSON(const wxString& str)
+{
+    wxString escaped;
+    escaped.reserve(str.length());
+    for(wxString::const_iterator iter = str.begin(); iter != str.end(); ++iter) {
+        wxChar ch = *iter;
+        switch(ch) {
+        case '"':
+            escaped << "\\\"";
+            break;
+        case '\\':
+            escaped << "\\\\";
+            break;
+        case '\n':
+            escaped << "\\n";
+            break;
+        case '\r':
+        case '\t':
+            escaped << " ";
+            break;
+        default:
+            escaped << ch;
+            break;
+        }
+    }
+    return escaped;
+}
+
+clPerfTrace::clPerfTrace()
+    : m_enabled(false)
+{
+}
+
+clPerfTrace::~clPerfTrace() {}
+
+clPerfTrace& clPerfTrace::Get()
+{
+    static clPerfTrace theTrace;
+    return theTrace;
+}
+
+void clPerfTrace::Enable(bool b) { m_enabled.store(b); }
+
+long long clPerfTrace::Now()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - s_traceEpoch)
+        .count();
+}
+
+clPerfTrace::ThreadBuffer& clPerfTrace::GetThreadBuffer()
+{
+    if(!s_threadBuffer) {
+        // First event recorded by this thread, register its buffer
+        s_threadBuffer.reset(new ThreadBuffer());
+        s_threadBuffer->m_tid = std::hash<std::thread::id>()(std::this_thread::get_id());
+        s_threadBuffer->m_threadName = s_threadName;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_buffers.push_back(s_threadBuffer);
+    }
+    return *s_threadBuffer;
+}
+
+void clPerfTrace::DoAddEvent(Event& event)
+{
+    ThreadBuffer& buffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.m_mutex);
+    if(buffer.m_events.size() >= PERF_TRACE_MAX_EVENTS_PER_THREAD) {
+        ++buffer.m_dropped;
+        return;
+    }
+    buffer.m_events.push_back(std::move(event));
+}
+
+void clPerfTrace::AddSpan(const char* category, const wxString& name, long long start, long long duration)
+{
+    Event event;
+    event.m_category = category;
+    event.m_name = name;
+    event.m_start = start;
+    event.m_duration = duration;
+    DoAddEvent(event);
+}
+
+void clPerfTrace::AddCounter(const char* category, const wxString& name, double value)
+{
+    Event event;
+    event.m_category = category;
+    event.m_name = name;
+    event.m_phase = 'C';
+    event.m_start = Now();
+    event.m_value = value;
+    DoAddEvent(event);
+}
+
+void clPerfTrace::SetThreadName(const wxString& name)
+{
+    // Don't register a buffer for threads that never record anything (e.g. when recording is disabled)
+    s_threadName = name;
+    if(!s_threadBuffer) { return; }
+    std::lock_guard<std::mutex> lock(s_threadBuffer->m_mutex);
+    s_threadBuffer->m_threadName = name;
+}
+
+void clPerfTrace::Clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<ThreadBufferPtr_t> buffers;
+    for(const ThreadBufferPtr_t& buffer : m_buffers) {
+        // We hold the last reference to the buffer of a thread that has exited: release it
+        if(buffer.use_count() == 1) { continue; }
+        std::lock_guard<std::mutex> bufferLock(buffer->m_mutex);
+        buffer->m_events.clear();
+        buffer->m_dropped = 0;
+        buffers.push_back(buffer);
+    }
+    m_buffers.swap(buffers);
+}
+
+bool clPerfTrace::Save(const wxFileName& filename) const
+{
+    std::vector<ThreadBufferPtr_t> buffers;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        buffers = m_buffers;
+    }
+
+    wxString content;
+    content << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    long pid = ::wxGetProcessId();
+    size_t count = 0;
+    for(ThreadBufferPtr_t buffer : buffers) {
+        std::lock_guard<std::mutex> lock(buffer->m_mutex);
+        if(!buffer->m_threadName.IsEmpty()) {
+            if(count++) { content << ",\n"; }
+            content << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid
+                    << ",\"tid\":" << (wxULongLong_t)buffer->m_tid << ",\"args\":{\"name\":\""
+                    << EscapeJSON(buffer->m_threadName) << "\"}}";
+        }
+        if(buffer->m_dropped) {
+            clWARNING() << "Trace buffer is full," << buffer->m_dropped << "events were dropped";
+        }
+
+        for(const Event& event : buffer->m_events) {
+            if(count++) { content << ",\n"; }
+            content << "{\"name\":\"" << EscapeJSON(event.m_name) << "\",\"cat\":\"" << event.m_category
+                    << "\",\"ph\":\"" << event.m_phase << "\",\"ts\":" << (wxLongLong_t)event.m_start
+                    << ",\"pid\":" << pid << ",\"tid\":" << (wxULongLong_t)buffer->m_tid;
+            if(event.m_phase == 'C') {
+                content << ",\"args\":{\"value\":" << wxString::FromCDouble(event.m_value) << "}}";
+            } else {
+                content << ",\"dur\":" << (wxLongLong_t)event.m_duration << "}";
+            }
+        }
+    }
+    content << "\n]}\n";
+
+    wxFFile fp(filename.GetFullPath(), "w+b");
+    if(!fp.IsOpened()) {
+        clWARNING() << "Failed to save trace file:" << filename.GetFullPath();
+        return false;
+    }
+    bool res = fp.Write(content, wxConvUTF8);
+    fp.Close();
+    clSYSTEM() << "Trace saved to:" << filename.GetFullPath() << "(" << count << "events)";
+    return res;
+}
+
+clPerfTraceScope::~clPerfTraceScope()
+{
+    if(m_start < 0) { return; }
+    clPerfTrace::Get().AddSpan(m_category, m_name, m_start, clPerfTrace::Now() - m_start);
+}
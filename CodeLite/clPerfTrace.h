@@ -0,0 +1,137 @@
+#ifndef CLPERFTRACE_H
+#define CLPERFTRACE_H
+
+#include "codelite_exports.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <wx/filename.h>
+#include <wx/string.h>
+
+/**
+ * @brief records timed spans, counters and thread names and saves them in the Chrome trace JSON
+ * format (open the file with chrome://tracing or https://ui.perfetto.dev)
+ * Each thread records into its own buffer, so recording threads never wait for each other.
+ * Recording is disabled by default, when disabled a trace point costs a single atomic load
+ */
+class WXDLLIMPEXP_CL clPerfTrace
+{
+public:
+    struct Event {
+        const char* m_category = ""; ///< must be a string literal
+        wxString m_name;
+        char m_phase = 'X';       ///< 'X' for span, 'C' for counter
+        long long m_start = 0;    ///< microseconds since the process started
+        long long m_duration = 0; ///< microseconds, spans only
+        double m_value = 0.0;     ///< counters only
+    };
+
+    struct ThreadBuffer {
+        std::mutex m_mutex; ///< only contended while the trace is being saved
+        std::vector<Event> m_events;
+        wxString m_threadName;
+        size_t m_tid = 0;
+        size_t m_dropped = 0;
+    };
+    typedef std::shared_ptr<ThreadBuffer> ThreadBufferPtr_t;
+
+protected:
+    std::atomic<bool> m_enabled;
+    std::vector<ThreadBufferPtr_t> m_buffers; ///< buffers outlive their threads
+    mutable std::mutex m_mutex;
+
+protected:
+    ThreadBuffer& GetThreadBuffer();
+    void DoAddEvent(Event& event);
+
+private:
+    clPerfTrace();
+    ~clPerfTrace();
+
+public:
+    static clPerfTrace& Get();
+
+    /**
+     * @brief start or stop recording
+     */
+    void Enable(bool b);
+    bool IsEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief return the time in microseconds since the process started
+     */
+    static long long Now();
+
+    /**
+     * @brief record a completed span
+     */
+    void AddSpan(const char* category, const wxString& name, long long start, long long duration);
+
+    /**
+     * @brief record the value of a counter
+     */
+    void AddCounter(const char* category, const wxString& name, double value);
+
+    /**
+     * @brief name the calling thread in the trace. This does not register the thread: a thread that never records
+     * an event costs nothing
+     */
+    void SetThreadName(const wxString& name);
+
+    /**
+     * @brief discard all the recorded events and the buffers of the threads that have exited
+     */
+    void Clear();
+
+    /**
+     * @brief save the recorded events in the Chrome trace JSON format
+     */
+    bool Save(const wxFileName& filename) const;
+};
+
+/**
+ * @brief record the lifetime of this object as a span
+ */
+class WXDLLIMPEXP_CL clPerfTraceScope
+{
+    const char* m_category;
+    wxString m_name;
+    long long m_start;
+
+public:
+    /**
+     * @brief 'getName' returns the span name. It is only called when recording is enabled, so building the name
+     * costs nothing otherwise
+     */
+    template <typename NameFunc>
+    clPerfTraceScope(const char* category, const NameFunc& getName)
+        : m_category(category)
+        , m_start(-1)
+    {
+        if(clPerfTrace::Get().IsEnabled()) {
+            m_name = getName();
+            m_start = clPerfTrace::Now();
+        }
+    }
+    ~clPerfTraceScope();
+};
+
+#define CL_TRACE_CONCAT_INNER(a, b) a##b
+#define CL_TRACE_CONCAT(a, b) CL_TRACE_CONCAT_INNER(a, b)
+
+/// Record the enclosing scope, e.g. CL_TRACE_SCOPE("startup", "Load plugins");
+/// The name is not evaluated when recording is disabled
+#define CL_TRACE_SCOPE(category, name) \
+    clPerfTraceScope CL_TRACE_CONCAT(__clTraceScope, __LINE__)(category, [&]() -> wxString { return name; })
+
+/// Record a counter value. The value is not evaluated when recording is disabled
+#define CL_TRACE_COUNTER(category, name, value)                                                              \
+    do {                                                                                                       \
+        if(clPerfTrace::Get().IsEnabled()) { clPerfTrace::Get().AddCounter(category, name, value); }         \
+    } while(0)
+
+/// Name the current thread in the trace
+#define CL_TRACE_THREAD_NAME(name) clPerfTrace::Get().SetThreadName(name)
+
+#endif // CLPERFTRACE_H
@@ -31,6 +31,8 @@
 #include <wx/filefn.h>
 #include <libssh/sftp.h>
 #include "cl_standard_paths.h"
+#include <deque>
+#include "fileutils.h"
 
 class SFTPDirCloser
 {
@@ -118,16 +120,23 @@ void clSFTP::Write(const wxFileName& localFile, const wxString& remotePath, SFTP
                                      << ::strerror(errno));
     }
 
-    char buffer[4096];
-    wxMemoryBuffer memBuffer;
-    size_t nbytes(0);
+    if(!m_sftp) { throw clException("SFTP is not initialized"); }
+
+    // Stream the local file to the server, chunk by chunk, instead of loading it into memory first
+    wxString tmpRemoteFile = remotePath;
+    tmpRemoteFile << ".codelitesftp";
+    sftp_file file = DoOpenRemoteFileForWrite(tmpRemoteFile);
+
+    char buffer[SFTP_CHUNK_SIZE];
     while(!fp.Eof()) {
-        nbytes = fp.Read(buffer, sizeof(buffer));
+        size_t nbytes = fp.Read(buffer, sizeof(buffer));
         if(nbytes == 0) break;
-        memBuffer.AppendData(buffer, nbytes);
+        DoWriteChunk(file, buffer, nbytes, tmpRemoteFile);
     }
     fp.Close();
-    Write(memBuffer, remotePath);
+    sftp_close(file);
+
+    DoReplaceRemoteFile(tmpRemoteFile, remotePath);
     if(attributes && attributes->GetPermissions()) { Chmod(remotePath, attributes->GetPermissions()); }
 }
 
@@ -135,36 +144,53 @@ void clSFTP::Write(const wxMemoryBuffer& fileContent, const wxString& remotePath
 {
     if(!m_sftp) { throw clException("SFTP is not initialized"); }
 
-    int access_type = O_WRONLY | O_CREAT | O_TRUNC;
-    sftp_file file;
     wxString tmpRemoteFile = remotePath;
     tmpRemoteFile << ".codelitesftp";
+    sftp_file file = DoOpenRemoteFileForWrite(tmpRemoteFile);
+
+    const char* p = (const char*)fileContent.GetData();
+    size_t bytesLeft = fileContent.GetDataLen();
+    while(bytesLeft > 0) {
+        size_t chunkSize = bytesLeft > SFTP_CHUNK_SIZE ? SFTP_CHUNK_SIZE : bytesLeft;
+        DoWriteChunk(file, p, chunkSize, tmpRemoteFile);
+        bytesLeft -= chunkSize;
+        p += chunkSize;
+    }
+    sftp_close(file);
+
+    DoReplaceRemoteFile(tmpRemoteFile, remotePath);
+    if(attributes && attributes->GetPermissions()) { Chmod(remotePath, attributes->GetPermissions()); }
+}
 
-    file = sftp_open(m_sftp, tmpRemoteFile.mb_str(wxConvUTF8).data(), access_type, 0644);
+SFTPFile_t clSFTP::DoOpenRemoteFileForWrite(const wxString& remotePath)
+{
+    int access_type = O_WRONLY | O_CREAT | O_TRUNC;
+    sftp_file file = sftp_open(m_sftp, remotePath.mb_str(wxConvUTF8).data(), access_type, 0644);
     if(file == NULL) {
-        throw clException(wxString() << _("Can't open file: ") << tmpRemoteFile << ". "
+        throw clException(wxString() << _("Can't open file: ") << remotePath << ". "
                                      << ssh_get_error(m_ssh->GetSession()),
                           sftp_get_error(m_sftp));
     }
+    return file;
+}
 
-    char* p = (char*)fileContent.GetData();
-    const int maxChunkSize = 65536;
-    wxInt64 bytesLeft = fileContent.GetDataLen();
-
-    while(bytesLeft > 0) {
-        wxInt64 chunkSize = bytesLeft > maxChunkSize ? maxChunkSize : bytesLeft;
-        wxInt64 bytesWritten = sftp_write(file, p, chunkSize);
+void clSFTP::DoWriteChunk(SFTPFile_t file, const char* data, size_t len, const wxString& remotePath)
+{
+    while(len > 0) {
+        ssize_t bytesWritten = sftp_write(file, data, len);
         if(bytesWritten < 0) {
             sftp_close(file);
-            throw clException(wxString() << _("Can't write data to file: ") << tmpRemoteFile << ". "
+            throw clException(wxString() << _("Can't write data to file: ") << remotePath << ". "
                                          << ssh_get_error(m_ssh->GetSession()),
                               sftp_get_error(m_sftp));
         }
-        bytesLeft -= bytesWritten;
-        p += bytesWritten;
+        len -= bytesWritten;
+        data += bytesWritten;
     }
-    sftp_close(file);
+}
 
+void clSFTP::DoReplaceRemoteFile(const wxString& tmpRemoteFile, const wxString& remotePath)
+{
     // Unlink the original file if it exists
     bool needUnlink = false;
     {
@@ -188,8 +214,6 @@ void clSFTP::Write(const wxMemoryBuffer& fileContent, const wxString& remotePath
                                      << ssh_get_error(m_ssh->GetSession()),
                           sftp_get_error(m_sftp));
     }
-
-    if(attributes && attributes->GetPermissions()) { Chmod(remotePath, attributes->GetPermissions()); }
 }
 
 SFTPAttribute::List_t clSFTP::List(const wxString& folder, size_t flags, const wxString& filter)
@@ -250,6 +274,58 @@ SFTPAttribute::List_t clSFTP::CdUp(size_t flags, const wxString& filter)
 }
 
 SFTPAttribute::Ptr_t clSFTP::Read(const wxString& remotePath, wxMemoryBuffer& buffer)
+{
+    return DoRead(remotePath, &buffer, NULL);
+}
+
+SFTPAttribute::Ptr_t clSFTP::Read(const wxString& remotePath, const wxFileName& localFile)
+{
+    // Download into a temporary file next to the target and replace the target only once the entire file was
+    // read. This way, a failed transfer does not truncate the existing local copy. If the target is a symlink,
+    // we replace the file it points to
+    wxString target = FileUtils::RealPath(localFile.GetFullPath());
+    wxString tmpPath = target + ".part";
+    wxFFile fp(tmpPath, "w+b");
+    if(!fp.IsOpened()) {
+        throw clException(wxString() << _("Could not open local file: ") << tmpPath << ". " << ::strerror(errno));
+    }
+
+    SFTPAttribute::Ptr_t attr;
+    try {
+        attr = DoRead(remotePath, NULL, &fp);
+    } catch(...) {
+        fp.Close();
+        ::wxRemoveFile(tmpPath);
+        throw;
+    }
+
+    if(!fp.Flush() || !fp.Close()) {
+        ::wxRemoveFile(tmpPath);
+        throw clException(wxString() << _("Could not write local file: ") << tmpPath << ". " << ::strerror(errno));
+    }
+
+    if(!::wxRenameFile(tmpPath, target, true)) {
+        ::wxRemoveFile(tmpPath);
+        throw clException(wxString() << _("Could not replace local file: ") << target << ". "
+                                     << ::strerror(errno));
+    }
+    return attr;
+}
+
+void clSFTP::DoDiscardPendingReads(SFTPFile_t file, std::deque<int>& pendingReads)
+{
+    // Every request sent must have its reply consumed, otherwise it stays queued on the session. Once one of
+    // them fails the channel is gone and the remaining replies will never arrive: stop waiting for them
+    char pBuffer[SFTP_CHUNK_SIZE];
+    while(!pendingReads.empty()) {
+        int rc = sftp_async_read(file, pBuffer, SFTP_CHUNK_SIZE, pendingReads.front());
+        pendingReads.pop_front();
+        if((rc == SSH_ERROR) && (ssh_is_connected(m_ssh->GetSession()) == 0)) { break; }
+    }
+    pendingReads.clear();
+}
+
+SFTPAttribute::Ptr_t clSFTP::DoRead(const wxString& remotePath, wxMemoryBuffer* buffer, wxFFile* fp)
 {
     if(!m_sftp) { throw clException("SFTP is not initialized"); }
 
@@ -262,29 +338,68 @@ SFTPAttribute::Ptr_t clSFTP::Read(const wxString& remotePath, wxMemoryBuffer& bu
 
     SFTPAttribute::Ptr_t fileAttr = Stat(remotePath);
     if(!fileAttr) {
+        sftp_close(file);
         throw clException(wxString() << _("Could not stat file:") << remotePath << ". "
                                      << ssh_get_error(m_ssh->GetSession()),
                           sftp_get_error(m_sftp));
     }
     wxInt64 fileSize = fileAttr->GetSize();
-    if(fileSize == 0) return fileAttr;
+    if(fileSize == 0) {
+        sftp_close(file);
+        return fileAttr;
+    }
 
     // Allocate buffer for the file content
-    char pBuffer[65536]; // buffer
+    char pBuffer[SFTP_CHUNK_SIZE]; // buffer
 
-    // Read the entire file content
-    wxInt64 bytesLeft = fileSize;
+    // Read the entire file content. To avoid waiting a full round trip for every chunk, we keep up to
+    // SFTP_MAX_PENDING_READS read requests in flight and consume the replies in the order they were sent
+    std::deque<int> pendingReads;
+    wxInt64 bytesRequested = 0;
     wxInt64 bytesRead = 0;
-    while(bytesLeft > 0) {
-        wxInt64 nbytes = sftp_read(file, pBuffer, sizeof(pBuffer));
+    bool failed = false;
+    while(!failed && bytesRead < fileSize) {
+        while(bytesRequested < fileSize && pendingReads.size() < SFTP_MAX_PENDING_READS) {
+            int id = sftp_async_read_begin(file, SFTP_CHUNK_SIZE);
+            if(id < 0) {
+                failed = true;
+                break;
+            }
+            pendingReads.push_back(id);
+            bytesRequested += SFTP_CHUNK_SIZE;
+        }
+        if(pendingReads.empty()) { break; }
+
+        int nbytes = sftp_async_read(file, pBuffer, SFTP_CHUNK_SIZE, pendingReads.front());
+        pendingReads.pop_front();
+        if(nbytes <= 0) {
+            // error or unexpected EOF
+            failed = (nbytes < 0);
+            break;
+        }
+
+        if(buffer) {
+            buffer->AppendData(pBuffer, nbytes);
+        } else if(fp->Write(pBuffer, nbytes) != (size_t)nbytes) {
+            failed = true;
+        }
         bytesRead += nbytes;
-        bytesLeft -= nbytes;
-        buffer.AppendData(pBuffer, nbytes);
+
+        if(nbytes < SFTP_CHUNK_SIZE && bytesRead < fileSize) {
+            // A short read: the requests in flight were sent for the wrong offsets. Drop their replies and
+            // continue from where we are
+            DoDiscardPendingReads(file, pendingReads);
+            sftp_seek64(file, bytesRead);
+            bytesRequested = bytesRead;
+        }
     }
 
-    if(bytesRead != fileSize) {
+    // Consume the replies of requests that are still in flight (after an error as well)
+    DoDiscardPendingReads(file, pendingReads);
+
+    if(failed || bytesRead != fileSize) {
         sftp_close(file);
-        buffer.Clear();
+        if(buffer) { buffer->Clear(); }
         throw clException(wxString() << _("Could not read file:") << remotePath << ". "
                                      << ssh_get_error(m_ssh->GetSession()),
                           sftp_get_error(m_sftp));
@@ -34,10 +34,20 @@
 #include "codelite_exports.h"
 #include "cl_sftp_attribute.h"
 #include <wx/buffer.h>
+#include <deque>
+
+class wxFFile;
+
+// Size of a single read/write request sent to the server
+#define SFTP_CHUNK_SIZE 32768
+// Maximum number of read requests in flight
+#define SFTP_MAX_PENDING_READS 16
 
 // We do it this way to avoid exposing the include to <libssh/sftp.h> to files including this header
 struct sftp_session_struct;
 typedef struct sftp_session_struct* SFTPSession_t;
+struct sftp_file_struct;
+typedef struct sftp_file_struct* SFTPFile_t;
 
 class WXDLLIMPEXP_CL clSFTP
 {
@@ -47,6 +57,16 @@ class WXDLLIMPEXP_CL clSFTP
     wxString m_currentFolder;
     wxString m_account;
 
+protected:
+    SFTPFile_t DoOpenRemoteFileForWrite(const wxString& remotePath);
+    void DoWriteChunk(SFTPFile_t file, const char* data, size_t len, const wxString& remotePath);
+    void DoReplaceRemoteFile(const wxString& tmpRemoteFile, const wxString& remotePath);
+    SFTPAttribute::Ptr_t DoRead(const wxString& remotePath, wxMemoryBuffer* buffer, wxFFile* fp);
+    /**
+     * @brief consume the replies of the read requests in 'pendingReads' so they do not stay queued on the session
+     */
+    void DoDiscardPendingReads(SFTPFile_t file, std::deque<int>& pendingReads);
+
 public:
     typedef wxSharedPtr<clSFTP> Ptr_t;
     enum {
@@ -104,6 +124,12 @@ public:
      */
     SFTPAttribute::Ptr_t Read(const wxString& remotePath, wxMemoryBuffer& buffer) ;
 
+    /**
+     * @brief download a remote file directly into a local file, without keeping its content in memory
+     * @return the remote file attributes
+     */
+    SFTPAttribute::Ptr_t Read(const wxString& remotePath, const wxFileName& localFile) ;
+
     /**
      * @brief list the content of a folder
      * @param folder
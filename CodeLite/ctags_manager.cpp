@@ -22,6 +22,7 @@
 //
 //////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////
+#include "CxxScopeCache.h"
 #include "CxxTemplateFunction.h"
 #include "CxxVariable.h"
 #include "CxxVariableScanner.h"
@@ -412,17 +413,28 @@ TagTreePtr TagsManager::TreeFromTags(const wxString& tags, int& count)
 
     TagTreePtr tree(new TagTree(wxT("<ROOT>"), root));
 
-    wxStringTokenizer tkz(tags, wxT("\n"));
-    while(tkz.HasMoreTokens()) {
-        TagEntry tag;
-        wxString line = tkz.NextToken();
-
-        line = line.Trim();
-        line = line.Trim(false);
-        if(line.IsEmpty()) continue;
+    // Locate the line boundaries in place (trimming the whitespace around each line)
+    // so only the line content itself is copied
+    const size_t len = tags.length();
+    size_t start = 0;
+    while(start < len) {
+        size_t eol = tags.find(wxT('\n'), start);
+        if(eol == wxString::npos) { eol = len; }
+
+        size_t first = start;
+        size_t last = eol;
+        start = eol + 1;
+        while(first < last && wxIsspace(tags[first])) {
+            ++first;
+        }
+        while(last > first && wxIsspace(tags[last - 1])) {
+            --last;
+        }
+        if(first == last) continue;
 
         // Construct the tag from the line
-        tag.FromLine(line);
+        TagEntry tag;
+        tag.FromLine(tags.Mid(first, last - first));
 
         // Add the tag to the tree, locals are not added to the
         // tree
@@ -546,11 +558,12 @@ bool TagsManager::WordCompletionCandidates(const wxFileName& fileName, int linen
     if(tmpExp.IsEmpty()) {
         // Collect all the tags from the current scope, and
         // from the global scope
-        wxString curFunctionBody;
         wxString textAfterTokenReplacements;
-        int lastFuncLine = funcTag ? funcTag->GetLine() : -1;
         textAfterTokenReplacements = GetLanguage()->ApplyCtagsReplacementTokens(text);
-        scope = GetLanguage()->OptimizeScope(textAfterTokenReplacements, lastFuncLine, curFunctionBody);
+        CxxScopeCache::Analysis analysis;
+        CxxScopeCache::Get().GetAnalysis(fileName.GetFullPath(), textAfterTokenReplacements,
+                                         GetCtagsOptions().GetTokensWxMap(), analysis);
+        scope = analysis.m_optimizedScope;
 
         // First get the scoped tags
         TagsByScopeAndName(scopeName, word, scoped);
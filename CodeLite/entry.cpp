@@ -441,98 +441,108 @@ wxString TagEntry::GetPattern() const
     return pattern;
 }
 
+/**
+ * @brief return the tab separated field that starts at 'pos' and advance 'pos' past it
+ */
+static wxString NextTagField(const wxString& line, size_t& pos)
+{
+    if(pos >= line.length()) {
+        pos = line.length();
+        return wxEmptyString;
+    }
+    size_t tab = line.find(wxT('\t'), pos);
+    if(tab == wxString::npos) { tab = line.length(); }
+    wxString field = line.Mid(pos, tab - pos);
+    pos = (tab < line.length()) ? tab + 1 : tab;
+    return field;
+}
+
 void TagEntry::FromLine(const wxString& line)
 {
     wxString pattern, kind;
-    wxString strLine = line;
     long lineNumber = wxNOT_FOUND;
     wxStringMap_t extFields;
 
+    // The line is scanned once from left to right: each field is copied exactly
+    // once instead of copying the remainder of the line after every field
+    size_t pos = 0;
+
     // get the token name
-    wxString name = strLine.BeforeFirst(wxT('\t'));
-    strLine = strLine.AfterFirst(wxT('\t'));
+    wxString name = NextTagField(line, pos);
 
     // get the file name
-    wxString fileName = strLine.BeforeFirst(wxT('\t'));
-    strLine = strLine.AfterFirst(wxT('\t'));
+    wxString fileName = NextTagField(line, pos);
 
     // here we can get two options:
     // pattern followed by ;"
     // or
     // line number followed by ;"
-    int end = strLine.Find(wxT(";\""));
-    if(end == wxNOT_FOUND) {
+    size_t end = line.find(wxT(";\""), pos);
+    if(end == wxString::npos) {
         // invalid pattern found
         return;
     }
 
-    if(strLine.StartsWith(wxT("/^"))) {
-        // regular expression pattern found
-        pattern = strLine.Mid(0, end);
-        strLine = strLine.Right(strLine.Length() - (end + 2));
-    } else {
+    bool isRegexPattern = (line.compare(pos, 2, wxT("/^")) == 0);
+    pattern = line.Mid(pos, end - pos);
+    pos = end + 2;
+    if(!isRegexPattern) {
         // line number pattern found, this is usually the case when
         // dealing with macros in C++
-        pattern = strLine.Mid(0, end);
-        strLine = strLine.Right(strLine.Length() - (end + 2));
-
-        pattern = pattern.Trim();
-        pattern = pattern.Trim(false);
+        pattern.Trim().Trim(false);
         pattern.ToLong(&lineNumber);
     }
 
     // next is the kind of the token
-    if(strLine.StartsWith(wxT("\t"))) {
-        strLine = strLine.AfterFirst(wxT('\t'));
-    }
-
-    kind = strLine.BeforeFirst(wxT('\t'));
-    strLine = strLine.AfterFirst(wxT('\t'));
-
-    if(strLine.IsEmpty() == false) {
-        wxStringTokenizer tkz(strLine, wxT('\t'));
-        while(tkz.HasMoreTokens()) {
-            wxString token = tkz.NextToken();
-            wxString key = token.BeforeFirst(wxT(':'));
-            wxString val = token.AfterFirst(wxT(':'));
-            key = key.Trim();
-            key = key.Trim(false);
-
-            val = val.Trim();
-            val = val.Trim(false);
-            if(key == wxT("line") && !val.IsEmpty()) {
-                val.ToLong(&lineNumber);
-            } else {
-                if(key == wxT("union") || key == wxT("struct")) {
-
-                    // remove the anonymous part of the struct / union
-                    if(!val.StartsWith(wxT("__anon"))) {
-                        // an internal anonymous union / struct
-                        // remove all parts of the
-                        wxArrayString scopeArr;
-                        wxString tmp, new_val;
-
-                        scopeArr = wxStringTokenize(val, wxT(":"), wxTOKEN_STRTOK);
-                        for(size_t i = 0; i < scopeArr.GetCount(); i++) {
-                            if(scopeArr.Item(i).StartsWith(wxT("__anon")) == false) {
-                                tmp << scopeArr.Item(i) << wxT("::");
-                            }
-                        }
+    if(pos < line.length() && line[pos] == wxT('\t')) { ++pos; }
+    kind = NextTagField(line, pos);
 
-                        tmp.EndsWith(wxT("::"), &new_val);
-                        val = new_val;
+    while(pos < line.length()) {
+        wxString token = NextTagField(line, pos);
+        if(token.IsEmpty()) { continue; }
+
+        wxString key, val;
+        size_t colon = token.find(wxT(':'));
+        if(colon == wxString::npos) {
+            key = token;
+        } else {
+            key = token.Mid(0, colon);
+            val = token.Mid(colon + 1);
+        }
+        key.Trim().Trim(false);
+        val.Trim().Trim(false);
+        if(key == wxT("line") && !val.IsEmpty()) {
+            val.ToLong(&lineNumber);
+        } else {
+            if(key == wxT("union") || key == wxT("struct")) {
+
+                // remove the anonymous part of the struct / union
+                if(!val.StartsWith(wxT("__anon"))) {
+                    // an internal anonymous union / struct
+                    // remove all parts of the
+                    wxArrayString scopeArr;
+                    wxString tmp, new_val;
+
+                    scopeArr = wxStringTokenize(val, wxT(":"), wxTOKEN_STRTOK);
+                    for(size_t i = 0; i < scopeArr.GetCount(); i++) {
+                        if(scopeArr.Item(i).StartsWith(wxT("__anon")) == false) {
+                            tmp << scopeArr.Item(i) << wxT("::");
+                        }
                     }
-                }
 
-                extFields[key] = val;
+                    tmp.EndsWith(wxT("::"), &new_val);
+                    val = new_val;
+                }
             }
+
+            extFields[key] = val;
         }
     }
 
-    kind = kind.Trim();
-    name = name.Trim();
-    fileName = fileName.Trim();
-    pattern = pattern.Trim();
+    kind.Trim();
+    name.Trim();
+    fileName.Trim();
+    pattern.Trim();
 
     if(kind == "enumerator" && extFields.count("enum")) {
         // Remove the last parent
@@ -30,6 +30,7 @@
 
 #include "CxxLexerAPI.h"
 #include "CxxPreProcessor.h"
+#include "CxxScopeCache.h"
 #include "CxxScannerTokens.h"
 #include "CxxTemplateFunction.h"
 #include "CxxUsingNamespaceCollector.h"
@@ -110,6 +111,14 @@ Language::~Language() {}
 
 /// Return the visible scope until pchStopWord is encountered
 wxString Language::OptimizeScope(const wxString& srcString, int lastFuncLine, wxString& localsScope)
+{
+    wxString scope;
+    if(!DoOptimizeScope(srcString, scope)) return "";
+    localsScope = scope;
+    return scope;
+}
+
+bool Language::DoOptimizeScope(const wxString& srcString, wxString& scope, int* openBlocks)
 {
     CxxTokenizer tokenizer;
     std::stack<wxString> scopes;
@@ -130,7 +139,7 @@ wxString Language::OptimizeScope(const wxString& srcString, int lastFuncLine, wx
                 currentScope.clear();
                 break;
             case '}':
-                if(scopes.empty()) return ""; // Invalid braces count
+                if(scopes.empty()) return false; // Invalid braces count
                 currentScope = scopes.top();
                 scopes.pop();
                 currentScope << "} ";
@@ -238,14 +247,18 @@ wxString Language::OptimizeScope(const wxString& srcString, int lastFuncLine, wx
         }
     }
 
+    if(openBlocks) {
+        *openBlocks = ((state == SCP_STATE_NORMAL) && (parenthesisDepth == 0)) ? (int)scopes.size() : wxNOT_FOUND;
+    }
+
     wxString s;
     while(!scopes.empty()) {
         s.Prepend(scopes.top());
         scopes.pop();
     }
     s << currentScope;
-    localsScope = s;
-    return s;
+    scope.swap(s);
+    return true;
 }
 
 ParsedToken* Language::ParseTokens(const wxString& scopeName)
@@ -519,10 +532,13 @@ bool Language::ProcessExpression(const wxString& stmt, const wxString& text, con
     const wxStringTable_t& ignoreTokens = GetTagsManager()->GetCtagsOptions().GetTokensWxMap();
     m_locals.clear();
     {
-        CxxVariableScanner scanner(textAfterTokensReplacements, eCxxStandard::kCxx11, ignoreTokens, false);
-        CxxVariable::Map_t localsMap = scanner.GetVariablesMap();
+        // Only the text after the cached part of the file is scanned
+        CxxScopeCache::Analysis analysis;
+        CxxScopeCache::Get().GetAnalysis(fn.GetFullPath(), textAfterTokensReplacements, ignoreTokens, analysis);
+        visibleScope = analysis.m_visibleScope;
+        CxxVariableScanner scanner(visibleScope, eCxxStandard::kCxx11, ignoreTokens, false);
+        CxxVariable::Map_t localsMap = scanner.GetVariablesMap(true);
         m_locals.insert(localsMap.begin(), localsMap.end());
-        scanner.OptimizeBuffer(textAfterTokensReplacements, visibleScope);
     }
 
     if(!lastFuncSig.IsEmpty()) {
@@ -2050,10 +2066,14 @@ Language* LanguageST::Get()
 }
 
 wxString Language::ApplyCtagsReplacementTokens(const wxString& in)
+{
+    return ApplyCtagsReplacementTokens(in, GetTagsManager()->GetCtagsOptions().GetTokensWxMap());
+}
+
+wxString Language::ApplyCtagsReplacementTokens(const wxString& in, const wxStringTable_t& replacementMap)
 {
     // First, get the replacement map
     CLReplacementList replacements;
-    const wxStringTable_t& replacementMap = GetTagsManager()->GetCtagsOptions().GetTokensWxMap();
     wxStringTable_t::const_iterator iter = replacementMap.begin();
     for(; iter != replacementMap.end(); ++iter) {
 
@@ -143,6 +143,15 @@ public:
      */
     wxString OptimizeScope(const wxString& srcString, int lastFuncLine, wxString& localsScope);
 
+    /**
+     * @brief the implementation of OptimizeScope(). Return false if the braces are not balanced
+     * @param openBlocks [output] the number of blocks still open at the end of srcString, or wxNOT_FOUND if it ends
+     * inside parentheses or a statement header. When it is not wxNOT_FOUND, the scope of a text that starts with
+     * srcString is 'scope' followed by the scope of the remaining text, as long as that text does not close these
+     * blocks
+     */
+    static bool DoOptimizeScope(const wxString& srcString, wxString& scope, int* openBlocks = NULL);
+
     /**
      * @brief given fileContent, locate the best line to place a class forward declaration
      * statement
@@ -254,6 +263,7 @@ public:
                            const wxString& name = wxEmptyString, size_t flag = PartialMatch);
 
     wxString ApplyCtagsReplacementTokens(const wxString& in);
+    static wxString ApplyCtagsReplacementTokens(const wxString& in, const wxStringTable_t& replacementMap);
 
     bool VariableFromPattern(const wxString& pattern, const wxString& name, Variable& var);
     bool FunctionFromPattern(TagEntryPtr tag, clFunction& foo);
@@ -23,7 +23,9 @@
 //////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////
 #include "CxxScannerTokens.h"
+#include "CxxScopeCache.h"
 #include "CxxVariableScanner.h"
+#include "clPerfTrace.h"
 #include "cl_command_event.h"
 #include "cl_standard_paths.h"
 #include "cpp_scanner.h"
@@ -99,6 +101,7 @@ static const wxString& WriteCodeLiteCCHelperFile()
 
 ParseThread::ParseThread()
     : WorkerThread()
+    , m_todLoaded(false)
 {
 }
 
@@ -106,12 +109,25 @@ ParseThread::~ParseThread() {}
 
 void ParseThread::ProcessRequest(ThreadRequest* request)
 {
-    clConfig config("code-completion.conf");
-    config.ReadItem(&m_tod);
-
     // request is delete by the parent WorkerThread after this method is completed
     ParseRequest* req = (ParseRequest*)request;
     FileLogger::RegisterThread(wxThread::GetCurrentId(), "C++ Parser Thread");
+    CL_TRACE_THREAD_NAME("C++ Parser Thread");
+
+    // A light request sent while the user edits a file, no need to notify anyone. It is sent often, so it uses the
+    // options loaded by the last full request
+    bool analyseScope = (req->getType() == ParseRequest::PR_ANALYSE_SCOPE);
+    if(!analyseScope || !m_todLoaded) {
+        clConfig config("code-completion.conf");
+        config.ReadItem(&m_tod);
+        m_todLoaded = true;
+    }
+
+    if(analyseScope) {
+        ProcessAnalyseScope(req);
+        return;
+    }
+    CL_TRACE_SCOPE("retag", "ParseThread::ProcessRequest");
 
     // Exclude all files found in the exclude folders
     wxArrayString inc, exc;
@@ -162,6 +178,7 @@ void ParseThread::ProcessRequest(ThreadRequest* request)
         break;
     default:
     case ParseRequest::PR_FILESAVED:
+        m_colourDirtyFiles.insert(req->getFile());
         ProcessSimple(req);
         break;
     case ParseRequest::PR_SOURCE_TO_TAGS:
@@ -359,6 +376,8 @@ void ParseThread::ParseAndStoreFiles(ParseRequest* req, const wxArrayString& arr
                                      ITagsStoragePtr db)
 {
     // Loop over the files and parse them
+    CL_TRACE_SCOPE("retag", "ParseThread::ParseAndStoreFiles");
+    CL_TRACE_COUNTER("retag", "Files to parse", arrFiles.GetCount());
     int totalSymbols(0);
     DEBUG_MESSAGE(wxString::Format(wxT("Parsing and saving files to database....")));
     for(size_t i = 0; i < arrFiles.GetCount(); i++) {
@@ -366,11 +385,20 @@ void ParseThread::ParseAndStoreFiles(ParseRequest* req, const wxArrayString& arr
         // give a shutdown request a chance
         TEST_DESTROY();
 
+        CL_TRACE_SCOPE("retag", arrFiles.Item(i));
         wxString tags; // output
-        TagsManagerST::Get()->SourceToTags(arrFiles.Item(i), tags);
+        {
+            CL_TRACE_SCOPE("retag", "SourceToTags");
+            TagsManagerST::Get()->SourceToTags(arrFiles.Item(i), tags);
+        }
 
-        if(tags.IsEmpty() == false) { DoStoreTags(tags, arrFiles.Item(i), totalSymbols, db); }
+        if(tags.IsEmpty() == false) {
+            CL_TRACE_SCOPE("retag", "DoStoreTags");
+            DoStoreTags(tags, arrFiles.Item(i), totalSymbols, db);
+        }
     }
+    CL_TRACE_COUNTER("retag", "Stored tags", totalSymbols);
+    if(totalSymbols) { m_colourKinds.clear(); }
 
     DEBUG_MESSAGE(wxString(wxT("Done")));
 
@@ -417,6 +445,7 @@ void ParseThread::ProcessDeleteTagsOfFiles(ParseRequest* req)
 
     db->DeleteFromFiles(file_array);
     db->Commit();
+    m_colourKinds.clear();
     DEBUG_MESSAGE(wxString(wxT("ParseThread::ProcessDeleteTagsOfFile - completed")));
 }
 
@@ -441,6 +470,10 @@ void ParseThread::ProcessParseAndStore(ParseRequest* req)
     int precent(0);
     int lastPercentageReported(0);
 
+    CL_TRACE_SCOPE("retag", "ParseThread::ProcessParseAndStore");
+    m_colourKinds.clear();
+    CL_TRACE_COUNTER("retag", "Files to parse", maxVal);
+
     // Prepend our hack file to the list of files to parse
     const wxString& hackfile = WriteCodeLiteCCHelperFile();
     req->_workspaceFiles.insert(req->_workspaceFiles.begin(), hackfile.ToStdString());
@@ -475,6 +508,7 @@ void ParseThread::ProcessParseAndStore(ParseRequest* req)
             req->_evtHandler->AddPendingEvent(retaggingProgressEvent);
         }
 
+        CL_TRACE_SCOPE("retag", curFile.GetFullPath());
         TagTreePtr tree = TagsManagerST::Get()->ParseSourceFile(curFile);
         PPScan(curFile.GetFullPath(), false);
 
@@ -580,6 +614,7 @@ ParseRequest& ParseRequest::operator=(const ParseRequest& rhs)
     setFile(rhs._file.c_str());
     setDbFile(rhs._dbfile.c_str());
     setTags(rhs._tags);
+    SetText(rhs.m_text);
     setType(rhs._type);
     return *this;
 }
@@ -668,54 +703,144 @@ void ParseThread::DoNotifyReady(wxEvtHandler* caller, int requestType)
     }
 }
 
+// Upper limits for the semantic colouring caches
+#define COLOUR_CACHE_MAX_FILES 100
+#define COLOUR_CACHE_MAX_IDENTIFIERS 200000
+
+void ParseThread::DoInvalidateColourKinds(const wxStringSet_t& identifiers)
+{
+    for(const wxString& identifier : identifiers) {
+        m_colourKinds.erase(identifier);
+    }
+}
+
 void ParseThread::ProcessColourRequest(ParseRequest* req)
 {
-    CxxTokenizer tokenizer;
+    CL_TRACE_SCOPE("colour", "ParseThread::ProcessColourRequest");
     // read the file content
     wxString content;
-    if(FileUtils::ReadFileContent(req->getFile(), content)) {
-        wxString flatStrLocals, flatClasses;
+    if(!FileUtils::ReadFileContent(req->getFile(), content)) { return; }
 
-        tokenizer.Reset(content);
+    // The kinds are only valid for the database they were read from
+    if(m_colourDbFile != req->getDbfile()) {
+        m_colourDbFile = req->getDbfile();
+        m_colourKinds.clear();
+    }
+    if(m_colourChunks.size() > COLOUR_CACHE_MAX_FILES) { m_colourChunks.clear(); }
+    if(m_colourKinds.size() > COLOUR_CACHE_MAX_IDENTIFIERS) { m_colourKinds.clear(); }
+
+    // When the file was retagged, the kind of any identifier that appeared in it may have changed
+    ColourChunks_t& oldChunks = m_colourChunks[req->getFile()];
+    bool fileRetagged = (m_colourDirtyFiles.erase(req->getFile()) > 0);
+    if(fileRetagged) {
+        for(const auto& vt : oldChunks) {
+            DoInvalidateColourKinds(vt.second);
+        }
+    }
 
-        // lex the file and collect all tokens of type IDENTIFIER
-        wxStringSet_t tokens;
-        CxxLexerToken tok;
-        while(tokenizer.NextToken(tok)) {
-            if(tok.GetType() == T_IDENTIFIER) { tokens.insert(tok.GetWXString()); }
+    // Split the file into chunks that end with a line starting with a closing brace (e.g. the end of a function or a
+    // class body). Only the chunks that changed since the last request for this file are lexed again
+    ColourChunks_t newChunks;
+    wxStringSet_t tokens;
+    size_t chunksLexed = 0;
+    size_t start = 0;
+    while(start < content.length()) {
+        size_t end = content.find("\n}", start);
+        if(end != wxString::npos) { end = content.find('\n', end + 2); }
+        end = (end == wxString::npos) ? content.length() : end + 1;
+
+        wxString chunk = content.Mid(start, end - start);
+        start = end;
+
+        size_t hash = std::hash<wxString>()(chunk);
+        if(newChunks.count(hash)) { continue; } // identical chunk, its identifiers were already collected
+        wxStringSet_t& identifiers = newChunks[hash];
+        ColourChunks_t::iterator iter = oldChunks.find(hash);
+        if(iter != oldChunks.end()) {
+            identifiers.swap(iter->second);
+        } else {
+            // lex the chunk and collect all tokens of type IDENTIFIER
+            ++chunksLexed;
+            CxxTokenizer tokenizer;
+            tokenizer.Reset(chunk);
+            CxxLexerToken tok;
+            while(tokenizer.NextToken(tok)) {
+                if(tok.GetType() == T_IDENTIFIER) { identifiers.insert(tok.GetWXString()); }
+            }
         }
+        tokens.insert(identifiers.begin(), identifiers.end());
+    }
+    oldChunks.swap(newChunks);
+    CL_TRACE_COUNTER("colour", "Chunks lexed", chunksLexed);
 
-        std::vector<wxString> tokensArr;
-        tokensArr.reserve(tokens.size());
-        std::for_each(tokens.begin(), tokens.end(), [&](const wxString& str) { tokensArr.push_back(str); });
-        std::sort(tokensArr.begin(), tokensArr.end());
+    // did we find anything?
+    if(tokens.empty()) { return; }
+    if(fileRetagged) { DoInvalidateColourKinds(tokens); }
+
+    // Only identifiers that we did not see before are looked up in the database
+    std::vector<wxString> unknownTokens;
+    for(const wxString& token : tokens) {
+        if(m_colourKinds.count(token) == 0) { unknownTokens.push_back(token); }
+    }
 
-        // did we find anything?
-        if(tokensArr.empty()) { return; }
+    if(!unknownTokens.empty()) {
+        std::sort(unknownTokens.begin(), unknownTokens.end());
 
         // Open the database
         ITagsStoragePtr db(new TagsStorageSQLite());
         db->OpenDatabase(req->getDbfile());
 
         std::vector<wxString> nonWorkspaceSymbols, workspaceSymbols;
-        db->RemoveNonWorkspaceSymbols(tokensArr, workspaceSymbols, nonWorkspaceSymbols);
-
-        // Convert the output to a space delimited array
-        std::for_each(workspaceSymbols.begin(), workspaceSymbols.end(),
-                      [&](const wxString& token) { flatClasses << token << " "; });
-        std::for_each(nonWorkspaceSymbols.begin(), nonWorkspaceSymbols.end(),
-                      [&](const wxString& token) { flatStrLocals << token << " "; });
-
-        if(req->_evtHandler) {
-            clCommandEvent event(wxEVT_PARSE_THREAD_SUGGEST_COLOUR_TOKENS);
-            wxArrayString res;
-            res.Add(flatClasses);
-            res.Add(flatStrLocals);
-            event.SetStrings(res);
-            event.SetFileName(req->getFile());
-            req->_evtHandler->AddPendingEvent(event);
+        db->RemoveNonWorkspaceSymbols(unknownTokens, workspaceSymbols, nonWorkspaceSymbols);
+        for(const wxString& token : unknownTokens) {
+            m_colourKinds[token] = kColourNone;
+        }
+        for(const wxString& token : workspaceSymbols) {
+            m_colourKinds[token] = kColourWorkspace;
+        }
+        for(const wxString& token : nonWorkspaceSymbols) {
+            m_colourKinds[token] = kColourLocal;
+        }
+    }
+    CL_TRACE_COUNTER("colour", "Identifiers looked up", unknownTokens.size());
+
+    // Sort the output so the editor can tell when nothing changed
+    std::vector<wxString> tokensArr(tokens.begin(), tokens.end());
+    std::sort(tokensArr.begin(), tokensArr.end());
+
+    // Convert the output to a space delimited array
+    wxString flatStrLocals, flatClasses;
+    for(const wxString& token : tokensArr) {
+        switch(m_colourKinds[token]) {
+        case kColourWorkspace:
+            flatClasses << token << " ";
+            break;
+        case kColourLocal:
+            flatStrLocals << token << " ";
+            break;
+        default:
+            break;
         }
     }
+
+    if(req->_evtHandler) {
+        clCommandEvent event(wxEVT_PARSE_THREAD_SUGGEST_COLOUR_TOKENS);
+        wxArrayString res;
+        res.Add(flatClasses);
+        res.Add(flatStrLocals);
+        event.SetStrings(res);
+        event.SetFileName(req->getFile());
+        req->_evtHandler->AddPendingEvent(event);
+    }
+}
+
+void ParseThread::ProcessAnalyseScope(ParseRequest* req)
+{
+    CL_TRACE_SCOPE("completion", "ParseThread::ProcessAnalyseScope");
+    // Prepare the analysis of the text up to the caret, the same way code completion does
+    wxString text = Language::ApplyCtagsReplacementTokens(req->GetText(), m_tod.GetTokensWxMap());
+    CxxScopeCache::Analysis analysis;
+    CxxScopeCache::Get().GetAnalysis(req->getFile(), text, m_tod.GetTokensWxMap(), analysis);
 }
 
 void ParseThread::ProcessSourceToTags(ParseRequest* req)
@@ -29,12 +29,14 @@
 #include "codelite_exports.h"
 #include "entry.h"
 #include "istorage.h"
+#include "macros.h"
 #include "procutils.h"
 #include "singleton.h"
 #include "tag_tree.h"
 #include "worker_thread.h"
 #include <map>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 #include <wx/stopwatch.h>
 #include "tags_options_data.h"
@@ -53,6 +55,7 @@ class WXDLLIMPEXP_CL ParseRequest : public ThreadRequest
     wxString _file;
     wxString _dbfile;
     wxString _tags;
+    wxString m_text;
     int _type;
     wxArrayString m_definitions;
     wxArrayString m_includePaths;
@@ -73,6 +76,7 @@ public:
         PR_PARSE_INCLUDE_STATEMENTS,
         PR_SUGGEST_HIGHLIGHT_WORDS,
         PR_SOURCE_TO_TAGS,
+        PR_ANALYSE_SCOPE,
     };
 
 public:
@@ -95,6 +99,8 @@ public:
     void setFile(const wxString& file);
     void setDbFile(const wxString& dbfile);
     void setTags(const wxString& tags);
+    void SetText(const wxString& text) { this->m_text = text.c_str(); }
+    const wxString& GetText() const { return m_text; }
 
     // Getters
     const wxString& getDbfile() const { return _dbfile; }
@@ -128,6 +134,19 @@ class WXDLLIMPEXP_CL ParseThread : public WorkerThread
     bool m_crawlerEnabled;
     wxCriticalSection m_cs;
     TagsOptionsData m_tod;
+    bool m_todLoaded; // m_tod was read at least once
+
+    // Semantic colouring caches, only accessed from the parser thread
+    enum eColourKind {
+        kColourNone,      // function, prototype or macro: not coloured
+        kColourWorkspace, // class, struct, enum, namespace, typedef
+        kColourLocal,     // not found in the tags database
+    };
+    typedef std::unordered_map<size_t, wxStringSet_t> ColourChunks_t;
+    std::unordered_map<wxString, ColourChunks_t> m_colourChunks; ///< file -> chunk hash -> identifiers
+    std::unordered_map<wxString, eColourKind> m_colourKinds;      ///< identifier -> kind
+    wxStringSet_t m_colourDirtyFiles;                            ///< files retagged since they were coloured
+    wxString m_colourDbFile;
 
 public:
     void SetCrawlerEnabeld(bool b);
@@ -181,6 +200,8 @@ private:
     void ProcessSimpleNoIncludes(ParseRequest* req);
     void ProcessIncludeStatements(ParseRequest* req);
     void ProcessColourRequest(ParseRequest* req);
+    void ProcessAnalyseScope(ParseRequest* req);
+    void DoInvalidateColourKinds(const wxStringSet_t& identifiers);
     void GetFileListToParse(const wxString& filename, wxArrayString& arrFiles);
     void ParseAndStoreFiles(ParseRequest* req, const wxArrayString& arrFiles, int initalCount, ITagsStoragePtr db);
 
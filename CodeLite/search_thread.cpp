@@ -23,6 +23,7 @@
 //////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////
 #include "clFilesCollector.h"
+#include "clPerfTrace.h"
 #include "cppwordscanner.h"
 #include "dirtraverser.h"
 #include "fileutils.h"
@@ -138,6 +139,8 @@ void SearchThread::PerformSearch(const SearchData& data) { Add(new SearchData(da
 
 void SearchThread::ProcessRequest(ThreadRequest* req)
 {
+    CL_TRACE_THREAD_NAME("Search");
+    CL_TRACE_SCOPE("search", "SearchThread::ProcessRequest");
     wxStopWatch sw;
     m_summary = SearchSummary();
     DoSearchFiles(req);
@@ -153,6 +156,7 @@ void SearchThread::ProcessRequest(ThreadRequest* req)
 
 void SearchThread::GetFiles(const SearchData* data, wxArrayString& files)
 {
+    CL_TRACE_SCOPE("search", "SearchThread::GetFiles");
     wxStringSet_t scannedFiles;
 
     const wxArrayString& rootDirs = data->GetRootDirs();
@@ -176,6 +180,7 @@ void SearchThread::GetFiles(const SearchData* data, wxArrayString& files)
 
     // Filter all non matching files
     FilterFiles(files, data);
+    CL_TRACE_COUNTER("search", "Files to search", files.size());
 }
 
 void SearchThread::DoSearchFiles(ThreadRequest* req)
@@ -238,12 +243,14 @@ void SearchThread::StopSearch(bool stop)
 
 void SearchThread::DoSearchFile(const wxString& fileName, const SearchData* data)
 {
+    CL_TRACE_SCOPE("search", fileName);
     // Process single lines
     int lineNumber = 1;
     if(!wxFileName::FileExists(fileName)) { return; }
 
     size_t size = FileUtils::GetFileSize(fileName);
     if(size == 0) { return; }
+    time_t modificationTime = FileUtils::GetFileModificationTime(fileName);
     wxString fileData;
     fileData.Alloc(size);
 
@@ -326,7 +333,16 @@ void SearchThread::DoSearchFile(const wxString& fileName, const SearchData* data
         }
     }
 
-    if(m_results.empty() == false) { SendEvent(wxEVT_SEARCH_THREAD_MATCHFOUND, data->GetOwner()); }
+    if(m_results.empty() == false) {
+        // Keep the state of the file, the replace uses it to detect files modified since the search.
+        // The matches of this file are the last ones in the list
+        size_t hash = std::hash<wxString>()(fileData);
+        SearchResultList::reverse_iterator iter = m_results.rbegin();
+        for(; (iter != m_results.rend()) && (iter->GetFileName() == fileName); ++iter) {
+            iter->SetFileStamp(size, modificationTime, hash);
+        }
+        SendEvent(wxEVT_SEARCH_THREAD_MATCHFOUND, data->GetOwner());
+    }
 }
 
 void SearchThread::DoSearchLineRE(const wxString& line, const int lineNum, const int lineOffset,
@@ -165,10 +165,19 @@ class WXDLLIMPEXP_CL SearchResult : public wxObject
     int m_lenInChars;
     short m_matchState;
     wxString m_scope;
+    // The state of the file when it was searched
+    size_t m_fileSize;
+    time_t m_fileModificationTime;
+    size_t m_fileHash;
 
 public:
     // ctor-dtor, copy constructor and assignment operator
-    SearchResult() {}
+    SearchResult()
+        : m_fileSize(0)
+        , m_fileModificationTime(0)
+        , m_fileHash(0)
+    {
+    }
 
     virtual ~SearchResult() {}
 
@@ -189,6 +198,9 @@ public:
         m_lenInChars = rhs.m_lenInChars;
         m_matchState = rhs.m_matchState;
         m_scope = rhs.m_scope.c_str();
+        m_fileSize = rhs.m_fileSize;
+        m_fileModificationTime = rhs.m_fileModificationTime;
+        m_fileHash = rhs.m_fileHash;
         return *this;
     }
 
@@ -233,6 +245,20 @@ public:
 
     void SetScope(const wxString& scope) { this->m_scope = scope.c_str(); }
     const wxString& GetScope() const { return m_scope; }
+
+    /**
+     * @brief set the state of the file when it was searched: its size, modification time and the hash of its
+     * content (std::hash<wxString>). These are used to detect files modified after the search
+     */
+    void SetFileStamp(size_t fileSize, time_t fileModificationTime, size_t fileHash)
+    {
+        this->m_fileSize = fileSize;
+        this->m_fileModificationTime = fileModificationTime;
+        this->m_fileHash = fileHash;
+    }
+    size_t GetFileSize() const { return m_fileSize; }
+    time_t GetFileModificationTime() const { return m_fileModificationTime; }
+    size_t GetFileHash() const { return m_fileHash; }
     // return a foramtted message
     wxString GetMessage() const
     {
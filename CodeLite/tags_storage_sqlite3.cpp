@@ -566,6 +566,31 @@ TagEntry* TagsStorageSQLite::FromSQLite3ResultSet(wxSQLite3ResultSet& rs)
     return entry;
 }
 
+uint32_t TagsStorageSQLite::DoAddCacheRecord(wxSQLite3ResultSet& rs)
+{
+    TagRecordTable& records = m_cache.GetRecords();
+    int index = records.Find(rs.GetInt(0));
+    if(index != wxNOT_FOUND) { return index; }
+
+    // Same columns as FromSQLite3ResultSet()
+    TagRecordTable::Columns columns;
+    columns.id = rs.GetInt(0);
+    columns.name = rs.GetString(1);
+    columns.file = rs.GetString(2);
+    columns.line = rs.GetInt(3);
+    columns.kind = rs.GetString(4);
+    columns.access = rs.GetString(5);
+    columns.signature = rs.GetString(6);
+    columns.pattern = rs.GetString(7);
+    columns.parent = rs.GetString(8);
+    columns.inherits = rs.GetString(9);
+    columns.path = rs.GetString(10);
+    columns.typeref = rs.GetString(11);
+    columns.scope = rs.GetString(12);
+    columns.returns = rs.GetString(13);
+    return records.Add(columns);
+}
+
 void TagsStorageSQLite::DoFetchTags(const wxString& sql, std::vector<TagEntryPtr>& tags)
 {
     if(GetUseCache()) {
@@ -579,16 +604,24 @@ void TagsStorageSQLite::DoFetchTags(const wxString& sql, std::vector<TagEntryPtr
     clDEBUG1() << "Entry not found in cache" << sql << clEndl;
     clDEBUG1() << "Fetching from disk..." << clEndl;
     tags.reserve(500);
+    std::vector<uint32_t> records;
     try {
         wxSQLite3ResultSet ex_rs;
         ex_rs = Query(sql);
 
         // add results from external database to the workspace database
         while(ex_rs.NextRow()) {
-            // Construct a TagEntry from the rescord set
-            TagEntryPtr tag(FromSQLite3ResultSet(ex_rs));
-            // conver the path to be real path
-            tags.push_back(tag);
+            if(GetUseCache()) {
+                // Keep the row as a cache record and build the TagEntry from it
+                uint32_t index = DoAddCacheRecord(ex_rs);
+                records.push_back(index);
+                tags.push_back(m_cache.GetRecords().Get(index));
+            } else {
+                // Construct a TagEntry from the rescord set
+                TagEntryPtr tag(FromSQLite3ResultSet(ex_rs));
+                // conver the path to be real path
+                tags.push_back(tag);
+            }
         }
         ex_rs.Finalize();
     } catch(wxSQLite3Exception& e) {
@@ -597,7 +630,7 @@ void TagsStorageSQLite::DoFetchTags(const wxString& sql, std::vector<TagEntryPtr
     clDEBUG1() << "Fetching from disk...done" << clEndl;
     if(GetUseCache()) {
         clDEBUG1() << "Updating cache" << clEndl;
-        m_cache.Store(sql, tags);
+        m_cache.Store(sql, records);
         clDEBUG1() << "Updating cache...done (" << tags.size() << "entries)" << clEndl;
     }
 }
@@ -613,6 +646,7 @@ void TagsStorageSQLite::DoFetchTags(const wxString& sql, std::vector<TagEntryPtr
     }
 
     CL_DEBUG1("Fetching from disk");
+    std::vector<uint32_t> records;
     try {
         wxSQLite3ResultSet ex_rs;
         ex_rs = Query(sql);
@@ -622,11 +656,17 @@ void TagsStorageSQLite::DoFetchTags(const wxString& sql, std::vector<TagEntryPtr
             // check if this kind is accepted
             if(kinds.Index(ex_rs.GetString(4)) != wxNOT_FOUND) {
 
-                // Construct a TagEntry from the rescord set
-                TagEntryPtr tag(FromSQLite3ResultSet(ex_rs));
+                if(GetUseCache()) {
+                    uint32_t index = DoAddCacheRecord(ex_rs);
+                    records.push_back(index);
+                    tags.push_back(m_cache.GetRecords().Get(index));
+                } else {
+                    // Construct a TagEntry from the rescord set
+                    TagEntryPtr tag(FromSQLite3ResultSet(ex_rs));
 
-                // conver the path to be real path
-                tags.push_back(tag);
+                    // conver the path to be real path
+                    tags.push_back(tag);
+                }
             }
         }
         ex_rs.Finalize();
@@ -637,7 +677,7 @@ void TagsStorageSQLite::DoFetchTags(const wxString& sql, std::vector<TagEntryPtr
     CL_DEBUG1("Fetching from disk...done");
     if(GetUseCache()) {
         CL_DEBUG1("updating cache");
-        m_cache.Store(sql, kinds, tags);
+        m_cache.Store(sql, kinds, records);
         CL_DEBUG1("updating cache...done");
     }
 }
@@ -883,8 +923,6 @@ int TagsStorageSQLite::DoInsertTagEntry(const TagEntry& tag)
 
 bool TagsStorageSQLite::IsTypeAndScopeContainer(wxString& typeName, wxString& scope)
 {
-    wxString sql;
-
     // Break the typename to 'name' and scope
     wxString typeNameNoScope(typeName.AfterLast(wxT(':')));
     wxString scopeOne(typeName.BeforeLast(wxT(':')));
@@ -900,43 +938,37 @@ bool TagsStorageSQLite::IsTypeAndScopeContainer(wxString& typeName, wxString& sc
         combinedScope << scopeOne;
     }
 
-    sql << wxT("select scope,kind from tags where name='") << typeNameNoScope << wxT("'");
-
     bool found_global(false);
 
-    try {
-        wxSQLite3ResultSet rs = Query(sql);
-        while(rs.NextRow()) {
-            wxString scopeFounded(rs.GetString(0));
-            wxString kindFounded(rs.GetString(1));
-
-            bool containerKind = kindFounded == wxT("struct") || kindFounded == wxT("class") || kindFounded == "cenum";
-            if(scopeFounded == combinedScope && containerKind) {
-                scope = combinedScope;
-                typeName = typeNameNoScope;
-                // we got an exact match
-                return true;
-
-            } else if(scopeFounded == scopeOne && containerKind) {
-                // this is equal to cases like this:
-                // class A {
-                // typedef std::list<int> List;
-                // List l;
-                // };
-                // the combinedScope will be: 'A::std'
-                // however, the actual scope is 'std'
-                scope = scopeOne;
-                typeName = typeNameNoScope;
-                // we got an exact match
-                return true;
-
-            } else if(containerKind && scopeFounded == wxT("<global>")) {
-                found_global = true;
-            }
+    TagsStorageSQLiteCache::TypeInfoVec_t types;
+    DoFetchTypes(typeNameNoScope, types);
+    for(size_t i = 0; i < types.size(); ++i) {
+        const wxString& scopeFounded = types[i].scope;
+        const wxString& kindFounded = types[i].kind;
+
+        bool containerKind = kindFounded == wxT("struct") || kindFounded == wxT("class") || kindFounded == "cenum";
+        if(scopeFounded == combinedScope && containerKind) {
+            scope = combinedScope;
+            typeName = typeNameNoScope;
+            // we got an exact match
+            return true;
+
+        } else if(scopeFounded == scopeOne && containerKind) {
+            // this is equal to cases like this:
+            // class A {
+            // typedef std::list<int> List;
+            // List l;
+            // };
+            // the combinedScope will be: 'A::std'
+            // however, the actual scope is 'std'
+            scope = scopeOne;
+            typeName = typeNameNoScope;
+            // we got an exact match
+            return true;
+
+        } else if(containerKind && scopeFounded == wxT("<global>")) {
+            found_global = true;
         }
-
-    } catch(wxSQLite3Exception& e) {
-        wxUnusedVar(e);
     }
 
     // if we reached here, it means we did not find any exact match
@@ -951,7 +983,6 @@ bool TagsStorageSQLite::IsTypeAndScopeContainer(wxString& typeName, wxString& sc
 
 bool TagsStorageSQLite::IsTypeAndScopeExist(wxString& typeName, wxString& scope)
 {
-    wxString sql;
     wxString strippedName;
     wxString secondScope;
     wxString bestScope;
@@ -965,8 +996,6 @@ bool TagsStorageSQLite::IsTypeAndScopeExist(wxString& typeName, wxString& scope)
 
     if(strippedName.IsEmpty()) return false;
 
-    sql << wxT("select scope,parent from tags where name='") << strippedName
-        << wxT("' and kind in ('class', 'struct', 'typedef') LIMIT 50");
     int foundOther(0);
     wxString scopeFounded;
     wxString parentFounded;
@@ -975,29 +1004,30 @@ bool TagsStorageSQLite::IsTypeAndScopeExist(wxString& typeName, wxString& scope)
 
     parent = tmpScope.AfterLast(wxT(':'));
 
-    try {
-        wxSQLite3ResultSet rs = Query(sql);
-        while(rs.NextRow()) {
+    TagsStorageSQLiteCache::TypeInfoVec_t types;
+    DoFetchTypes(strippedName, types);
+    // Check up to 50 matches
+    size_t count = 0;
+    for(size_t i = 0; i < types.size() && count < 50; ++i) {
+        const wxString& kind = types[i].kind;
+        if(kind != "class" && kind != "struct" && kind != "typedef") { continue; }
+        ++count;
 
-            scopeFounded = rs.GetString(0);
-            parentFounded = rs.GetString(1);
+        scopeFounded = types[i].scope;
+        parentFounded = types[i].parent;
 
-            if(scopeFounded == tmpScope) {
-                // exact match
-                scope = scopeFounded;
-                typeName = strippedName;
-                return true;
+        if(scopeFounded == tmpScope) {
+            // exact match
+            scope = scopeFounded;
+            typeName = strippedName;
+            return true;
 
-            } else if(parentFounded == parent) {
-                bestScope = scopeFounded;
+        } else if(parentFounded == parent) {
+            bestScope = scopeFounded;
 
-            } else {
-                foundOther++;
-            }
+        } else {
+            foundOther++;
         }
-
-    } catch(wxSQLite3Exception& e) {
-        wxUnusedVar(e);
     }
 
     // if we reached here, it means we did not find any exact match
@@ -1014,6 +1044,31 @@ bool TagsStorageSQLite::IsTypeAndScopeExist(wxString& typeName, wxString& scope)
     return false;
 }
 
+void TagsStorageSQLite::DoFetchTypes(const wxString& name, TagsStorageSQLiteCache::TypeInfoVec_t& types)
+{
+    // These lookups are done over and over while resolving expressions, keep the (small) results in the cache
+    if(GetUseCache() && m_cache.GetTypes(name, types)) { return; }
+
+    wxString sql;
+    sql << "select scope,kind,parent from tags where name='" << name
+        << "' and kind in ('class', 'struct', 'cenum', 'typedef')";
+    try {
+        wxSQLite3ResultSet rs = Query(sql);
+        while(rs.NextRow()) {
+            TagsStorageSQLiteCache::TypeInfo info;
+            info.scope = rs.GetString(0);
+            info.kind = rs.GetString(1);
+            info.parent = rs.GetString(2);
+            types.push_back(info);
+        }
+        rs.Finalize();
+    } catch(wxSQLite3Exception& e) {
+        wxUnusedVar(e);
+    }
+
+    if(GetUseCache()) { m_cache.StoreTypes(name, types); }
+}
+
 void TagsStorageSQLite::GetScopesFromFileAsc(const wxFileName& fileName, std::vector<wxString>& scopes)
 {
     wxString sql;
@@ -1342,48 +1397,65 @@ bool TagsStorageSQLiteCache::Get(const wxString& sql, std::vector<TagEntryPtr>&
 
 bool TagsStorageSQLiteCache::Get(const wxString& sql, const wxArrayString& kind, std::vector<TagEntryPtr>& tags)
 {
-    wxString key;
-    key << sql;
-    for(size_t i = 0; i < kind.GetCount(); i++) {
-        key << wxT("@") << kind.Item(i);
-    }
-
-    return DoGet(key, tags);
+    return DoGet(DoGetKey(sql, kind), tags);
 }
 
-void TagsStorageSQLiteCache::Store(const wxString& sql, const std::vector<TagEntryPtr>& tags) { DoStore(sql, tags); }
+void TagsStorageSQLiteCache::Store(const wxString& sql, const std::vector<uint32_t>& records)
+{
+    DoStore(sql, records);
+}
 
 void TagsStorageSQLiteCache::Clear()
 {
     // CL_DEBUG1(wxT("[CACHE CLEARED]"));
     m_cache.clear();
+    m_types.clear();
+    m_records.Clear();
 }
 
-void TagsStorageSQLiteCache::Store(const wxString& sql, const wxArrayString& kind, const std::vector<TagEntryPtr>& tags)
+bool TagsStorageSQLiteCache::GetTypes(const wxString& name, TypeInfoVec_t& types) const
+{
+    std::unordered_map<wxString, TypeInfoVec_t>::const_iterator iter = m_types.find(name);
+    if(iter == m_types.end()) { return false; }
+    types = iter->second;
+    return true;
+}
+
+void TagsStorageSQLiteCache::StoreTypes(const wxString& name, const TypeInfoVec_t& types) { m_types[name] = types; }
+
+void TagsStorageSQLiteCache::Store(const wxString& sql, const wxArrayString& kind,
+                                   const std::vector<uint32_t>& records)
+{
+    DoStore(DoGetKey(sql, kind), records);
+}
+
+wxString TagsStorageSQLiteCache::DoGetKey(const wxString& sql, const wxArrayString& kind) const
 {
     wxString key;
     key << sql;
     for(size_t i = 0; i < kind.GetCount(); i++) {
         key << wxT("@") << kind.Item(i);
     }
-    DoStore(key, tags);
+    return key;
 }
 
 bool TagsStorageSQLiteCache::DoGet(const wxString& key, std::vector<TagEntryPtr>& tags)
 {
-    std::unordered_map<wxString, std::vector<TagEntryPtr> >::iterator iter = m_cache.find(key);
+    std::unordered_map<wxString, std::vector<uint32_t> >::iterator iter = m_cache.find(key);
     if(iter != m_cache.end()) {
         // Append the results to the output tags
-        tags.insert(tags.end(), iter->second.begin(), iter->second.end());
+        tags.reserve(tags.size() + iter->second.size());
+        for(size_t i = 0; i < iter->second.size(); ++i) {
+            tags.push_back(m_records.Get(iter->second[i]));
+        }
         return true;
     }
     return false;
 }
 
-void TagsStorageSQLiteCache::DoStore(const wxString& key, const std::vector<TagEntryPtr>& tags)
+void TagsStorageSQLiteCache::DoStore(const wxString& key, const std::vector<uint32_t>& records)
 {
-    m_cache[key].reserve(tags.size());
-    m_cache[key] = tags;
+    m_cache[key] = records;
 }
 
 void TagsStorageSQLite::ClearCache() { m_cache.Clear(); }
@@ -34,6 +34,7 @@
 #include <wx/wxsqlite3.h>
 #include "codelite_exports.h"
 #include "wxStringHash.h"
+#include "TagRecordTable.h"
 
 /**
  * TagsDatabase is a wrapper around wxSQLite3 database with tags specific functions.
@@ -92,11 +93,28 @@
 
 class TagsStorageSQLiteCache
 {
-    std::unordered_map<wxString, std::vector<TagEntryPtr> > m_cache;
+public:
+    /**
+     * @brief a lightweight record of a type (class, struct, typedef or enum) with the given name, used to resolve
+     * types and scopes without materialising TagEntry objects
+     */
+    struct TypeInfo {
+        wxString scope;
+        wxString kind;
+        wxString parent;
+    };
+    typedef std::vector<TypeInfo> TypeInfoVec_t;
+
+private:
+    // the cached tags are kept as compact records and converted to TagEntry only when a query hits the cache
+    TagRecordTable m_records;
+    std::unordered_map<wxString, std::vector<uint32_t> > m_cache;
+    std::unordered_map<wxString, TypeInfoVec_t> m_types;
 
 protected:
     bool DoGet(const wxString& key, std::vector<TagEntryPtr>& tags);
-    void DoStore(const wxString& key, const std::vector<TagEntryPtr>& tags);
+    void DoStore(const wxString& key, const std::vector<uint32_t>& records);
+    wxString DoGetKey(const wxString& sql, const wxArrayString& kind) const;
 
 public:
     TagsStorageSQLiteCache();
@@ -104,8 +122,14 @@ public:
 
     bool Get(const wxString& sql, std::vector<TagEntryPtr>& tags);
     bool Get(const wxString& sql, const wxArrayString& kind, std::vector<TagEntryPtr>& tags);
-    void Store(const wxString& sql, const std::vector<TagEntryPtr>& tags);
-    void Store(const wxString& sql, const wxArrayString& kind, const std::vector<TagEntryPtr>& tags);
+    /**
+     * @brief store the result of 'sql', 'records' are indexes in GetRecords()
+     */
+    void Store(const wxString& sql, const std::vector<uint32_t>& records);
+    void Store(const wxString& sql, const wxArrayString& kind, const std::vector<uint32_t>& records);
+    TagRecordTable& GetRecords() { return m_records; }
+    bool GetTypes(const wxString& name, TypeInfoVec_t& types) const;
+    void StoreTypes(const wxString& name, const TypeInfoVec_t& types);
     void Clear();
 };
 
@@ -149,6 +173,17 @@ private:
      */
     void DoFetchTags(const wxString& sql, std::vector<TagEntryPtr>& tags, const wxArrayString& kinds);
 
+    /**
+     * @brief fetch the scope, kind and parent of all the types (class, struct, cenum, typedef) named 'name'
+     */
+    void DoFetchTypes(const wxString& name, TagsStorageSQLiteCache::TypeInfoVec_t& types);
+
+    /**
+     * @brief add the current row of 'rs' to the cache records (unless a record with the same ID is already there)
+     * and return its index
+     */
+    uint32_t DoAddCacheRecord(wxSQLite3ResultSet& rs);
+
     void DoAddNamePartToQuery(wxString& sql, const wxString& name, bool partial, bool prependAnd);
     void DoAddLimitPartToQuery(wxString& sql, const std::vector<TagEntryPtr>& tags);
     int DoInsertTagEntry(const TagEntry& tag);
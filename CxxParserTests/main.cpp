@@ -1,5 +1,9 @@
+#include "CxxIncrementalLexer.h"
+#include "CxxScopeCache.h"
 #include "CxxTokenizer.h"
 #include "CxxVariableScanner.h"
+#include "StringUtils.h"
+#include "TagRecordTable.h"
 #include "ctags_manager.h"
 #include "fileutils.h"
 #include "tester.h"
@@ -7,6 +11,9 @@
 #include <stdio.h>
 #include <wx/init.h>
 #include <wx/log.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
 
 TEST_FUNC(test_cxx_normalize_signature)
 {
@@ -188,6 +195,261 @@ TEST_FUNC(test_local_in_std_for_each)
     return true;
 }
 
+static bool SameTokens(const CxxLexerToken::Vect_t& a, const CxxLexerToken::Vect_t& b)
+{
+    if(a.size() != b.size()) { return false; }
+    for(size_t i = 0; i < a.size(); ++i) {
+        if((a[i].GetType() != b[i].GetType()) || (a[i].GetLineNumber() != b[i].GetLineNumber()) ||
+           (a[i].GetColumn() != b[i].GetColumn()) || (a[i].GetWXString() != b[i].GetWXString())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST_FUNC(test_incremental_lexer)
+{
+    wxString buffer;
+    for(size_t i = 0; i < 200; ++i) {
+        buffer << "int func" << i << "(int a) {\n    return a + " << i << ";\n}\n#define MACRO" << i << " 1\n";
+    }
+    CxxIncrementalLexer lexer;
+    lexer.Update(buffer);
+
+    // edit a single line: only the lines around it are lexed again
+    buffer.Replace("return a + 100;", "int b = a;\n    return b + 100;");
+    lexer.Update(buffer);
+    CxxIncrementalLexer fullLexer;
+    fullLexer.Update(buffer);
+    CHECK_BOOL(SameTokens(lexer.GetTokens(), fullLexer.GetTokens()));
+    CHECK_BOOL(lexer.GetLinesLexed() < 100);
+
+    // open a comment: the rest of the file is lexed again
+    buffer.Replace("return a + 150;", "/* return a + 150;");
+    lexer.Update(buffer);
+    fullLexer.Clear();
+    fullLexer.Update(buffer);
+    CHECK_BOOL(SameTokens(lexer.GetTokens(), fullLexer.GetTokens()));
+    return true;
+}
+
+static CxxLexerToken::Vect_t LexTokens(Scanner_t scanner)
+{
+    CxxLexerToken::Vect_t tokens;
+    while(true) {
+        CxxLexerToken token;
+        if(!::LexerNext(scanner, token)) { break; }
+        tokens.push_back(token);
+    }
+    return tokens;
+}
+
+TEST_FUNC(test_lexer_resume_state)
+{
+    wxString buffer;
+    for(size_t i = 0; i < 50; ++i) {
+        buffer << "int func" << i << "(int a) {\n    return a + " << i << ";\n}\n";
+    }
+    Scanner_t scanner = ::LexerNew(buffer, kLexerOpt_None);
+    ::LexerSetCheckpointInterval(scanner, 10);
+    CxxLexerToken::Vect_t fullTokens = LexTokens(scanner);
+    CxxLexerState::Vec_t checkpoints = ::LexerGetUserData(scanner)->GetCheckpoints();
+    ::LexerDestroy(&scanner);
+    CHECK_BOOL(checkpoints.size() > 1);
+
+    // resume from a checkpoint in the middle of the buffer: the tokens must have the same line and column as in
+    // the full scan
+    const CxxLexerState& state = checkpoints[checkpoints.size() / 2];
+    size_t offset = 0;
+    for(int line = 0; line < state.lineNumber; ++line) {
+        offset = buffer.find('\n', offset) + 1;
+    }
+    scanner = ::LexerNew(buffer.Mid(offset), kLexerOpt_None, state);
+    CxxLexerToken::Vect_t resumedTokens = LexTokens(scanner);
+    ::LexerDestroy(&scanner);
+    CxxLexerToken::Vect_t tailTokens(fullTokens.begin() + state.tokenIndex, fullTokens.end());
+    CHECK_BOOL(SameTokens(resumedTokens, tailTokens));
+    return true;
+}
+
+TEST_FUNC(test_scope_cache)
+{
+    wxString prefix = "int a;\nvoid foo() {\n    int b;\n}\nvoid bar() {\n    int c;\n";
+    CxxScopeCache::Analysis analysis;
+    CxxScopeCache::Get().GetAnalysis("test_scope_cache.cpp", prefix, wxStringTable_t(), analysis);
+
+    // typing inside bar() only scans bar(), the result must match a full scan
+    wxString text = prefix + "    int d;\n    if(c) {\n";
+    CxxScopeCache::Get().GetAnalysis("test_scope_cache.cpp", text, wxStringTable_t(), analysis);
+    wxString scope;
+    CHECK_BOOL(Language::DoOptimizeScope(text, scope));
+    CHECK_WXSTRING(analysis.m_optimizedScope, scope);
+
+    CxxVariableScanner scanner(analysis.m_visibleScope, eCxxStandard::kCxx11, wxStringTable_t(), false);
+    CxxVariable::Map_t vars = scanner.GetVariablesMap(true);
+    CHECK_BOOL(vars.count("d") == 1);
+    CHECK_BOOL(vars.count("c") == 1);
+    CHECK_BOOL(vars.count("b") == 0);
+    return true;
+}
+
+TEST_FUNC(test_scope_cache_namespace)
+{
+    wxString prefix = "namespace a {\nint x;\nvoid foo() {\n    int b;\n}\nvoid bar() {\n    int c;\n";
+    CxxScopeCache::Analysis analysis;
+    CxxScopeCache::Get().GetAnalysis("test_scope_cache_namespace.cpp", prefix, wxStringTable_t(), analysis);
+
+    // the functions of a namespace are at the top level, the result must match a full scan
+    wxString text = prefix + "    int d;\n    if(c) {\n";
+    CxxScopeCache::Get().GetAnalysis("test_scope_cache_namespace.cpp", text, wxStringTable_t(), analysis);
+    wxString scope;
+    CHECK_BOOL(Language::DoOptimizeScope(text, scope));
+    CHECK_WXSTRING(analysis.m_optimizedScope, scope);
+
+    CxxVariableScanner scanner(analysis.m_visibleScope, eCxxStandard::kCxx11, wxStringTable_t(), false);
+    CxxVariable::Map_t vars = scanner.GetVariablesMap(true);
+    CHECK_BOOL(vars.count("x") == 1);
+    CHECK_BOOL(vars.count("d") == 1);
+    CHECK_BOOL(vars.count("b") == 0);
+
+    // closing the namespace after the cached prefix
+    text = prefix + "}\n}\nvoid baz() {\n";
+    CxxScopeCache::Get().GetAnalysis("test_scope_cache_namespace.cpp", text, wxStringTable_t(), analysis);
+    CHECK_BOOL(Language::DoOptimizeScope(text, scope));
+    CHECK_WXSTRING(analysis.m_optimizedScope, scope);
+
+    CxxVariableScanner scanner2(analysis.m_visibleScope, eCxxStandard::kCxx11, wxStringTable_t(), false);
+    vars = scanner2.GetVariablesMap(true);
+    CHECK_BOOL(vars.count("x") == 0);
+    CHECK_BOOL(vars.count("c") == 0);
+    return true;
+}
+
+TEST_FUNC(test_regex_required_literal)
+{
+    CHECK_WXSTRING(StringUtils::GetRegexRequiredLiteral("undefined reference to"), "undefined reference to");
+    CHECK_WXSTRING(StringUtils::GetRegexRequiredLiteral("(In file included from *)([a-zA-Z:]{0,2})"),
+                   "In file included from");
+    CHECK_WXSTRING(StringUtils::GetRegexRequiredLiteral("a\\.b(c)?"), "a.b");
+
+    // bracket expressions: escapes and a leading ']' do not end them
+    CHECK_WXSTRING(StringUtils::GetRegexRequiredLiteral("[^\\]]foo"), "foo");
+    CHECK_WXSTRING(StringUtils::GetRegexRequiredLiteral("[\\]]+: error"), ": error");
+    CHECK_WXSTRING(StringUtils::GetRegexRequiredLiteral("[]x]bar"), "bar");
+    CHECK_WXSTRING(StringUtils::GetRegexRequiredLiteral("[^]x]bar"), "bar");
+    CHECK_WXSTRING(StringUtils::GetRegexRequiredLiteral("[[:alpha:]]+ warning:"), " warning:");
+    CHECK_WXSTRING(StringUtils::GetRegexRequiredLiteral("\\*\\*\\* \\[[a-zA-Z\\-_0-9 ]+\\] (Error)"), "*** [");
+
+    // no literal can be determined
+    CHECK_WXSTRING(StringUtils::GetRegexRequiredLiteral("foo|bar"), "");
+    CHECK_WXSTRING(StringUtils::GetRegexRequiredLiteral("abc[^\\]"), "");
+    CHECK_WXSTRING(StringUtils::GetRegexRequiredLiteral("abc[[:alpha"), "");
+    CHECK_WXSTRING(StringUtils::GetRegexRequiredLiteral("x)y"), "");
+    return true;
+}
+
+// Bytes currently allocated on the heap, 0 when it can not be measured
+static size_t GetHeapUsage()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    return mallinfo2().uordblks;
+#elif defined(__GLIBC__)
+    return (unsigned int)mallinfo().uordblks;
+#else
+    return 0;
+#endif
+}
+
+TEST_FUNC(test_tag_record_table)
+{
+    static const char* kinds[] = { "class", "function", "prototype", "member", "macro", "externvar" };
+    static const char* access[] = { "public", "protected", "private", "" };
+    const size_t count = 20000;
+
+    std::vector<TagRecordTable::Columns> rows;
+    rows.reserve(count);
+    for(size_t i = 0; i < count; ++i) {
+        TagRecordTable::Columns columns;
+        columns.id = i + 1;
+        columns.name << "Name" << i;
+        columns.file << "/home/user/project/src/File" << (i / 50) << ".h";
+        columns.line = i % 1000;
+        columns.kind = kinds[i % 6];
+        columns.access = access[i % 4];
+        columns.signature = (i % 2) ? "(const wxString& name, int flags)" : "";
+        columns.pattern << "/^    void Name" << i << "(const wxString& name, int flags);$/";
+        columns.parent << "Class" << (i / 50);
+        columns.inherits = "wxEvtHandler";
+        columns.path << "ns::Class" << (i / 50) << "::Name" << i;
+        columns.scope << "ns::Class" << (i / 50);
+        columns.returns = (i % 3) ? "void" : "bool";
+        rows.push_back(columns);
+    }
+
+    // the tags as TagsStorageSQLite::FromSQLite3ResultSet() creates them
+    size_t before = GetHeapUsage();
+    std::vector<TagEntryPtr> tags;
+    tags.reserve(count);
+    for(size_t i = 0; i < count; ++i) {
+        const TagRecordTable::Columns& columns = rows[i];
+        TagEntryPtr tag(new TagEntry());
+        tag->SetId(columns.id);
+        tag->SetName(columns.name);
+        tag->SetFile(columns.file);
+        tag->SetLine(columns.line);
+        tag->SetKind(columns.kind);
+        tag->SetAccess(columns.access);
+        tag->SetSignature(columns.signature);
+        tag->SetPattern(columns.pattern);
+        tag->SetParent(columns.parent);
+        tag->SetInherits(columns.inherits);
+        tag->SetPath(columns.path);
+        tag->SetTyperef(columns.typeref);
+        tag->SetScope(columns.scope);
+        tag->SetReturnValue(columns.returns);
+        tags.push_back(tag);
+    }
+    size_t tagsBytes = GetHeapUsage() - before;
+
+    before = GetHeapUsage();
+    TagRecordTable table;
+    for(size_t i = 0; i < count; ++i) {
+        table.Add(rows[i]);
+    }
+    size_t tableBytes = GetHeapUsage() - before;
+
+    // adding a tag with a known ID returns the existing record
+    CHECK_SIZE((int)table.Add(rows[10]), 10);
+    CHECK_SIZE((int)table.GetCount(), count);
+    CHECK_SIZE(table.Find(11), 10);
+    CHECK_SIZE(table.Find((int)count + 1), wxNOT_FOUND);
+    CHECK_BOOL(table.GetKind(0) == TagRecordTable::kKindClass);
+    CHECK_BOOL(table.GetKind(5) == TagRecordTable::kKindOther);
+    CHECK_BOOL(table.GetAccess(3) == TagRecordTable::kAccessNone);
+    CHECK_BOOL(table.GetFileId(49) == table.GetFileId(0));
+    CHECK_BOOL(table.GetFileId(50) != table.GetFileId(0));
+
+    bool same = true;
+    for(size_t i = 0; i < count && same; ++i) {
+        TagEntryPtr expected = tags[i];
+        TagEntryPtr tag = table.Get(i);
+        same = tag->GetId() == expected->GetId() && tag->GetName() == expected->GetName() &&
+               tag->GetFile() == expected->GetFile() && tag->GetLine() == expected->GetLine() &&
+               tag->GetKind() == expected->GetKind() && tag->GetAccess() == expected->GetAccess() &&
+               tag->GetSignature() == expected->GetSignature() && tag->GetPattern() == expected->GetPattern() &&
+               tag->GetParent() == expected->GetParent() &&
+               tag->GetInheritsAsString() == expected->GetInheritsAsString() &&
+               tag->GetPath() == expected->GetPath() && tag->GetTyperef() == expected->GetTyperef() &&
+               tag->GetScope() == expected->GetScope() && tag->GetReturnValue() == expected->GetReturnValue();
+    }
+    CHECK_BOOL(same);
+
+    wxFprintf(stderr, "TagRecordTable: %d bytes per tag (estimated %d), TagEntry: %d bytes per tag\n",
+              (int)(tableBytes / count), (int)(table.GetMemoryUsage() / count), (int)(tagsBytes / count));
+    if(tagsBytes && tableBytes) { CHECK_BOOL(tableBytes < tagsBytes); }
+    return true;
+}
+
 int main(int argc, char** argv)
 {
     wxInitializer initializer(argc, argv);
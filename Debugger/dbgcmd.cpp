@@ -1382,6 +1382,23 @@ bool DbgVarObjUpdate::ProcessOutput(const wxString& line)
 
         } else if(in_scope == wxT("true")) {
             e.m_varObjUpdateInfo.refreshIds.Add(name);
+
+            // Keep the value reported by gdb (-var-update --all-values) so the views won't have to evaluate it again
+            wxString value = ExtractGdbChild(info.children.at(i), wxT("value"));
+            value.Trim().Trim(false);
+            if(!value.IsEmpty() && value != wxT("{...}")) {
+                e.m_varObjUpdateInfo.values[name] = value;
+
+                // Notify about the new value just like DbgCmdEvalVarObj does
+                DebuggerEventData evalData;
+                evalData.m_updateReason = DBG_UR_EVALVARIABLEOBJ;
+                evalData.m_expression = name;
+                evalData.m_evaluated = value;
+                evalData.m_userReason = m_userReason;
+                clCommandEvent evtEvaluated(wxEVT_DEBUGGER_VAROBJ_EVALUATED);
+                evtEvaluated.SetClientObject(new DebuggerEventData(evalData));
+                EventNotifier::Get()->AddPendingEvent(evtEvaluated);
+            }
         }
     }
     e.m_updateReason = DBG_UR_VAROBJUPDATE;
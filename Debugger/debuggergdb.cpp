@@ -345,7 +345,7 @@ void DbgGdb::DoCleanup()
     SetIsRemoteDebugging(false);
     SetIsRemoteExtended(false);
     EmptyQueue();
-    m_gdbOutputArr.Clear();
+    m_gdbOutputArr.clear();
     m_bpList.clear();
     m_debuggeeProjectName.Clear();
 
@@ -663,24 +663,29 @@ bool DbgGdb::FilterMessage(const wxString& msg)
 
 void DbgGdb::Poke()
 {
-    static wxRegEx reCommand(wxT("^([0-9]{8})"));
-
     // poll the debugger output
     wxString curline;
-    if(!m_gdbProcess || m_gdbOutputArr.IsEmpty()) { return; }
+    if(!m_gdbProcess || m_gdbOutputArr.empty()) { return; }
 
     while(DoGetNextLine(curline)) {
 
         GetDebugeePID(curline);
 
-        // For string manipulations without damaging the original line read
-        wxString tmpline(curline);
-        StripString(tmpline);
-        tmpline.Trim().Trim(false);
+        // Is this a shell line? (i.e. a line that once stripped, starts with ">")
+        // Stripping is expensive for large records, so we only do it when the line contains a ">"
+        bool isShellLine = false;
+        if(curline.Find(wxT('>')) != wxNOT_FOUND) {
+            // For string manipulations without damaging the original line read
+            wxString tmpline(curline);
+            StripString(tmpline);
+            tmpline.Trim().Trim(false);
+            isShellLine = tmpline.StartsWith(wxT(">"));
+        }
+
         if(m_info.enableDebugLog) {
             // Is logging enabled?
 
-            if(curline.IsEmpty() == false && !tmpline.StartsWith(wxT(">"))) {
+            if(curline.IsEmpty() == false && !isShellLine) {
                 wxString strdebug(wxT("DEBUG>>"));
                 strdebug << curline;
                 clDEBUG() << strdebug << clEndl;
@@ -688,7 +693,7 @@ void DbgGdb::Poke()
             }
         }
 
-        if(reConnectionRefused.Matches(curline)) {
+        if(curline.Contains(wxT("refused")) && reConnectionRefused.Matches(curline)) {
             StripString(curline);
 #ifdef __WXGTK__
             m_consoleFinder.FreeConsole();
@@ -710,7 +715,7 @@ void DbgGdb::Poke()
             return;
         }
 
-        if(tmpline.StartsWith(wxT(">"))) {
+        if(isShellLine) {
             // Shell line, probably user command line
             continue;
         }
@@ -744,10 +749,10 @@ void DbgGdb::Poke()
                 m_observer->UpdateAddLine(curline);
             }
 
-        } else if(reCommand.Matches(curline)) {
+        } else if(IsCommandReply(curline)) {
 
             // not a gdb message, get the command associated with the message
-            wxString id = reCommand.GetMatch(curline, 1);
+            wxString id = curline.Mid(0, 8);
 
             if(GetCliHandler() && GetCliHandler()->GetCommandId() == id) {
                 // probably the "^done" message of the CLI command
@@ -1159,31 +1164,31 @@ void DbgGdb::OnDataRead(clProcessEvent& e)
     if(!m_gdbProcess || !m_gdbProcess->IsAlive()) return;
 
     clDEBUG() << "GDB>>" << bufferRead;
-    wxArrayString lines = wxStringTokenize(bufferRead, "\n", wxTOKEN_STRTOK);
-    if(lines.IsEmpty()) { return; }
-
-    // Prepend the partially saved line from previous iteration to the first line
-    // of this iteration
-    if(!m_gdbOutputIncompleteLine.empty()) {
-        lines.Item(0).Prepend(m_gdbOutputIncompleteLine);
-        m_gdbOutputIncompleteLine.Clear();
-    }
 
-    // If the last line is in-complete, remove it from the array and keep it for next iteration
-    if(!bufferRead.EndsWith(wxT("\n"))) {
-        m_gdbOutputIncompleteLine = lines.Last();
-        lines.RemoveAt(lines.GetCount() - 1);
-    }
+    // Split the buffer into lines in a single pass. The first line is prepended with the partial line
+    // saved from the previous iteration, and an incomplete last line is kept for the next one
+    size_t start = 0;
+    while(start < bufferRead.length()) {
+        size_t end = bufferRead.find(wxT('\n'), start);
+        if(end == wxString::npos) {
+            // In-complete line, keep it for next iteration
+            m_gdbOutputIncompleteLine << bufferRead.Mid(start);
+            break;
+        }
 
-    for(size_t i = 0; i < lines.GetCount(); ++i) {
-        wxString& line = lines.Item(i);
+        wxString line = bufferRead.Mid(start, end - start);
+        start = end + 1;
+        if(!m_gdbOutputIncompleteLine.empty()) {
+            line.Prepend(m_gdbOutputIncompleteLine);
+            m_gdbOutputIncompleteLine.Clear();
+        }
 
         line.Replace(wxT("(gdb)"), wxT(""));
         line.Trim().Trim(false);
-        if(line.IsEmpty() == false) { m_gdbOutputArr.Add(line); }
+        if(line.IsEmpty() == false) { m_gdbOutputArr.push_back(line); }
     }
 
-    if(m_gdbOutputArr.IsEmpty() == false) {
+    if(m_gdbOutputArr.empty() == false) {
         // Trigger GDB processing
         Poke();
     }
@@ -1191,13 +1196,21 @@ void DbgGdb::OnDataRead(clProcessEvent& e)
 
 bool DbgGdb::DoGetNextLine(wxString& line)
 {
+    // The lines are already cleaned up by OnDataRead()
     line.Clear();
-    if(m_gdbOutputArr.IsEmpty()) { return false; }
-    line = m_gdbOutputArr.Item(0);
-    m_gdbOutputArr.RemoveAt(0);
-    line.Replace(wxT("(gdb)"), wxT(""));
-    line.Trim().Trim(false);
-    if(line.IsEmpty()) { return false; }
+    if(m_gdbOutputArr.empty()) { return false; }
+    line.swap(m_gdbOutputArr.front());
+    m_gdbOutputArr.pop_front();
+    return !line.IsEmpty();
+}
+
+bool DbgGdb::IsCommandReply(const wxString& line) const
+{
+    // Replies to our commands are prefixed with the 8 digits command ID
+    if(line.length() < 8) { return false; }
+    for(size_t i = 0; i < 8; ++i) {
+        if(line[i] < '0' || line[i] > '9') { return false; }
+    }
     return true;
 }
 
@@ -1233,18 +1246,17 @@ bool DbgGdb::SetVariableObbjectDisplayFormat(const wxString& name, DisplayFormat
 
 bool DbgGdb::UpdateVariableObject(const wxString& name, int userReason)
 {
-    // FIXME: this seems to cause a mess in gdb output, disable it for now
-
-    // wxString cmd;
-    // cmd << wxT("-var-update \"") << name << wxT("\" ");
-    // return WriteCommand(cmd, new DbgVarObjUpdate(m_observer, this, name, userReason));
-    return true;
+    // Only the variable objects that changed since the last update are reported back by gdb, and thanks to
+    // --all-values we get their new values as well, so there is no need to evaluate each of them afterwards
+    wxString cmd;
+    cmd << wxT("-var-update --all-values \"") << name << wxT("\"");
+    return WriteCommand(cmd, new DbgVarObjUpdate(m_observer, this, name, userReason));
 }
 
 bool DbgGdb::UpdateWatch(const wxString& name)
 {
     wxString cmd;
-    cmd << wxT("-var-update ") << name;
+    cmd << wxT("-var-update --all-values \"") << name << wxT("\"");
     return WriteCommand(cmd, new DbgVarObjUpdate(m_observer, this, name, DBG_USERR_WATCHTABLE));
 }
 
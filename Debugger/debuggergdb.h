@@ -28,6 +28,7 @@
 #include "wx/string.h"
 #include "wx/event.h"
 #include "list"
+#include <deque>
 #include "debugger.h"
 #include <wx/hashmap.h>
 #include "consolefinder.h"
@@ -63,7 +64,7 @@ class DbgGdb : public wxEvtHandler, public IDebugger
     std::vector<BreakpointInfo> m_bpList;
     DbgCmdCLIHandler* m_cliHandler;
     IProcess* m_gdbProcess;
-    wxArrayString m_gdbOutputArr;
+    std::deque<wxString> m_gdbOutputArr;
     wxString m_gdbOutputIncompleteLine;
     bool m_break_at_main;
     bool m_attachedMode;
@@ -81,6 +82,7 @@ protected:
     void EmptyQueue();
     bool FilterMessage(const wxString& msg);
     bool DoGetNextLine(wxString& line);
+    bool IsCommandReply(const wxString& line) const;
     void DoCleanup();
 
     // wrapper for convinience
@@ -147,6 +147,7 @@ struct LocalVariable {
 struct VariableObjectUpdateInfo {
     wxArrayString removeIds;
     wxArrayString refreshIds;
+    wxStringMap_t values; // gdbId -> new value, for the refreshed items the debugger already reported a value for
 };
 
 struct DisassembleEntry {
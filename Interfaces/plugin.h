@@ -194,6 +194,14 @@ public:
         wxUnusedVar(projectName);
         wxUnusedVar(configName);
     }
+
+    /**
+     * @brief called once from a worker thread, after all the plugins were loaded and the main frame is shown.
+     * Override this method to move initialisation that does not touch the UI (loading data files,
+     * scanning folders etc) out of the startup path. Use CallAfter() or events to pass the results back
+     * to the main thread
+     */
+    virtual void InitialiseInBackground() {}
 };
 
 #define CHECK_CL_SHUTDOWN()                       \
@@ -28,6 +28,8 @@
 
 // Interface version is calcualted as follows: MAJOR * 1000 + MINOR * 100, e.g. codelite 4.1 => 4100, codelite 5.0 =>
 // 5000
-#define PLUGIN_INTERFACE_VERSION 14000 // CodeLite 14
+// 14100: the layout of SearchResult and VariableObjectUpdateInfo changed and IPlugin::InitialiseInBackground() was
+// added
+#define PLUGIN_INTERFACE_VERSION 14100 // CodeLite 14.1
 
 #endif // PLUGIN_VERSION_H
@@ -0,0 +1,187 @@
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright            : (C) 2020 Eran Ifrah
+// File name            : BuildOutputParserThread.cpp
+//
+// -------------------------------------------------------------------------
+// A
+//              _____           _      _     _ _
+//             /  __ \         | |    | |   (_) |
+//             | /  \/ ___   __| | ___| |    _| |_ ___
+//             | |    / _ \ / _  |/ _ \ |   | | __/ _ )
+//             | \__/\ (_) | (_| |  __/ |___| | ||  __/
+//              \____/\___/ \__,_|\___\_____/_|\__\___|
+//
+//                                                  F i l e
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+
+#include "BuildOutputParserThread.h"
+#include "clPerfTrace.h"
+#include "file_logger.h"
+#include "globals.h"
+#include "macros.h"
+
+BuildOutputParserThread::BuildOutputParserThread(NewBuildTab* owner)
+    : m_owner(owner)
+    , m_hasCompiler(false)
+    , m_generation(0)
+{
+}
+
+BuildOutputParserThread::~BuildOutputParserThread() {}
+
+void BuildOutputParserThread::ProcessRequest(ThreadRequest* request)
+{
+    StartRequest* startReq = dynamic_cast<StartRequest*>(request);
+    if(startReq) {
+        DoStart(startReq);
+        return;
+    }
+
+    OutputRequest* outputReq = dynamic_cast<OutputRequest*>(request);
+    CHECK_PTR_RET(outputReq);
+    DoProcessOutput(outputReq);
+}
+
+void BuildOutputParserThread::DoStart(StartRequest* req)
+{
+    CL_TRACE_THREAD_NAME("Build Output Parser");
+    if(req->clear || req->generation != m_generation) {
+        m_directories.Clear();
+        m_partialLine.Clear();
+    }
+    m_generation = req->generation;
+    m_cygwinRoot = req->cygwinRoot;
+
+    // wxRegEx can not be shared between threads: this thread compiles its own copy of the patterns
+    m_patterns.errorsPatterns.clear();
+    m_patterns.warningPatterns.clear();
+    m_hasCompiler = req->hasCompiler;
+    NewBuildTab::CompilePatterns(req->errPatterns, SV_ERROR, m_patterns.errorsPatterns);
+    NewBuildTab::CompilePatterns(req->warnPatterns, SV_WARNING, m_patterns.warningPatterns);
+}
+
+void BuildOutputParserThread::DoProcessOutput(OutputRequest* req)
+{
+    if(req->generation != m_generation) {
+        // the view was cleared since the output of the previous request
+        m_directories.Clear();
+        m_partialLine.Clear();
+        m_generation = req->generation;
+    }
+
+    m_partialLine << req->output;
+    if(!req->buildEnded && m_partialLine.Find(wxT("\n")) == wxNOT_FOUND) {
+        // still dont have a complete line
+        return;
+    }
+
+    CL_TRACE_SCOPE("build", "BuildOutputParserThread::DoProcessOutput");
+    wxArrayString lines = ::wxStringTokenize(m_partialLine, wxT("\n"), wxTOKEN_RET_DELIMS);
+    m_partialLine.Clear();
+
+    BuildOutputBatchPtr batch(new BuildOutputBatch());
+    batch->generation = req->generation;
+    batch->buildEnded = req->buildEnded;
+    batch->lines.reserve(lines.GetCount());
+
+    // Process only completed lines (i.e. a line that ends with '\n')
+    for(size_t i = 0; i < lines.GetCount(); ++i) {
+        if(!req->buildEnded && !lines.Item(i).EndsWith(wxT("\n"))) {
+            m_partialLine << lines.Item(i);
+            break;
+        }
+
+        wxString buildLine = lines.Item(i);
+        // If this is a line similar to 'Entering directory `'
+        // add the path in the directories array
+        DoSearchForDirectory(buildLine);
+        batch->lines.push_back(DoProcessLine(buildLine));
+
+        buildLine.Trim();
+        wxString modText;
+        ::clStripTerminalColouring(buildLine, modText);
+
+        // Every entry must be exactly one line of the view, so its line number can be computed from its position in
+        // the batch. The view treats a lone '\r' as a line break: keep what a terminal would show, the text written
+        // after the last carriage return
+        if(modText.Contains(wxT("\r"))) { modText = modText.AfterLast(wxT('\r')); }
+        if(modText.length() > batch->longestLine.length()) { batch->longestLine = modText; }
+        batch->text << modText << "\n";
+    }
+
+    if(batch->lines.empty() && !batch->buildEnded) { return; }
+    CL_TRACE_COUNTER("build", "Build output lines", batch->lines.size());
+    m_owner->CallAfter(&NewBuildTab::OnBuildOutputParsed, batch);
+}
+
+void BuildOutputParserThread::DoSearchForDirectory(const wxString& line)
+{
+    // Check for makefile directory changes lines
+    if(line.Contains(wxT("Entering directory `"))) {
+        wxString currentDir = line.AfterFirst(wxT('`'));
+        currentDir = currentDir.BeforeLast(wxT('\''));
+
+        // Collect the m_baseDir
+        m_directories.Add(currentDir);
+
+    } else if(line.Contains(wxT("Entering directory '"))) {
+        wxString currentDir = line.AfterFirst(wxT('\''));
+        currentDir = currentDir.BeforeLast(wxT('\''));
+
+        // Collect the m_baseDir
+        m_directories.Add(currentDir);
+    }
+}
+
+BuildLineInfo* BuildOutputParserThread::DoProcessLine(const wxString& line)
+{
+    BuildLineInfo* buildLineInfo = new BuildLineInfo();
+    LINE_SEVERITY severity;
+    // Get the matching regex for this line
+    BuildLineInfo bli;
+    CmpPatternPtr cmpPatterPtr =
+        NewBuildTab::MatchPatterns(m_hasCompiler ? &m_patterns : nullptr, line, severity, &bli);
+    buildLineInfo->SetSeverity(severity);
+    if(cmpPatterPtr) {
+        buildLineInfo->SetFilename(bli.GetFilename());
+        buildLineInfo->SetSeverity(bli.GetSeverity());
+        buildLineInfo->SetLineNumber(bli.GetLineNumber());
+        buildLineInfo->NormalizeFilename(m_directories, m_cygwinRoot);
+        buildLineInfo->SetRegexLineMatch(bli.GetRegexLineMatch());
+        buildLineInfo->SetColumn(bli.GetColumn());
+    }
+    return buildLineInfo;
+}
+
+void BuildOutputParserThread::QueueStart(size_t generation, bool clear, CompilerPtr compiler,
+                                         const wxString& cygwinRoot)
+{
+    StartRequest* req = new StartRequest();
+    req->generation = generation;
+    req->clear = clear;
+    req->cygwinRoot = cygwinRoot;
+    if(compiler) {
+        req->hasCompiler = true;
+        req->errPatterns = compiler->GetErrPatterns();
+        req->warnPatterns = compiler->GetWarnPatterns();
+    }
+    Add(req);
+}
+
+void BuildOutputParserThread::QueueOutput(size_t generation, const wxString& output, bool buildEnded)
+{
+    OutputRequest* req = new OutputRequest();
+    req->generation = generation;
+    req->output = output;
+    req->buildEnded = buildEnded;
+    Add(req);
+}
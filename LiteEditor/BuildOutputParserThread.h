@@ -0,0 +1,133 @@
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright            : (C) 2020 Eran Ifrah
+// File name            : BuildOutputParserThread.h
+//
+// -------------------------------------------------------------------------
+// A
+//              _____           _      _     _ _
+//             /  __ \         | |    | |   (_) |
+//             | /  \/ ___   __| | ___| |    _| |_ ___
+//             | |    / _ \ / _  |/ _ \ |   | | __/ _ )
+//             | \__/\ (_) | (_| |  __/ |___| | ||  __/
+//              \____/\___/ \__,_|\___\_____/_|\__\___|
+//
+//                                                  F i l e
+//
+//    This program is free software; you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation; either version 2 of the License, or
+//    (at your option) any later version.
+//
+//////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef BUILDOUTPUTPARSERTHREAD_H
+#define BUILDOUTPUTPARSERTHREAD_H
+
+#include "compiler.h"
+#include "new_build_tab.h"
+#include "worker_thread.h" // Base class: WorkerThread
+#include <vector>
+#include <wx/sharedptr.h>
+
+/**
+ * @class BuildOutputBatch
+ * @brief the build output lines parsed by the BuildOutputParserThread since the previous batch. Every line of 'text'
+ * has its entry in 'lines', in the same order
+ */
+struct BuildOutputBatch {
+    size_t generation;
+    bool buildEnded; // the last batch of the build
+    wxString text;
+    wxString longestLine;
+    std::vector<BuildLineInfo*> lines;
+
+    BuildOutputBatch()
+        : generation(0)
+        , buildEnded(false)
+    {
+    }
+
+    // The lines not taken by the build tab (e.g. the batch of a cleared build)
+    ~BuildOutputBatch()
+    {
+        for(size_t i = 0; i < lines.size(); ++i) {
+            wxDELETE(lines[i]);
+        }
+    }
+};
+typedef wxSharedPtr<BuildOutputBatch> BuildOutputBatchPtr;
+
+/**
+ * @class BuildOutputParserThread
+ * @brief splits the build output into lines and matches them against the compiler patterns, away from the main
+ * thread. The parsed lines are passed to NewBuildTab::OnBuildOutputParsed()
+ */
+class BuildOutputParserThread : public WorkerThread
+{
+public:
+    struct StartRequest : public ThreadRequest {
+        size_t generation;
+        bool clear; // a new build: forget the directories of the previous builds
+        bool hasCompiler;
+        Compiler::CmpListInfoPattern errPatterns;
+        Compiler::CmpListInfoPattern warnPatterns;
+        wxString cygwinRoot;
+
+        StartRequest()
+            : generation(0)
+            , clear(true)
+            , hasCompiler(false)
+        {
+        }
+    };
+
+    struct OutputRequest : public ThreadRequest {
+        size_t generation;
+        wxString output;
+        bool buildEnded; // the last line is complete even if it does not end with '\n'
+
+        OutputRequest()
+            : generation(0)
+            , buildEnded(false)
+        {
+        }
+    };
+
+protected:
+    NewBuildTab* m_owner;
+    CmpPatterns m_patterns;
+    bool m_hasCompiler;
+    wxArrayString m_directories;
+    wxString m_cygwinRoot;
+    wxString m_partialLine; // the output received after the last '\n'
+    size_t m_generation;
+
+protected:
+    void DoStart(StartRequest* req);
+    void DoProcessOutput(OutputRequest* req);
+    void DoSearchForDirectory(const wxString& line);
+    BuildLineInfo* DoProcessLine(const wxString& line);
+
+public:
+    BuildOutputParserThread(NewBuildTab* owner);
+    virtual ~BuildOutputParserThread();
+
+public:
+    virtual void ProcessRequest(ThreadRequest* request);
+
+    /**
+     * @brief a build started, parse its output with the patterns of 'compiler'
+     */
+    void QueueStart(size_t generation, bool clear, CompilerPtr compiler, const wxString& cygwinRoot);
+
+    /**
+     * @brief parse 'output'. When 'buildEnded' is true the output does not continue: a batch is always posted, even
+     * when it has no lines, so the build tab knows that all the output of the build was parsed
+     */
+    void QueueOutput(size_t generation, const wxString& output, bool buildEnded);
+};
+
+#endif // BUILDOUTPUTPARSERTHREAD_H
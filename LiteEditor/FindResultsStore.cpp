@@ -0,0 +1,164 @@
+#include "FindResultsStore.h"
+#include <algorithm>
+
+int FindResultsStore::StringPool::Add(const wxString& str)
+{
+    // consecutive matches usually come from the same file
+    if(!m_strings.empty() && (m_strings.back() == str)) { return (int)m_strings.size() - 1; }
+
+    std::unordered_map<wxString, int>::const_iterator iter = m_index.find(str);
+    if(iter != m_index.end()) { return iter->second; }
+
+    m_strings.push_back(str);
+    m_index.insert(std::make_pair(str, (int)m_strings.size() - 1));
+    return (int)m_strings.size() - 1;
+}
+
+void FindResultsStore::StringPool::Clear()
+{
+    m_strings.clear();
+    m_index.clear();
+}
+
+FindResultsStore::FindResultsStore()
+    : m_flags(0)
+{
+}
+
+FindResultsStore::~FindResultsStore() {}
+
+void FindResultsStore::Clear()
+{
+    // release the memory as well
+    std::vector<int>().swap(m_viewLines);
+    std::vector<Match>().swap(m_matches);
+    std::string().swap(m_patterns);
+    m_files.Clear();
+    std::vector<FileStamp>().swap(m_fileStamps);
+    m_scopes.Clear();
+    m_findWhat.clear();
+    m_flags = 0;
+}
+
+void FindResultsStore::DoSetMatch(Match& match, const SearchResult& result, const Match* shareWith)
+{
+    match.m_fileId = m_files.Add(result.GetFileName());
+    if(match.m_fileId >= (int)m_fileStamps.size()) { m_fileStamps.resize(match.m_fileId + 1); }
+    FileStamp& stamp = m_fileStamps[match.m_fileId];
+    stamp.m_size = result.GetFileSize();
+    stamp.m_modificationTime = result.GetFileModificationTime();
+    stamp.m_hash = result.GetFileHash();
+
+    match.m_scopeId = m_scopes.Add(result.GetScope());
+    match.m_lineNumber = result.GetLineNumber();
+    match.m_position = result.GetPosition();
+    match.m_column = result.GetColumn();
+    match.m_len = result.GetLen();
+    match.m_columnInChars = result.GetColumnInChars();
+    match.m_lenInChars = result.GetLenInChars();
+    match.m_matchState = result.GetMatchState();
+
+    const wxCharBuffer pattern = result.GetPattern().ToUTF8();
+    size_t patternLen = pattern.length();
+    if(shareWith && (shareWith->m_patternLen == patternLen) &&
+       (m_patterns.compare(shareWith->m_patternOffset, patternLen, pattern.data(), patternLen) == 0)) {
+        match.m_patternOffset = shareWith->m_patternOffset;
+        match.m_patternLen = patternLen;
+        return;
+    }
+    match.m_patternOffset = m_patterns.length();
+    match.m_patternLen = patternLen;
+    m_patterns.append(pattern.data(), patternLen);
+}
+
+void FindResultsStore::Add(const SearchResult& result, int viewLine)
+{
+    if(m_matches.empty()) {
+        // these are the same for all the matches of a search
+        m_findWhat = result.GetFindWhat();
+        m_flags = result.GetFlags();
+    }
+
+    // several matches on the same line share the same text
+    const Match* shareWith = NULL;
+    if(!m_matches.empty() && (m_matches.back().m_lineNumber == result.GetLineNumber())) {
+        shareWith = &m_matches.back();
+    }
+
+    Match match;
+    DoSetMatch(match, result, shareWith);
+    m_matches.push_back(match);
+    m_viewLines.push_back(viewLine);
+}
+
+void FindResultsStore::Update(size_t index, const SearchResult& result)
+{
+    if(index >= m_matches.size()) { return; }
+    Match match;
+    DoSetMatch(match, result, &m_matches[index]);
+    m_matches[index] = match;
+}
+
+void FindResultsStore::Erase(const std::vector<size_t>& indexes)
+{
+    if(indexes.empty()) { return; }
+
+    size_t next = 0;
+    size_t dest = 0;
+    for(size_t i = 0; i < m_matches.size(); ++i) {
+        if((next < indexes.size()) && (indexes[next] == i)) {
+            ++next;
+            continue;
+        }
+        m_matches[dest] = m_matches[i];
+        m_viewLines[dest] = m_viewLines[i];
+        ++dest;
+    }
+    m_matches.resize(dest);
+    m_viewLines.resize(dest);
+}
+
+SearchResult FindResultsStore::Get(size_t index) const
+{
+    SearchResult result;
+    const Match& match = m_matches[index];
+    result.SetFileName(m_files.Get(match.m_fileId));
+    const FileStamp& stamp = m_fileStamps[match.m_fileId];
+    result.SetFileStamp(stamp.m_size, stamp.m_modificationTime, stamp.m_hash);
+    result.SetScope(m_scopes.Get(match.m_scopeId));
+    result.SetLineNumber(match.m_lineNumber);
+    result.SetPosition(match.m_position);
+    result.SetColumn(match.m_column);
+    result.SetLen(match.m_len);
+    result.SetColumnInChars(match.m_columnInChars);
+    result.SetLenInChars(match.m_lenInChars);
+    result.SetMatchState(match.m_matchState);
+    result.SetPattern(wxString::FromUTF8(m_patterns.data() + match.m_patternOffset, match.m_patternLen));
+    result.SetFindWhat(m_findWhat);
+    result.SetFlags(m_flags);
+    return result;
+}
+
+size_t FindResultsStore::LowerBound(int viewLine) const
+{
+    return std::lower_bound(m_viewLines.begin(), m_viewLines.end(), viewLine) - m_viewLines.begin();
+}
+
+int FindResultsStore::Find(int viewLine) const
+{
+    size_t index = LowerBound(viewLine);
+    if((index == m_viewLines.size()) || (m_viewLines[index] != viewLine)) { return wxNOT_FOUND; }
+    return (int)index;
+}
+
+int FindResultsStore::FindNext(int viewLine) const
+{
+    size_t index = std::upper_bound(m_viewLines.begin(), m_viewLines.end(), viewLine) - m_viewLines.begin();
+    return (index == m_viewLines.size()) ? wxNOT_FOUND : (int)index;
+}
+
+int FindResultsStore::FindPrev(int viewLine) const
+{
+    size_t index = LowerBound(viewLine);
+    return (index == 0) ? wxNOT_FOUND : (int)index - 1;
+}
@@ -0,0 +1,131 @@
+#ifndef FINDRESULTSSTORE_H
+#define FINDRESULTSSTORE_H
+
+#include "search_thread.h"
+#include "wxStringHash.h"
+#include <string>
+#include <vector>
+#include <wx/string.h>
+
+/**
+ * @class FindResultsStore
+ * @brief a compact store for the matches displayed in the "Find In Files" view.
+ * Instead of keeping a SearchResult per match, the matches are kept in flat arrays: the file names and scopes are
+ * stored once and referenced by index, the matched lines are kept as UTF-8 in a single text arena (matches found on
+ * the same line share it) and the "find what" string and the search flags are kept once for the whole search.
+ * The matches are sorted by the line they are displayed on in the view
+ */
+class FindResultsStore
+{
+    /**
+     * @brief a list of unique strings, referenced by their index
+     */
+    class StringPool
+    {
+        std::vector<wxString> m_strings;
+        std::unordered_map<wxString, int> m_index;
+
+    public:
+        int Add(const wxString& str);
+        const wxString& Get(int index) const { return m_strings[index]; }
+        void Clear();
+    };
+
+    struct FileStamp {
+        size_t m_size;
+        time_t m_modificationTime;
+        size_t m_hash;
+    };
+
+    struct Match {
+        int m_fileId;
+        int m_scopeId;
+        int m_lineNumber;
+        int m_position;
+        int m_column;
+        int m_len;
+        int m_columnInChars;
+        int m_lenInChars;
+        short m_matchState;
+        size_t m_patternOffset;
+        size_t m_patternLen;
+    };
+
+    std::vector<int> m_viewLines; // kept apart from the matches: this is the column we search
+    std::vector<Match> m_matches;
+    std::string m_patterns;
+    StringPool m_files;
+    std::vector<FileStamp> m_fileStamps; // indexed by the file ID
+    StringPool m_scopes;
+    wxString m_findWhat;
+    size_t m_flags;
+
+protected:
+    /**
+     * @brief fill 'match' from 'result'. The line text of 'shareWith' is reused when it is the same
+     */
+    void DoSetMatch(Match& match, const SearchResult& result, const Match* shareWith);
+
+public:
+    FindResultsStore();
+    virtual ~FindResultsStore();
+
+    /**
+     * @brief remove all the matches
+     */
+    void Clear();
+
+    /**
+     * @brief add a match displayed at 'viewLine'. The matches must be added in the order of their view lines
+     */
+    void Add(const SearchResult& result, int viewLine);
+
+    /**
+     * @brief update the match at 'index' from 'result'. The view line is not modified. The file state
+     * (see SearchResult::SetFileStamp) is updated for all the matches of the file
+     */
+    void Update(size_t index, const SearchResult& result);
+
+    /**
+     * @brief remove the matches at the given indexes. 'indexes' must be sorted
+     */
+    void Erase(const std::vector<size_t>& indexes);
+
+    /**
+     * @brief return the match at 'index' as a SearchResult
+     */
+    SearchResult Get(size_t index) const;
+
+    /**
+     * @brief return the index of the match displayed at 'viewLine', or wxNOT_FOUND
+     */
+    int Find(int viewLine) const;
+
+    /**
+     * @brief return the index of the first match displayed after 'viewLine', or wxNOT_FOUND
+     */
+    int FindNext(int viewLine) const;
+
+    /**
+     * @brief return the index of the last match displayed before 'viewLine', or wxNOT_FOUND
+     */
+    int FindPrev(int viewLine) const;
+
+    /**
+     * @brief return the index of the first match displayed on 'viewLine' or after it. Returns GetCount() if there is
+     * no such match
+     */
+    size_t LowerBound(int viewLine) const;
+
+    size_t GetCount() const { return m_matches.size(); }
+    bool IsEmpty() const { return m_matches.empty(); }
+    int GetViewLine(size_t index) const { return m_viewLines[index]; }
+    void SetViewLine(size_t index, int viewLine) { m_viewLines[index] = viewLine; }
+    const wxString& GetFileName(size_t index) const { return m_files.Get(m_matches[index].m_fileId); }
+    int GetLineNumber(size_t index) const { return m_matches[index].m_lineNumber; }
+    int GetColumn(size_t index) const { return m_matches[index].m_column; }
+    int GetLen(size_t index) const { return m_matches[index].m_len; }
+    const wxString& GetFindWhat() const { return m_findWhat; }
+};
+
+#endif // FINDRESULTSSTORE_H
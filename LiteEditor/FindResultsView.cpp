@@ -0,0 +1,366 @@
+#include "FindResultsView.h"
+#include "globals.h"
+#include <algorithm>
+#include <wx/dcclient.h>
+#include <wx/filename.h>
+#include <wx/renderer.h>
+#include <wx/settings.h>
+
+#define ROW_PADDING 2
+
+FindResultsView::FindResultsView(wxWindow* parent, const FindResultsStore& store)
+    : wxVListBox(parent, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxBORDER_NONE)
+    , m_store(store)
+    , m_displayScope(false)
+    , m_lineHeight(16)
+    , m_buttonWidth(16)
+{
+    m_font = wxSystemSettings::GetFont(wxSYS_DEFAULT_GUI_FONT);
+    m_colours.bg = wxSystemSettings::GetColour(wxSYS_COLOUR_WINDOW);
+    m_colours.fg = wxSystemSettings::GetColour(wxSYS_COLOUR_WINDOWTEXT);
+    m_colours.header = m_colours.fg;
+    m_colours.file = m_colours.fg;
+    m_colours.lineNumber = m_colours.fg;
+    m_colours.scope = m_colours.fg;
+    m_colours.match = m_colours.fg;
+    m_colours.matchBg = wxColour("GOLD");
+
+    Bind(wxEVT_LEFT_DOWN, &FindResultsView::OnLeftDown, this);
+    Bind(wxEVT_KEY_DOWN, &FindResultsView::OnKeyDown, this);
+    SetItemCount(0);
+}
+
+FindResultsView::~FindResultsView()
+{
+    Unbind(wxEVT_LEFT_DOWN, &FindResultsView::OnLeftDown, this);
+    Unbind(wxEVT_KEY_DOWN, &FindResultsView::OnKeyDown, this);
+}
+
+void FindResultsView::Clear()
+{
+    m_groups.clear();
+    m_header.clear();
+    m_footer.Clear();
+    SetSelection(wxNOT_FOUND);
+    SetItemCount(0);
+}
+
+void FindResultsView::SetColours(const Colours& colours, const wxFont& font)
+{
+    m_colours = colours;
+    m_font = font;
+
+    wxClientDC dc(this);
+    dc.SetFont(m_font);
+    int textHeight = dc.GetCharHeight();
+    m_lineHeight = textHeight + 2 * ROW_PADDING;
+    m_buttonWidth = m_lineHeight;
+
+    SetBackgroundColour(m_colours.bg);
+    RefreshAll();
+}
+
+void FindResultsView::SetHeader(const wxString& header)
+{
+    m_header = header;
+    DoUpdateRows(0);
+    DoUpdateItemCount();
+}
+
+void FindResultsView::AddFooter(const wxString& line)
+{
+    m_footer.Add(line);
+    DoUpdateItemCount();
+}
+
+void FindResultsView::SetFooter(const wxArrayString& footer)
+{
+    m_footer = footer;
+    DoUpdateItemCount();
+}
+
+size_t FindResultsView::DoGetGroupsEndRow() const
+{
+    if(m_groups.empty()) { return m_header.IsEmpty() ? 0 : 1; }
+    const Group& last = m_groups.back();
+    return last.m_firstRow + 1 + (last.m_expanded ? last.m_count : 0);
+}
+
+void FindResultsView::DoUpdateRows(size_t fromGroup)
+{
+    for(size_t i = fromGroup; i < m_groups.size(); ++i) {
+        if(i == 0) {
+            m_groups[i].m_firstRow = m_header.IsEmpty() ? 0 : 1;
+        } else {
+            const Group& prev = m_groups[i - 1];
+            m_groups[i].m_firstRow = prev.m_firstRow + 1 + (prev.m_expanded ? prev.m_count : 0);
+        }
+    }
+}
+
+void FindResultsView::DoUpdateItemCount() { SetItemCount(DoGetGroupsEndRow() + m_footer.GetCount()); }
+
+void FindResultsView::MatchesAdded()
+{
+    size_t next = m_groups.empty() ? 0 : (m_groups.back().m_firstMatch + m_groups.back().m_count);
+    if(next >= m_store.GetCount()) { return; }
+
+    // only the last group and the groups created here move
+    size_t fromGroup = m_groups.empty() ? 0 : (m_groups.size() - 1);
+    for(size_t i = next; i < m_store.GetCount(); ++i) {
+        if(m_groups.empty() || (m_store.GetFileName(i) != m_store.GetFileName(m_groups.back().m_firstMatch))) {
+            Group group;
+            group.m_firstMatch = i;
+            group.m_count = 0;
+            group.m_firstRow = 0;
+            group.m_expanded = true;
+            m_groups.push_back(group);
+        }
+        m_groups.back().m_count++;
+    }
+    DoUpdateRows(fromGroup);
+    DoUpdateItemCount();
+}
+
+void FindResultsView::Rebuild()
+{
+    m_groups.clear();
+    SetSelection(wxNOT_FOUND);
+    MatchesAdded();
+    DoUpdateItemCount();
+}
+
+void FindResultsView::CollapseAll(bool expandFirst)
+{
+    if(m_groups.empty()) { return; }
+
+    bool expand = false;
+    if(!expandFirst) {
+        // expand all the files when all of them are already collapsed
+        expand = std::none_of(m_groups.begin(), m_groups.end(), [](const Group& g) { return g.m_expanded; });
+    }
+    for(size_t i = 0; i < m_groups.size(); ++i) {
+        m_groups[i].m_expanded = expand;
+    }
+    if(expandFirst) { m_groups[0].m_expanded = true; }
+
+    SetSelection(wxNOT_FOUND);
+    DoUpdateRows(0);
+    DoUpdateItemCount();
+    ScrollToRow(0);
+}
+
+void FindResultsView::ToggleGroup(size_t group)
+{
+    if(group >= m_groups.size()) { return; }
+    m_groups[group].m_expanded = !m_groups[group].m_expanded;
+    DoUpdateRows(group + 1);
+    DoUpdateItemCount();
+    SetSelection(m_groups[group].m_firstRow);
+}
+
+FindResultsView::eRowKind FindResultsView::DoGetRow(size_t row, size_t& group, size_t& match) const
+{
+    group = 0;
+    match = 0;
+    size_t headerRows = m_header.IsEmpty() ? 0 : 1;
+    if(row < headerRows) { return kRowHeader; }
+
+    size_t endRow = DoGetGroupsEndRow();
+    if(row >= endRow) {
+        match = row - endRow;
+        return kRowFooter;
+    }
+
+    // the last group that starts on or before 'row'
+    std::vector<Group>::const_iterator iter = std::upper_bound(
+        m_groups.begin(), m_groups.end(), row, [](size_t r, const Group& g) { return r < g.m_firstRow; });
+    --iter;
+    group = iter - m_groups.begin();
+    size_t offset = row - iter->m_firstRow;
+    if(offset == 0) { return kRowFile; }
+    match = iter->m_firstMatch + offset - 1;
+    return kRowMatch;
+}
+
+int FindResultsView::GetMatchAt(size_t row) const
+{
+    if(row >= GetItemCount()) { return wxNOT_FOUND; }
+    size_t group, match;
+    return (DoGetRow(row, group, match) == kRowMatch) ? (int)match : wxNOT_FOUND;
+}
+
+int FindResultsView::GetGroupAt(size_t row) const
+{
+    if(row >= GetItemCount()) { return wxNOT_FOUND; }
+    size_t group, match;
+    return (DoGetRow(row, group, match) == kRowFile) ? (int)group : wxNOT_FOUND;
+}
+
+int FindResultsView::GetSelectedMatch() const
+{
+    int sel = GetSelection();
+    return (sel == wxNOT_FOUND) ? wxNOT_FOUND : GetMatchAt(sel);
+}
+
+void FindResultsView::SelectMatch(size_t index)
+{
+    if(index >= m_store.GetCount() || m_groups.empty()) { return; }
+
+    // the last group that starts on or before 'index'
+    std::vector<Group>::const_iterator iter = std::upper_bound(
+        m_groups.begin(), m_groups.end(), index, [](size_t i, const Group& g) { return i < g.m_firstMatch; });
+    if(iter == m_groups.begin()) { return; }
+    --iter;
+    size_t group = iter - m_groups.begin();
+    if(!m_groups[group].m_expanded) { ToggleGroup(group); }
+
+    // SetSelection() scrolls the row into view
+    SetSelection(m_groups[group].m_firstRow + 1 + (index - m_groups[group].m_firstMatch));
+}
+
+wxString FindResultsView::DoGetMatchPrefix(const SearchResult& result) const
+{
+    wxString prefix = wxString::Format(wxT(" %5u: "), result.GetLineNumber());
+    if(m_displayScope) { prefix << wxT("[ ") << result.GetScope() << wxT(" ] "); }
+    return prefix;
+}
+
+wxString FindResultsView::GetRowText(size_t row) const
+{
+    if(row >= GetItemCount()) { return wxEmptyString; }
+    size_t group, match;
+    switch(DoGetRow(row, group, match)) {
+    case kRowHeader:
+        return m_header;
+    case kRowFooter:
+        return m_footer.Item(match);
+    case kRowFile: {
+        wxFileName fn(m_store.GetFileName(m_groups[group].m_firstMatch));
+        fn.MakeRelativeTo();
+        return fn.GetFullPath();
+    }
+    case kRowMatch:
+    default: {
+        SearchResult result = m_store.Get(match);
+        return DoGetMatchPrefix(result) + result.GetPattern();
+    }
+    }
+}
+
+wxCoord FindResultsView::OnMeasureItem(size_t n) const
+{
+    wxUnusedVar(n);
+    return m_lineHeight;
+}
+
+int FindResultsView::DoDrawText(wxDC& dc, const wxString& text, int x, int y, const wxColour& colour) const
+{
+    if(text.IsEmpty()) { return x; }
+    // wxDC does not expand tabs
+    wxString str = text;
+    str.Replace(wxT("\t"), wxT("    "));
+    dc.SetTextForeground(colour);
+    dc.DrawText(str, x, y);
+    return x + dc.GetTextExtent(str).GetWidth();
+}
+
+void FindResultsView::OnDrawItem(wxDC& dc, const wxRect& rect, size_t n) const
+{
+    bool selected = IsSelected(n);
+    wxColour selectedFg = wxSystemSettings::GetColour(wxSYS_COLOUR_HIGHLIGHTTEXT);
+#define ROW_COLOUR(c) (selected ? selectedFg : (c))
+
+    dc.SetFont(m_font);
+    int x = rect.x + ROW_PADDING;
+    int y = rect.y + ROW_PADDING;
+
+    size_t group, match;
+    switch(DoGetRow(n, group, match)) {
+    case kRowHeader:
+        DoDrawText(dc, m_header, x, y, ROW_COLOUR(m_colours.header));
+        break;
+
+    case kRowFooter:
+        DoDrawText(dc, m_footer.Item(match), x, y, ROW_COLOUR(m_colours.header));
+        break;
+
+    case kRowFile: {
+        const Group& g = m_groups[group];
+        wxRect buttonRect(x, rect.y, m_buttonWidth, rect.height);
+        buttonRect.Deflate(ROW_PADDING);
+        wxRendererNative::Get().DrawTreeItemButton(const_cast<FindResultsView*>(this), dc, buttonRect,
+                                                   g.m_expanded ? wxCONTROL_EXPANDED : 0);
+        x += m_buttonWidth;
+        x = DoDrawText(dc, GetRowText(n), x, y, ROW_COLOUR(m_colours.file));
+        DoDrawText(dc, wxString::Format(wxT(" (%u)"), (unsigned)g.m_count), x, y, ROW_COLOUR(m_colours.fg));
+        break;
+    }
+
+    case kRowMatch:
+    default: {
+        SearchResult result = m_store.Get(match);
+        x += m_buttonWidth;
+        x = DoDrawText(dc, wxString::Format(wxT(" %5u: "), result.GetLineNumber()), x, y,
+                       ROW_COLOUR(m_colours.lineNumber));
+        if(m_displayScope) {
+            x = DoDrawText(dc, wxT("[ ") + result.GetScope() + wxT(" ] "), x, y, ROW_COLOUR(m_colours.scope));
+        }
+
+        // the line text, with the match highlighted
+        const wxString& pattern = result.GetPattern();
+        size_t col = std::min((size_t)std::max(result.GetColumnInChars(), 0), pattern.length());
+        size_t len = std::min((size_t)std::max(result.GetLenInChars(), 0), pattern.length() - col);
+        x = DoDrawText(dc, pattern.Mid(0, col), x, y, ROW_COLOUR(m_colours.fg));
+
+        wxString matchText = pattern.Mid(col, len);
+        matchText.Replace(wxT("\t"), wxT("    "));
+        if(!matchText.IsEmpty()) {
+            wxSize matchSize = dc.GetTextExtent(matchText);
+            dc.SetPen(m_colours.matchBg);
+            dc.SetBrush(m_colours.matchBg);
+            dc.DrawRoundedRectangle(x, rect.y + 1, matchSize.GetWidth(), rect.height - 2, 2.0);
+            x = DoDrawText(dc, matchText, x, y, m_colours.match);
+        }
+        DoDrawText(dc, pattern.Mid(col + len), x, y, ROW_COLOUR(m_colours.fg));
+        break;
+    }
+    }
+#undef ROW_COLOUR
+}
+
+void FindResultsView::OnLeftDown(wxMouseEvent& event)
+{
+    event.Skip();
+
+    // a click on the expand button of a file toggles it
+    int row = VirtualHitTest(event.GetPosition().y);
+    if(row == wxNOT_FOUND || event.GetPosition().x > (ROW_PADDING + m_buttonWidth)) { return; }
+    int group = GetGroupAt(row);
+    if(group != wxNOT_FOUND) { ToggleGroup(group); }
+}
+
+void FindResultsView::OnKeyDown(wxKeyEvent& event)
+{
+    int sel = GetSelection();
+    int group = (sel == wxNOT_FOUND) ? wxNOT_FOUND : GetGroupAt(sel);
+
+    if(event.GetKeyCode() == WXK_RETURN || event.GetKeyCode() == WXK_NUMPAD_ENTER) {
+        // same as double clicking the selected row
+        if(sel == wxNOT_FOUND) { return; }
+        wxCommandEvent evt(wxEVT_LISTBOX_DCLICK, GetId());
+        evt.SetEventObject(this);
+        evt.SetInt(sel);
+        ProcessWindowEvent(evt);
+
+    } else if(group != wxNOT_FOUND && ((event.GetKeyCode() == WXK_LEFT && m_groups[group].m_expanded) ||
+                                       (event.GetKeyCode() == WXK_RIGHT && !m_groups[group].m_expanded))) {
+        ToggleGroup(group);
+
+    } else if(event.GetModifiers() == wxMOD_CONTROL && event.GetKeyCode() == 'C') {
+        if(sel != wxNOT_FOUND) { ::CopyToClipboard(GetRowText(sel)); }
+
+    } else {
+        event.Skip();
+    }
+}
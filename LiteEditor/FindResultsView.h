@@ -0,0 +1,133 @@
+#ifndef FINDRESULTSVIEW_H
+#define FINDRESULTSVIEW_H
+
+#include "FindResultsStore.h"
+#include <vector>
+#include <wx/arrstr.h>
+#include <wx/font.h>
+#include <wx/vlbox.h>
+
+/**
+ * @class FindResultsView
+ * @brief a virtual list displaying the matches of a FindResultsStore, grouped by file.
+ * No text is kept per match: the rows are computed from the store and only the rows on the screen are drawn.
+ * The file groups can be collapsed. The rows are: the search header, then for every file a file row followed by its
+ * matches (when expanded), and the search summary lines at the end
+ */
+class FindResultsView : public wxVListBox
+{
+public:
+    enum eRowKind {
+        kRowHeader,
+        kRowFile,
+        kRowMatch,
+        kRowFooter,
+    };
+
+    struct Colours {
+        wxColour bg;
+        wxColour fg;
+        wxColour header;
+        wxColour file;
+        wxColour lineNumber;
+        wxColour scope;
+        wxColour match;
+        wxColour matchBg;
+    };
+
+protected:
+    struct Group {
+        size_t m_firstMatch;
+        size_t m_count;
+        size_t m_firstRow; // the row of the file
+        bool m_expanded;
+    };
+
+    const FindResultsStore& m_store;
+    std::vector<Group> m_groups;
+    wxString m_header;
+    wxArrayString m_footer;
+    bool m_displayScope;
+    Colours m_colours;
+    wxFont m_font;
+    int m_lineHeight;
+    int m_buttonWidth;
+
+protected:
+    void DoUpdateRows(size_t fromGroup);
+    void DoUpdateItemCount();
+    size_t DoGetGroupsEndRow() const;
+    eRowKind DoGetRow(size_t row, size_t& group, size_t& match) const;
+    wxString DoGetMatchPrefix(const SearchResult& result) const;
+    int DoDrawText(wxDC& dc, const wxString& text, int x, int y, const wxColour& colour) const;
+
+    void OnLeftDown(wxMouseEvent& event);
+    void OnKeyDown(wxKeyEvent& event);
+
+    // wxVListBox
+    virtual void OnDrawItem(wxDC& dc, const wxRect& rect, size_t n) const;
+    virtual wxCoord OnMeasureItem(size_t n) const;
+
+public:
+    FindResultsView(wxWindow* parent, const FindResultsStore& store);
+    virtual ~FindResultsView();
+
+    /**
+     * @brief remove all the rows. The store is cleared by its owner
+     */
+    void Clear();
+
+    /**
+     * @brief the matches from the current match count to the end of the store were added to the store
+     */
+    void MatchesAdded();
+
+    /**
+     * @brief recompute the rows from the whole store, e.g. after the store was loaded from the history
+     */
+    void Rebuild();
+
+    void SetHeader(const wxString& header);
+    void AddFooter(const wxString& line);
+    const wxString& GetHeader() const { return m_header; }
+    const wxArrayString& GetFooter() const { return m_footer; }
+    void SetFooter(const wxArrayString& footer);
+    void SetDisplayScope(bool displayScope) { m_displayScope = displayScope; }
+    void SetColours(const Colours& colours, const wxFont& font);
+
+    /**
+     * @brief collapse all the files. When 'expandFirst' is true the first file remains expanded.
+     * When all the files are already collapsed, expand them instead
+     */
+    void CollapseAll(bool expandFirst);
+    void ToggleGroup(size_t group);
+
+    /**
+     * @brief return the index in the store of the match displayed at 'row', or wxNOT_FOUND
+     */
+    int GetMatchAt(size_t row) const;
+
+    /**
+     * @brief return the index of the file displayed at 'row', or wxNOT_FOUND
+     */
+    int GetGroupAt(size_t row) const;
+
+    /**
+     * @brief return the index in the store of the selected match, or wxNOT_FOUND
+     */
+    int GetSelectedMatch() const;
+
+    /**
+     * @brief select the row of the match at 'index' in the store, expanding its file if needed
+     */
+    void SelectMatch(size_t index);
+
+    /**
+     * @brief return the text of 'row', as the old text view displayed it
+     */
+    wxString GetRowText(size_t row) const;
+
+    bool IsEmpty() const { return GetItemCount() == 0; }
+};
+
+#endif // FINDRESULTSVIEW_H
@@ -0,0 +1,325 @@
+#include "ReplaceInFilesEngine.h"
+#include "clPerfTrace.h"
+#include "file_logger.h"
+#include "fileutils.h"
+#include "wxStringHash.h"
+#include <algorithm>
+#include <set>
+#include <string>
+#include <wx/ffile.h>
+#include <wx/filefn.h>
+#include <wx/strconv.h>
+
+#ifndef __WXMSW__
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Upper limit for the number of worker threads
+#define REPLACE_IN_FILES_MAX_THREADS 8
+
+ReplaceInFilesEngine::ReplaceInFilesEngine()
+    : m_encoding(wxFONTENCODING_DEFAULT)
+    , m_nextFile(0)
+    , m_filesProcessed(0)
+    , m_runningThreads(0)
+    , m_cancelled(false)
+{
+}
+
+ReplaceInFilesEngine::~ReplaceInFilesEngine()
+{
+    Cancel();
+    Wait();
+}
+
+void ReplaceInFilesEngine::Start(File::Vec_t& files, const wxString& replaceWith, wxFontEncoding encoding)
+{
+    Cancel();
+    Wait();
+
+    m_files.clear();
+    m_files.swap(files);
+    m_replaceWith = replaceWith;
+    m_encoding = encoding;
+    m_nextFile.store(0);
+    m_filesProcessed.store(0);
+    m_cancelled.store(false);
+    if(m_files.empty()) { return; }
+
+    size_t count = std::max(std::thread::hardware_concurrency(), 1u);
+    count = std::min(count, (size_t)REPLACE_IN_FILES_MAX_THREADS);
+    count = std::min(count, m_files.size());
+    m_runningThreads.store(count);
+    for(size_t i = 0; i < count; ++i) {
+        m_threads.push_back(new std::thread(&ReplaceInFilesEngine::DoProcessFiles, this));
+    }
+    clDEBUG() << "Replace: processing" << m_files.size() << "files with" << count << "threads";
+}
+
+void ReplaceInFilesEngine::Cancel() { m_cancelled.store(true); }
+
+void ReplaceInFilesEngine::Wait()
+{
+    for(size_t i = 0; i < m_threads.size(); ++i) {
+        m_threads[i]->join();
+        delete m_threads[i];
+    }
+    m_threads.clear();
+}
+
+void ReplaceInFilesEngine::DoProcessFiles()
+{
+    while(true) {
+        size_t index = m_nextFile.fetch_add(1);
+        if(index >= m_files.size()) { break; }
+
+        File& file = m_files[index];
+        if(m_cancelled.load()) {
+            file.m_status = kFileCancelled;
+        } else {
+            DoReplaceInFile(file);
+        }
+        m_filesProcessed.fetch_add(1);
+    }
+    m_runningThreads.fetch_sub(1);
+}
+
+void ReplaceInFilesEngine::DoReplaceInFile(File& file)
+{
+    CL_TRACE_SCOPE("replace", file.m_fileName);
+    if(file.m_matches.empty()) { return; }
+
+    // Make sure that the file was not modified since the search: check the size and the modification time first,
+    // these do not require reading the file
+    wxFileName fn(file.m_fileName);
+    const SearchResult& searched = file.m_matches[0].m_result;
+    if((FileUtils::GetFileSize(fn) != searched.GetFileSize()) ||
+       (FileUtils::GetFileModificationTime(fn) != searched.GetFileModificationTime())) {
+        file.m_status = kFileModified;
+        return;
+    }
+
+    // Work on the file a symlink points to, so the link itself is kept
+    wxString path = FileUtils::RealPath(fn.GetFullPath());
+
+    // Read the file the way the search did, so the match positions apply to it. Unlike the search, we don't fall
+    // back to 8 bit data when the file can not be converted with the encoding: writing it back would transcode it
+    wxCSConv conv(m_encoding);
+    wxString content;
+    if(!DoReadFile(path, conv, content)) {
+        file.m_status = kFileReadFailed;
+        return;
+    }
+
+    if(std::hash<wxString>()(content) != searched.GetFileHash()) {
+        file.m_status = kFileModified;
+        return;
+    }
+
+    // Build the new content in a single pass. The matches are sorted by their position
+    wxString output;
+    output.reserve(content.length());
+    size_t last = 0;
+    for(size_t i = 0; i < file.m_matches.size(); ++i) {
+        Match& match = file.m_matches[i];
+        if(!match.m_selected) { continue; }
+
+        size_t position = match.m_result.GetPosition();
+        size_t len = match.m_result.GetLenInChars();
+        if((position < last) || ((position + len) > content.length())) {
+            // overlapping match
+            continue;
+        }
+        output.append(content, last, position - last);
+        output.append(m_replaceWith);
+        last = position + len;
+        match.m_replaced = true;
+    }
+    output.append(content, last, wxString::npos);
+
+    if(!DoWriteFile(path, conv, output)) {
+        clWARNING() << "Replace: failed to write file" << path;
+        for(size_t i = 0; i < file.m_matches.size(); ++i) {
+            file.m_matches[i].m_replaced = false;
+        }
+        file.m_status = kFileWriteFailed;
+        return;
+    }
+
+    // Update the remaining matches so they can be replaced later
+    UpdateMatches(file, m_replaceWith, [&](const SearchResult& result) {
+        size_t position = result.GetPosition();
+        size_t start = (position == 0) ? wxString::npos : output.rfind('\n', position - 1);
+        start = (start == wxString::npos) ? 0 : start + 1;
+        size_t end = output.find('\n', position);
+        return output.Mid(start, (end == wxString::npos) ? wxString::npos : end - start);
+    });
+
+    size_t hash = std::hash<wxString>()(output);
+    size_t size = FileUtils::GetFileSize(fn);
+    time_t modificationTime = FileUtils::GetFileModificationTime(fn);
+    for(size_t i = 0; i < file.m_matches.size(); ++i) {
+        file.m_matches[i].m_result.SetFileStamp(size, modificationTime, hash);
+    }
+    file.m_status = kFileReplaced;
+}
+
+bool ReplaceInFilesEngine::DoReadFile(const wxString& path, const wxMBConv& conv, wxString& content)
+{
+    wxFFile fp(path, "rb");
+    if(!fp.IsOpened()) { return false; }
+
+    wxFileOffset len = fp.Length();
+    if(len == wxInvalidOffset) { return false; }
+    std::string buffer((size_t)len, '\0');
+    if(len && (fp.Read(&buffer[0], buffer.length()) != buffer.length())) { return false; }
+
+    content = wxString(buffer.c_str(), conv, buffer.length());
+    if(content.IsEmpty() && !buffer.empty()) {
+        clWARNING() << "Replace: file" << path << "can not be converted using the search encoding";
+        return false;
+    }
+    return true;
+}
+
+bool ReplaceInFilesEngine::DoWriteFile(const wxString& path, const wxMBConv& conv, const wxString& content)
+{
+    // Convert the content before the file is opened: a conversion failure leaves the file untouched
+    const wxCharBuffer buffer = content.mb_str(conv);
+    size_t len = buffer.data() ? buffer.length() : 0;
+    if((len == 0) && !content.IsEmpty()) { return false; }
+
+#ifdef __WXMSW__
+    // Write a temporary file next to the target and move it over the target
+    wxString tmpPath = wxFileName::CreateTempFileName(wxFileName(path).GetPath(wxPATH_GET_SEPARATOR) + "clrpl");
+    if(tmpPath.IsEmpty()) { return DoWriteFileInPlace(path, buffer.data(), len); }
+    {
+        wxFFile fp(tmpPath, "wb");
+        bool written = fp.IsOpened() && ((len == 0) || (fp.Write(buffer.data(), len) == len));
+        if(!fp.Close() || !written) {
+            ::wxRemoveFile(tmpPath);
+            return false;
+        }
+    }
+    if(!::wxRenameFile(tmpPath, path, true)) {
+        ::wxRemoveFile(tmpPath);
+        return false;
+    }
+    return true;
+#else
+    // 'path' is the real path, so a symlink to it is kept. A file with several hard links is written in place:
+    // replacing it would detach it from its other names
+    struct stat st;
+    if(::stat(path.mb_str(wxConvUTF8).data(), &st) != 0) { return false; }
+    if(st.st_nlink > 1) { return DoWriteFileInPlace(path, buffer.data(), len); }
+
+    // Write a temporary file in the same directory (so the rename below does not cross file systems), give it the
+    // permissions and the owner of the file, flush it to disk and move it over the file. Readers see either the old
+    // or the new content, and a failure at any point leaves the file untouched
+    wxCharBuffer tmpPath = wxString(path + ".clrplXXXXXX").mb_str(wxConvUTF8);
+    int fd = ::mkstemp(tmpPath.data());
+    if(fd < 0) {
+        clWARNING() << "Replace: failed to create a temporary file for" << path << ":" << strerror(errno);
+        return false;
+    }
+
+    bool ok = true;
+    size_t written = 0;
+    while(ok && (written < len)) {
+        ssize_t res = ::write(fd, buffer.data() + written, len - written);
+        if(res < 0 && errno == EINTR) { continue; }
+        ok = (res > 0);
+        if(ok) { written += res; }
+    }
+    ok = ok && (::fchmod(fd, st.st_mode & 07777) == 0);
+    if(ok && (::fchown(fd, st.st_uid, st.st_gid) != 0)) {
+        // We may not give the file away to another user: keep the owner by writing in place
+        ::close(fd);
+        ::unlink(tmpPath.data());
+        return DoWriteFileInPlace(path, buffer.data(), len);
+    }
+    ok = ok && (::fsync(fd) == 0);
+    ok = (::close(fd) == 0) && ok;
+    ok = ok && (::rename(tmpPath.data(), path.mb_str(wxConvUTF8).data()) == 0);
+    if(!ok) {
+        clWARNING() << "Replace: failed to replace" << path << ":" << strerror(errno);
+        ::unlink(tmpPath.data());
+    }
+    return ok;
+#endif
+}
+
+bool ReplaceInFilesEngine::DoWriteFileInPlace(const wxString& path, const char* buffer, size_t len)
+{
+    wxFFile fp(path, "wb");
+    if(!fp.IsOpened()) { return false; }
+    bool written = (len == 0) || (fp.Write(buffer, len) == len);
+    return fp.Close() && written;
+}
+
+void ReplaceInFilesEngine::UpdateMatches(File& file, const wxString& replaceWith,
+                                         const std::function<wxString(const SearchResult&)>& getLine)
+{
+    // The lines with a replacement
+    std::set<int> lines;
+    for(size_t i = 0; i < file.m_matches.size(); ++i) {
+        if(file.m_matches[i].m_replaced) { lines.insert(file.m_matches[i].m_result.GetLineNumber()); }
+    }
+    if(lines.empty()) { return; }
+
+    int replaceWithLen = (int)replaceWith.length();
+    int replaceWithBytes = (int)FileUtils::UTF8Length(replaceWith.wc_str(), replaceWith.length());
+
+    // A replacement text with line breaks moves the lines that follow it. The text after its last line break starts
+    // the line on which the rest of the replaced line continues
+    int newLines = (int)replaceWith.Freq('\n');
+    size_t lastBreak = replaceWith.rfind('\n');
+    int tailLen = 0;
+    int tailBytes = 0;
+    if(lastBreak != wxString::npos) {
+        tailLen = (int)(replaceWith.length() - lastBreak - 1);
+        tailBytes = (int)FileUtils::UTF8Length(replaceWith.wc_str() + lastBreak + 1, tailLen);
+    }
+
+    int delta = 0;                 // in chars, for the positions
+    int lineNumberDelta = 0;       // in lines, for the line numbers
+    int deltaLine = wxNOT_FOUND;   // the line of the last replacement, as searched
+    int lineDelta = 0;             // in chars, for the columns on 'deltaLine'
+    int lineDeltaBytes = 0;        // in bytes, for the columns on 'deltaLine'
+    for(size_t i = 0; i < file.m_matches.size(); ++i) {
+        Match& match = file.m_matches[i];
+        SearchResult& result = match.m_result;
+        int lineNumber = result.GetLineNumber();
+        if(match.m_replaced) {
+            if(lineNumber != deltaLine) {
+                deltaLine = lineNumber;
+                lineDelta = 0;
+                lineDeltaBytes = 0;
+            }
+            delta += replaceWithLen - result.GetLenInChars();
+            lineNumberDelta += newLines;
+            if(newLines) {
+                // the rest of the line now follows the replacement's last line
+                lineDelta = tailLen - (result.GetColumnInChars() + result.GetLenInChars());
+                lineDeltaBytes = tailBytes - (result.GetColumn() + result.GetLen());
+            } else {
+                lineDelta += replaceWithLen - result.GetLenInChars();
+                lineDeltaBytes += replaceWithBytes - result.GetLen();
+            }
+            continue;
+        }
+
+        result.SetPosition(result.GetPosition() + delta);
+        result.SetLineNumber(lineNumber + lineNumberDelta);
+        if(lineNumber == deltaLine) {
+            result.SetColumnInChars(result.GetColumnInChars() + lineDelta);
+            result.SetColumn(result.GetColumn() + lineDeltaBytes);
+        }
+        if(lines.count(lineNumber)) { result.SetPattern(getLine(result)); }
+    }
+}
@@ -0,0 +1,127 @@
+#ifndef REPLACEINFILESENGINE_H
+#define REPLACEINFILESENGINE_H
+
+#include "search_thread.h"
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+#include <wx/fontenc.h>
+#include <wx/strconv.h>
+#include <wx/string.h>
+
+/**
+ * @class ReplaceInFilesEngine
+ * @brief applies the replacements of the "Replace In Files" view to the files that are not opened in an editor.
+ * The files are processed on worker threads. Every file is read once and compared with its state at the time of the
+ * search (size, modification time and content hash). The replacements are then applied in memory and the new content
+ * is written back over the original file (the target of a symlink)
+ */
+class ReplaceInFilesEngine
+{
+public:
+    enum eFileStatus {
+        kFilePending = 0,
+        kFileReplaced,
+        kFileModified, // the file was modified after the search, nothing was replaced
+        kFileReadFailed,
+        kFileWriteFailed,
+        kFileCancelled,
+    };
+
+    struct Match {
+        SearchResult m_result;
+        int m_viewLine;
+        bool m_selected; // marked for replacement
+        bool m_replaced;
+
+        Match()
+            : m_viewLine(wxNOT_FOUND)
+            , m_selected(false)
+            , m_replaced(false)
+        {
+        }
+    };
+
+    struct File {
+        wxString m_fileName;
+        std::vector<Match> m_matches; // in the order of the search results
+        eFileStatus m_status;
+
+        File()
+            : m_status(kFilePending)
+        {
+        }
+        typedef std::vector<File> Vec_t;
+    };
+
+protected:
+    File::Vec_t m_files;
+    wxString m_replaceWith;
+    wxFontEncoding m_encoding;
+    std::vector<std::thread*> m_threads;
+    std::atomic<size_t> m_nextFile;
+    std::atomic<size_t> m_filesProcessed;
+    std::atomic<size_t> m_runningThreads;
+    std::atomic<bool> m_cancelled;
+
+protected:
+    void DoProcessFiles();
+    void DoReplaceInFile(File& file);
+
+    /**
+     * @brief read 'path' using 'conv'. Fails when the file content can not be converted
+     */
+    static bool DoReadFile(const wxString& path, const wxMBConv& conv, wxString& content);
+
+    /**
+     * @brief convert 'content' using 'conv' and write it to 'path'. The new content is written to a temporary file
+     * that replaces 'path' once complete, with the permissions and the owner of 'path'. A file with several hard
+     * links, or whose owner can not be kept, is written in place. The file is left untouched when the conversion
+     * fails
+     */
+    static bool DoWriteFile(const wxString& path, const wxMBConv& conv, const wxString& content);
+
+    /**
+     * @brief overwrite 'path' with 'len' bytes of 'buffer'
+     */
+    static bool DoWriteFileInPlace(const wxString& path, const char* buffer, size_t len);
+
+public:
+    ReplaceInFilesEngine();
+    virtual ~ReplaceInFilesEngine();
+
+    /**
+     * @brief start replacing in 'files' with 'replaceWith'. The files are read and written using 'encoding', the
+     * encoding used by the search. The engine takes the content of 'files'
+     */
+    void Start(File::Vec_t& files, const wxString& replaceWith, wxFontEncoding encoding);
+
+    /**
+     * @brief stop the workers. The files that were not processed yet are marked as kFileCancelled
+     */
+    void Cancel();
+
+    /**
+     * @brief wait for the workers to complete
+     */
+    void Wait();
+
+    bool IsRunning() const { return m_runningThreads.load() > 0; }
+    size_t GetFilesProcessed() const { return m_filesProcessed.load(); }
+
+    /**
+     * @brief return the processed files. Only valid once IsRunning() returns false
+     */
+    File::Vec_t& GetFiles() { return m_files; }
+
+    /**
+     * @brief update the matches that were not replaced in 'file': their positions, line numbers and columns are moved
+     * by the replacements that precede them. The pattern of a match that shares its line with a replaced match is set to
+     * getLine(match), the new text of the line
+     */
+    static void UpdateMatches(File& file, const wxString& replaceWith,
+                              const std::function<wxString(const SearchResult&)>& getLine);
+};
+
+#endif // REPLACEINFILESENGINE_H
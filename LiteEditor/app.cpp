@@ -31,6 +31,7 @@
 #include "autoversion.h"
 #include "clInitializeDialog.h"
 #include "clKeyboardManager.h"
+#include "clPerfTrace.h"
 #include "clSystemSettings.h"
 #include "cl_config.h"
 #include "cl_registry.h"
@@ -139,6 +140,9 @@ static const wxCmdLineEntryDesc cmdLineDesc[] = {
       wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
     { wxCMD_LINE_OPTION, "p", "with-plugins", "Comma separated list of plugins to load", wxCMD_LINE_VAL_STRING,
       wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_SWITCH, NULL, "trace-startup",
+      "Record the startup phases into startup-trace.json (Chrome trace format) in the user data folder",
+      wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
     { wxCMD_LINE_PARAM, NULL, NULL, "Input file", wxCMD_LINE_VAL_STRING,
       wxCMD_LINE_PARAM_MULTIPLE | wxCMD_LINE_PARAM_OPTIONAL },
     { wxCMD_LINE_NONE }
@@ -347,6 +351,8 @@ bool CodeLiteApp::OnInit()
     }
 
     if(parser.Found(wxT("d"), &newDataDir)) { clStandardPaths::Get().SetUserDataDir(newDataDir); }
+    if(parser.Found("trace-startup")) { clPerfTrace::Get().Enable(true); }
+    CL_TRACE_THREAD_NAME("Main thread");
 
     // check for single instance
     if(!IsSingleInstance(parser)) { return false; }
@@ -505,7 +511,10 @@ bool CodeLiteApp::OnInit()
 
     // Make sure we have an instance if the keyboard manager allocated before we create the main frame class
     // (the keyboard manager needs to connect to the main frame events)
-    clKeyboardManager::Get();
+    {
+        CL_TRACE_SCOPE("startup", "clKeyboardManager::Get");
+        clKeyboardManager::Get();
+    }
     PluginManager::Get();
     ManagerST::Get()->SetOriginalCwd(wxGetCwd());
     ::wxSetWorkingDirectory(homeDir);
@@ -649,19 +658,28 @@ bool CodeLiteApp::OnInit()
     // If running under Cygwin terminal, adjust the environment variables
     AdjustPathForMSYSIfNeeded();
 
-    // Make sure that the colours and fonts manager is instantiated
-    ColoursAndFontsManager::Get().Load();
+    {
+        CL_TRACE_SCOPE("startup", "ColoursAndFontsManager::Load");
+        // Make sure that the colours and fonts manager is instantiated
+        ColoursAndFontsManager::Get().Load();
 
-    // Merge the user settings with any new settings
-    ColoursAndFontsManager::Get().ImportLexersFile(wxFileName(clStandardPaths::Get().GetLexersDir(), "lexers.json"),
-                                                   false);
+        // Merge the user settings with any new settings
+        ColoursAndFontsManager::Get().ImportLexersFile(
+            wxFileName(clStandardPaths::Get().GetLexersDir(), "lexers.json"), false);
+    }
 
-    // Create the main application window
-    clMainFrame::Initialize((parser.GetParamCount() == 0) && !IsStartedInDebuggerMode());
+    {
+        CL_TRACE_SCOPE("startup", "clMainFrame::Initialize");
+        // Create the main application window
+        clMainFrame::Initialize((parser.GetParamCount() == 0) && !IsStartedInDebuggerMode());
+    }
     m_pMainFrame = clMainFrame::Get();
     m_pMainFrame->Show(TRUE);
     SetTopWindow(m_pMainFrame);
 
+    // The main frame is up: let the plugins complete their non UI initialisation in the background
+    PluginManager::Get()->StartBackgroundInitialisation();
+
     long lineNumber(0);
     parser.Found(wxT("l"), &lineNumber);
     if(lineNumber > 0) {
@@ -689,9 +707,21 @@ bool CodeLiteApp::OnInit()
     // Especially with the OutputView open, CodeLite was consuming 50% of a cpu, mostly in updateui
     // The next line limits the frequency of UpdateUI events to every 100ms
     wxUpdateUIEvent::SetUpdateInterval(200);
+
+    // Save the startup trace once the queued startup events were processed
+    if(clPerfTrace::Get().IsEnabled()) { CallAfter(&CodeLiteApp::DoSaveStartupTrace); }
     return TRUE;
 }
 
+void CodeLiteApp::DoSaveStartupTrace()
+{
+    // The trace includes the plugins background initialisation
+    PluginManager::Get()->WaitForBackgroundInitialisation();
+    clPerfTrace::Get().Save(wxFileName(clStandardPaths::Get().GetUserDataDir(), "startup-trace.json"));
+    clPerfTrace::Get().Enable(false);
+    clPerfTrace::Get().Clear();
+}
+
 int CodeLiteApp::OnExit()
 {
     clDEBUG() << "Bye";
@@ -65,6 +65,7 @@ private: // Methods
     void AdjustPathForCygwinIfNeeded();
     void AdjustPathForMSYSIfNeeded();
     void PrintUsage(const wxCmdLineParser& parser);
+    void DoSaveStartupTrace();
 
 public:
     CodeLiteApp(void);
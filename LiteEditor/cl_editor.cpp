@@ -33,6 +33,7 @@
 #include "cc_box_tip_window.h"
 #include "clEditorStateLocker.h"
 #include "clFileSystemWorkspace.hpp"
+#include "clPerfTrace.h"
 #include "clPrintout.h"
 #include "clResizableTooltip.h"
 #include "clSTCLineKeeper.h"
@@ -1500,6 +1501,7 @@ bool clEditor::SaveFileAs(const wxString& newname, const wxString& savePath)
 // an internal function that does the actual file writing to disk
 bool clEditor::SaveToFile(const wxFileName& fileName)
 {
+    CL_TRACE_SCOPE("editor", "clEditor::SaveToFile");
     {
         // Notify about file being saved
         clCommandEvent beforeSaveEvent(wxEVT_BEFORE_EDITOR_SAVE);
@@ -3029,6 +3031,7 @@ void clEditor::UpdateLineNumbers()
 
 void clEditor::OpenFile()
 {
+    CL_TRACE_SCOPE("editor", "clEditor::OpenFile");
     wxBusyCursor bc;
     wxWindowUpdateLocker locker(this);
     SetReloadingFile(true);
@@ -3847,7 +3850,9 @@ void clEditor::UpdateColours()
             SetKeyWords(4, GetPreProcessorsWords());
         }
     }
-    Colourise(0, wxSTC_INVALID_POSITION);
+    // Style the visible lines now, the rest of the document is styled when it is scrolled into view
+    int lastVisibleLine = DocLineFromVisible(GetFirstVisibleLine() + LinesOnScreen()) + 1;
+    Colourise(0, lastVisibleLine >= GetLineCount() ? wxSTC_INVALID_POSITION : PositionFromLine(lastVisibleLine));
 }
 
 int clEditor::SafeGetChar(int pos)
@@ -5527,6 +5532,7 @@ void clEditor::OpenURL(wxCommandEvent& event)
 
 void clEditor::ReloadFromDisk(bool keepUndoHistory)
 {
+    CL_TRACE_SCOPE("editor", "clEditor::ReloadFromDisk");
     wxWindowUpdateLocker locker(this);
     SetReloadingFile(true);
 
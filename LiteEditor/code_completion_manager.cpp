@@ -25,6 +25,7 @@
 
 #include "ServiceProviderManager.h"
 #include "bitmap_loader.h"
+#include "clPerfTrace.h"
 #include "cl_editor.h"
 #include "code_completion_api.h"
 #include "code_completion_manager.h"
@@ -183,6 +184,7 @@ CodeCompletionManager& CodeCompletionManager::Get()
 
 bool CodeCompletionManager::DoCtagsWordCompletion(clEditor* editor, const wxString& expr, const wxString& word)
 {
+    CL_TRACE_SCOPE("completion", "CodeCompletionManager::DoCtagsWordCompletion");
     std::vector<TagEntryPtr> candidates;
     // get the full text of the current page
     wxString text = editor->GetTextRange(0, editor->GetCurrentPosition());
@@ -199,6 +201,7 @@ bool CodeCompletionManager::DoCtagsWordCompletion(clEditor* editor, const wxStri
 bool CodeCompletionManager::DoCtagsCalltip(clEditor* editor, int line, const wxString& expr, const wxString& text,
                                            const wxString& word)
 {
+    CL_TRACE_SCOPE("completion", "CodeCompletionManager::DoCtagsCalltip");
     // Get the calltip
     clCallTipPtr tip = TagsManagerST::Get()->GetFunctionTip(editor->GetFileName(), line, expr, text, word);
     if(!tip || !tip->Count()) {
@@ -225,9 +228,11 @@ bool CodeCompletionManager::CodeComplete(clEditor* editor, int line, const wxStr
 
 bool CodeCompletionManager::DoCtagsCodeComplete(clEditor* editor, int line, const wxString& expr, const wxString& text)
 {
+    CL_TRACE_SCOPE("completion", "CodeCompletionManager::DoCtagsCodeComplete");
     std::vector<TagEntryPtr> candidates;
-    if(TagsManagerST::Get()->AutoCompleteCandidates(editor->GetFileName(), line, expr, text, candidates) &&
-       !candidates.empty()) {
+    bool res = TagsManagerST::Get()->AutoCompleteCandidates(editor->GetFileName(), line, expr, text, candidates);
+    CL_TRACE_COUNTER("completion", "Completion candidates", candidates.size());
+    if(res && !candidates.empty()) {
         editor->ShowCompletionBox(candidates, wxEmptyString);
         return true;
     }
@@ -554,6 +559,8 @@ void CodeCompletionManager::DoProcessCompileCommands()
 
 void CodeCompletionManager::ThreadProcessCompileCommandsEntry(CodeCompletionManager* owner, const wxString& rootFolder)
 {
+    CL_TRACE_THREAD_NAME("compile_commands.json reader");
+    CL_TRACE_SCOPE("completion", "CompilationDatabase::FindIncludePaths");
     // Search for compile_commands file, process it and send back the results to the main thread
     wxArrayString includePaths = CompilationDatabase::FindIncludePaths(rootFolder, owner->m_compileCommands,
                                                                        owner->m_compileCommandsLastModified);
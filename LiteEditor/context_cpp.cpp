@@ -174,6 +174,10 @@ END_EVENT_TABLE()
 ContextCpp::ContextCpp(clEditor* container)
     : ContextBase(container)
     , m_rclickMenu(NULL)
+    , m_idleModificationCount(0)
+    , m_idleCaretPos(0)
+    , m_analysedTopLevelLine(wxNOT_FOUND)
+    , m_analysedTopLevelPos(wxNOT_FOUND)
 {
     Initialize();
     SetName("c++");
@@ -185,6 +189,10 @@ ContextCpp::ContextCpp(clEditor* container)
 ContextCpp::ContextCpp()
     : ContextBase(wxT("c++"))
     , m_rclickMenu(NULL)
+    , m_idleModificationCount(0)
+    , m_idleCaretPos(0)
+    , m_analysedTopLevelLine(wxNOT_FOUND)
+    , m_analysedTopLevelPos(wxNOT_FOUND)
 {
     EventNotifier::Get()->Connect(wxEVT_CC_SHOW_QUICK_NAV_MENU,
                                   clCodeCompletionEventHandler(ContextCpp::OnShowCodeNavMenu), NULL, this);
@@ -1362,6 +1370,54 @@ void ContextCpp::OnSciUpdateUI(wxStyledTextEvent& event)
     }
 }
 
+void ContextCpp::ProcessIdleActions()
+{
+    if(IsJavaScript()) { return; }
+
+    // Once the user stops typing, refresh the scope analysis used by code completion in the background
+    clEditor& ctrl = GetCtrl();
+    wxUint64 modificationCount = ctrl.GetModificationCount();
+    long caretPos = ctrl.GetCurrentPos();
+    if((modificationCount != m_idleModificationCount) || (caretPos != m_idleCaretPos)) {
+        // still typing, check again on the next idle event
+        m_idleModificationCount = modificationCount;
+        m_idleCaretPos = caretPos;
+        return;
+    }
+
+    // The parser thread caches the analysis of the text that comes before the block the caret is in, the text of
+    // the block itself is scanned again by code completion anyway. So a request is only needed when the caret moves
+    // to another top level block, or when the text before the block is modified (which moves the block)
+    int topLevelLine = DoGetTopLevelLine(ctrl.LineFromPosition(caretPos));
+    long topLevelPos = ctrl.PositionFromLine(topLevelLine);
+    if((topLevelLine == m_analysedTopLevelLine) && (topLevelPos == m_analysedTopLevelPos)) { return; }
+    m_analysedTopLevelLine = topLevelLine;
+    m_analysedTopLevelPos = topLevelPos;
+
+    ParseRequest* req = new ParseRequest(ManagerST::Get());
+    req->setType(ParseRequest::PR_ANALYSE_SCOPE);
+    req->setFile(ctrl.GetFileName().GetFullPath());
+    req->SetText(ctrl.GetTextRange(0, caretPos));
+    ParseThreadST::Get()->Add(req);
+}
+
+int ContextCpp::DoGetTopLevelLine(int line)
+{
+    clEditor& ctrl = GetCtrl();
+    int parent = ctrl.GetFoldParent(line);
+    while(parent != wxNOT_FOUND) {
+        // The fold point of 'namespace X\n{' is on the line of the brace
+        wxString header = ctrl.GetLine(parent).Trim(false);
+        if(header.StartsWith("{") && (parent > 0)) { header = ctrl.GetLine(parent - 1).Trim(false); }
+        if(header.StartsWith("namespace") || header.StartsWith("inline namespace") || header.StartsWith("extern")) {
+            break;
+        }
+        line = parent;
+        parent = ctrl.GetFoldParent(line);
+    }
+    return line;
+}
+
 void ContextCpp::OnDbgDwellEnd(wxStyledTextEvent& event)
 {
     wxUnusedVar(event);
@@ -3029,13 +3085,19 @@ void ContextCpp::ColourContextTokens(const wxString& workspaceTokensStr, const w
     //------------------------------------------
     // Classes
     //------------------------------------------
+    // Changing a keywords list restyles the document, so only do it when the list actually changed. The editor
+    // restyles the visible lines first, the rest is styled when it is scrolled into view
     wxString flatStrClasses = cc_flags & CC_COLOUR_VARS ? workspaceTokensStr : "";
-    ctrl.SetKeyWords(1, flatStrClasses);
-    ctrl.SetKeywordClasses(flatStrClasses);
+    if(flatStrClasses != ctrl.GetKeywordClasses()) {
+        ctrl.SetKeyWords(1, flatStrClasses);
+        ctrl.SetKeywordClasses(flatStrClasses);
+    }
 
     wxString flatStrLocals = cc_flags & CC_COLOUR_VARS ? localsTokensStr : "";
-    ctrl.SetKeyWords(3, flatStrLocals);
-    ctrl.SetKeywordLocals(flatStrLocals);
+    if(flatStrLocals != ctrl.GetKeywordLocals()) {
+        ctrl.SetKeyWords(3, flatStrLocals);
+        ctrl.SetKeywordLocals(flatStrLocals);
+    }
 }
 
 wxMenu* ContextCpp::GetMenu()
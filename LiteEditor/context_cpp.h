@@ -39,6 +39,11 @@ class ContextCpp : public ContextBase
 {
     std::map<wxString, int> m_propertyInt;
     wxMenu* m_rclickMenu;
+    // The editor state seen by the last idle event, and the top level line of the last scope analysis request
+    wxUint64 m_idleModificationCount;
+    long m_idleCaretPos;
+    int m_analysedTopLevelLine;
+    long m_analysedTopLevelPos;
 
     static wxBitmap m_cppFileBmp;
     static wxBitmap m_hFileBmp;
@@ -52,6 +57,12 @@ private:
     bool TryOpenFile(const wxFileName& fileName, bool lookInEntireWorkspace = true);
     bool IsJavaScript() const;
 
+    /**
+     * @brief return the first line of the top level block that contains 'line'. Namespace blocks are not
+     * considered as blocks
+     */
+    int DoGetTopLevelLine(int line);
+
     void DisplayFilesCompletionBox(const wxString& word);
     bool DoGetFunctionBody(long curPos, long& blockStartPos, long& blockEndPos, wxString& content);
     void Initialize();
@@ -92,6 +103,7 @@ public:
     virtual wxString CallTipContent();
     virtual void SetActive();
     virtual void SemicolonShift();
+    virtual void ProcessIdleActions();
 
     // ctrl-click style navigation support
     virtual int GetHyperlinkRange(int pos, int& start, int& end);
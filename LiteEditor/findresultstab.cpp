@@ -23,6 +23,7 @@
 //////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////
 #include "ColoursAndFontsManager.h"
+#include "FindResultsView.h"
 #include "attribute_style.h"
 #include "bitmap_loader.h"
 #include "clStrings.h"
@@ -57,11 +58,23 @@ EVT_COMMAND(wxID_ANY, wxEVT_SEARCH_THREAD_SEARCHCANCELED, FindResultsTab::OnSear
 EVT_UPDATE_UI(XRCID("hold_pane_open"), FindResultsTab::OnHoldOpenUpdateUI)
 END_EVENT_TABLE()
 
-FindResultsTab::FindResultsTab(wxWindow* parent, wxWindowID id, const wxString& name)
+FindResultsTab::FindResultsTab(wxWindow* parent, wxWindowID id, const wxString& name, bool virtualView)
     : OutputTabWindow(parent, id, name)
     , m_searchInProgress(false)
+    , m_view(NULL)
 {
+    if(virtualView) {
+        // the view replaces the text control
+        m_view = new FindResultsView(this, m_matchInfo);
+        m_view->Bind(wxEVT_LISTBOX_DCLICK, &FindResultsTab::OnViewDClick, this);
+        m_vSizer->Add(m_view, 1, wxEXPAND);
+        m_vSizer->Hide(m_sci);
+        m_vSizer->Layout();
+        SetStyles(m_sci);
+    }
+
     m_sci->Connect(wxEVT_STC_STYLENEEDED, wxStyledTextEventHandler(FindResultsTab::OnStyleNeeded), NULL, this);
+    m_sci->Bind(wxEVT_STC_UPDATEUI, &FindResultsTab::OnUpdateUI, this);
 
     BitmapLoader& loader = *(PluginManager::Get()->GetStdIcons());
 
@@ -96,7 +109,28 @@ FindResultsTab::~FindResultsTab()
     EventNotifier::Get()->Unbind(wxEVT_WORKSPACE_CLOSED, &FindResultsTab::OnWorkspaceClosed, this);
 }
 
-void FindResultsTab::SetStyles(wxStyledTextCtrl* sci) { m_styler->SetStyles(sci); }
+void FindResultsTab::SetStyles(wxStyledTextCtrl* sci)
+{
+    m_styler->SetStyles(sci);
+    if(m_view && (sci == m_sci)) { DoApplyViewStyles(); }
+}
+
+void FindResultsTab::DoApplyViewStyles()
+{
+    // The view uses the colours the styler set for the text control
+    FindResultsView::Colours colours;
+    colours.bg = m_sci->StyleGetBackground(clFindResultsStyler::LEX_FIF_DEFAULT);
+    colours.fg = m_sci->StyleGetForeground(clFindResultsStyler::LEX_FIF_DEFAULT);
+    colours.header = m_sci->StyleGetForeground(clFindResultsStyler::LEX_FIF_HEADER);
+    colours.file = m_sci->StyleGetForeground(clFindResultsStyler::LEX_FIF_FILE);
+    colours.lineNumber = m_sci->StyleGetForeground(clFindResultsStyler::LEX_FIF_LINE_NUMBER);
+    colours.scope = m_sci->StyleGetForeground(clFindResultsStyler::LEX_FIF_SCOPE);
+    colours.match = colours.fg;
+    colours.matchBg = m_sci->IndicatorGetForeground(1);
+    m_view->SetColours(colours, m_sci->StyleGetFont(clFindResultsStyler::LEX_FIF_DEFAULT));
+}
+
+bool FindResultsTab::DoIsViewEmpty() const { return m_view ? m_view->IsEmpty() : m_sci->IsEmpty(); }
 
 void FindResultsTab::AppendText(const wxString& line)
 {
@@ -104,10 +138,36 @@ void FindResultsTab::AppendText(const wxString& line)
     OutputTabWindow::AppendText(line);
 }
 
+wxString FindResultsTab::DoGetMatchPrefix(const SearchResult& result) const
+{
+    wxString prefix = wxString::Format(wxT(" %5u: "), result.GetLineNumber());
+    if(m_searchData.GetDisplayScope()) { prefix << wxT("[ ") << result.GetScope() << wxT(" ] "); }
+    return prefix;
+}
+
+void FindResultsTab::DoFillVisibleIndicators()
+{
+    if(m_matchInfo.IsEmpty()) { return; }
+
+    // Only the matches on the screen are highlighted. Filling an already highlighted match does nothing
+    m_sci->SetIndicatorCurrent(1);
+    int firstVisibleLine = m_sci->GetFirstVisibleLine();
+    int lastVisibleLine = firstVisibleLine + m_sci->LinesOnScreen();
+    for(int visibleLine = firstVisibleLine; visibleLine <= lastVisibleLine; ++visibleLine) {
+        int line = m_sci->DocLineFromVisible(visibleLine);
+        int index = m_matchInfo.Find(line);
+        if(index == wxNOT_FOUND) { continue; }
+
+        SearchResult result = m_matchInfo.Get(index);
+        int indicatorStartPos = m_sci->PositionFromLine(line) + result.GetColumn() + DoGetMatchPrefix(result).Length();
+        m_sci->IndicatorFillRange(indicatorStartPos, result.GetLen());
+    }
+}
+
 void FindResultsTab::Clear()
 {
-    m_matchInfo.clear();
-    m_indicators.clear();
+    m_matchInfo.Clear();
+    if(m_view) { m_view->Clear(); }
     m_searchTitle.clear();
     OutputTabWindow::Clear();
     m_styler->Reset();
@@ -181,7 +241,12 @@ void FindResultsTab::OnSearchStart(wxCommandEvent& e)
                 << (data->IsMatchCase() ? _("true") : _("false")) << _(" ; Match whole word: ")
                 << (data->IsMatchWholeWord() ? _("true") : _("false")) << _(" ; Regular expression: ")
                 << (data->IsRegularExpression() ? _("true") : _("false")) << wxT(" ======\n");
-        AppendText(message);
+        if(m_view) {
+            m_view->SetDisplayScope(m_searchData.GetDisplayScope());
+            m_view->SetHeader(message.Trim());
+        } else {
+            AppendText(message);
+        }
     }
     wxDELETE(data);
 
@@ -198,41 +263,53 @@ void FindResultsTab::OnSearchMatch(wxCommandEvent& e)
     SearchResultList* res = (SearchResultList*)e.GetClientData();
     if(!res) return;
 
+    if(m_view) {
+        // No text is built: the view draws the matches on the screen from the store
+        SearchResultList::iterator iter = res->begin();
+        for(; iter != res->end(); ++iter) {
+            if(m_searchData.GetDisplayScope()) {
+                TagEntryPtr tag =
+                    TagsManagerST::Get()->FunctionFromFileLine(iter->GetFileName(), iter->GetLineNumber());
+                iter->SetScope(tag ? tag->GetPath() : wxString(wxT("global")));
+            }
+            m_matchInfo.Add(*iter, (int)m_matchInfo.GetCount());
+        }
+        m_view->MatchesAdded();
+        wxDELETE(res);
+        return;
+    }
+
+    // Build the text of the whole batch and append it at once. The matches are highlighted when they are displayed
+    // (see DoFillVisibleIndicators)
+    wxString text;
+    int lineno = m_sci->GetLineCount() - 1;
     SearchResultList::iterator iter = res->begin();
     for(; iter != res->end(); ++iter) {
-        if(m_matchInfo.empty() || m_matchInfo.rbegin()->second.GetFileName() != iter->GetFileName()) {
-            if(!m_matchInfo.empty()) { AppendText("\n"); }
+        if(m_matchInfo.IsEmpty() || m_matchInfo.GetFileName(m_matchInfo.GetCount() - 1) != iter->GetFileName()) {
+            if(!m_matchInfo.IsEmpty()) {
+                text << wxT("\n");
+                ++lineno;
+            }
             wxFileName fn(iter->GetFileName());
             fn.MakeRelativeTo();
-            AppendText(fn.GetFullPath() + wxT("\n"));
+            text << fn.GetFullPath() << wxT("\n");
+            ++lineno;
         }
 
-        int lineno = m_sci->GetLineCount() - 1;
-        m_matchInfo.insert(std::make_pair(lineno, *iter));
-        wxString text = iter->GetPattern();
-        // int delta = -text.Length();
-        // text.Trim(false);
-        // delta += text.Length();
-        // text.Trim();
-
-        wxString linenum = wxString::Format(wxT(" %5u: "), iter->GetLineNumber());
         SearchData* d = GetSearchData();
         // Print the scope name
         if(d->GetDisplayScope()) {
             TagEntryPtr tag = TagsManagerST::Get()->FunctionFromFileLine(iter->GetFileName(), iter->GetLineNumber());
             wxString scopeName(wxT("global"));
             if(tag) { scopeName = tag->GetPath(); }
-
-            linenum << wxT("[ ") << scopeName << wxT(" ] ");
             iter->SetScope(scopeName);
         }
 
-        AppendText(linenum + text + wxT("\n"));
-        int indicatorStartPos = m_sci->PositionFromLine(lineno) + iter->GetColumn() + linenum.Length();
-        int indicatorLen = iter->GetLen();
-        m_indicators.push_back(indicatorStartPos);
-        m_sci->IndicatorFillRange(indicatorStartPos, indicatorLen);
+        m_matchInfo.Add(*iter, lineno);
+        text << DoGetMatchPrefix(*iter) << iter->GetPattern() << wxT("\n");
+        ++lineno;
     }
+    if(!text.IsEmpty()) { AppendText(text); }
     wxDELETE(res);
 }
 
@@ -242,22 +319,34 @@ void FindResultsTab::OnSearchEnded(wxCommandEvent& e)
     SearchSummary* summary = (SearchSummary*)e.GetClientData();
     if(!summary) return;
 
-    // did the page closed before the search ended?
-    AppendText(summary->GetMessage() + wxT("\n"));
-
-    if(m_tb->FindById(XRCID("scroll_on_output")) && m_tb->FindById(XRCID("scroll_on_output"))->IsChecked()) {
-        m_sci->GotoLine(0);
-    }
+    bool scrollToTop =
+        m_tb->FindById(XRCID("scroll_on_output")) && m_tb->FindById(XRCID("scroll_on_output"))->IsChecked();
+    if(m_view) {
+        wxArrayString lines = ::wxStringTokenize(summary->GetMessage(), wxT("\n"));
+        for(size_t i = 0; i < lines.GetCount(); ++i) {
+            m_view->AddFooter(lines.Item(i));
+        }
+        if(!EditorConfigST::Get()->GetOptions()->GetDontAutoFoldResults()) {
+            // collapse all the files but the first one
+            m_view->CollapseAll(true);
+        }
+        if(scrollToTop) { m_view->ScrollToRow(0); }
 
-    if(!EditorConfigST::Get()->GetOptions()->GetDontAutoFoldResults()) {
-        OutputTabWindow::OnCollapseAll(e);
-        // Uncollapse the first file's matches
-        int maxLine = m_sci->GetLineCount();
-        for(int line = 0; line < maxLine; line++) {
-            int foldLevel = (m_sci->GetFoldLevel(line) & wxSTC_FOLDLEVELNUMBERMASK) - wxSTC_FOLDLEVELBASE;
-            if(foldLevel == 2 && !m_sci->GetFoldExpanded(line)) {
-                m_sci->ToggleFold(line);
-                break;
+    } else {
+        // did the page closed before the search ended?
+        AppendText(summary->GetMessage() + wxT("\n"));
+        if(scrollToTop) { m_sci->GotoLine(0); }
+
+        if(!EditorConfigST::Get()->GetOptions()->GetDontAutoFoldResults()) {
+            OutputTabWindow::OnCollapseAll(e);
+            // Uncollapse the first file's matches
+            int maxLine = m_sci->GetLineCount();
+            for(int line = 0; line < maxLine; line++) {
+                int foldLevel = (m_sci->GetFoldLevel(line) & wxSTC_FOLDLEVELNUMBERMASK) - wxSTC_FOLDLEVELBASE;
+                if(foldLevel == 2 && !m_sci->GetFoldExpanded(line)) {
+                    m_sci->ToggleFold(line);
+                    break;
+                }
             }
         }
     }
@@ -276,7 +365,14 @@ void FindResultsTab::OnSearchEnded(wxCommandEvent& e)
     }
 }
 
-void FindResultsTab::OnSearchCancel(wxCommandEvent& e) { AppendText(_("====== Search cancelled by user ======\n")); }
+void FindResultsTab::OnSearchCancel(wxCommandEvent& e)
+{
+    if(m_view) {
+        m_view->AddFooter(_("====== Search cancelled by user ======"));
+    } else {
+        AppendText(_("====== Search cancelled by user ======\n"));
+    }
+}
 
 void FindResultsTab::OnClearAll(wxCommandEvent& e)
 {
@@ -285,7 +381,35 @@ void FindResultsTab::OnClearAll(wxCommandEvent& e)
     Clear();
 }
 
-void FindResultsTab::OnClearAllUI(wxUpdateUIEvent& e) { e.Enable(!m_searchInProgress && !m_sci->IsEmpty()); }
+void FindResultsTab::OnClearAllUI(wxUpdateUIEvent& e) { e.Enable(!m_searchInProgress && !DoIsViewEmpty()); }
+
+void FindResultsTab::OnCollapseAll(wxCommandEvent& e)
+{
+    if(m_view) {
+        m_view->CollapseAll(false);
+    } else {
+        OutputTabWindow::OnCollapseAll(e);
+    }
+}
+
+void FindResultsTab::OnCollapseAllUI(wxUpdateUIEvent& e)
+{
+    if(m_view) {
+        e.Enable(!m_view->IsEmpty());
+    } else {
+        OutputTabWindow::OnCollapseAllUI(e);
+    }
+}
+
+void FindResultsTab::OnWordWrapUI(wxUpdateUIEvent& e)
+{
+    if(m_view) {
+        // the view rows are not wrapped
+        e.Enable(false);
+    } else {
+        OutputTabWindow::OnWordWrapUI(e);
+    }
+}
 
 void FindResultsTab::OnRepeatOutput(wxCommandEvent& e)
 {
@@ -295,7 +419,7 @@ void FindResultsTab::OnRepeatOutput(wxCommandEvent& e)
     SearchThreadST::Get()->PerformSearch(*searchData);
 }
 
-void FindResultsTab::OnRepeatOutputUI(wxUpdateUIEvent& e) { e.Enable(m_sci->GetLength() > 0); }
+void FindResultsTab::OnRepeatOutputUI(wxUpdateUIEvent& e) { e.Enable(!DoIsViewEmpty()); }
 
 void FindResultsTab::OnMouseDClick(wxStyledTextEvent& e)
 {
@@ -308,31 +432,56 @@ void FindResultsTab::OnMouseDClick(wxStyledTextEvent& e)
         m_sci->ToggleFold(toggleLine);
 
     } else {
-        MatchInfo_t::const_iterator m = m_matchInfo.find(clickedLine);
-        if(m != m_matchInfo.end()) { DoOpenSearchResult(m->second, m_sci, m->first); }
+        int index = m_matchInfo.Find(clickedLine);
+        if(index != wxNOT_FOUND) { DoOpenSearchResult(m_matchInfo.Get(index), m_sci, clickedLine); }
     }
 }
 
+void FindResultsTab::OnViewDClick(wxCommandEvent& e)
+{
+    if(e.GetInt() < 0) { return; }
+    int group = m_view->GetGroupAt(e.GetInt());
+    if(group != wxNOT_FOUND) {
+        m_view->ToggleGroup(group);
+        return;
+    }
+
+    int index = m_view->GetMatchAt(e.GetInt());
+    if(index != wxNOT_FOUND) { DoOpenSearchResult(m_matchInfo.Get(index), NULL, wxNOT_FOUND); }
+}
+
+void FindResultsTab::DoSelectAndOpenMatch(size_t index)
+{
+    m_view->SelectMatch(index);
+    DoOpenSearchResult(m_matchInfo.Get(index), NULL, wxNOT_FOUND);
+}
+
 SearchData* FindResultsTab::GetSearchData() { return &m_searchData; }
 
 void FindResultsTab::NextMatch()
 {
+    if(m_view) {
+        // the match after the selected one
+        int sel = m_view->GetSelectedMatch();
+        size_t index = (sel == wxNOT_FOUND) ? 0 : (size_t)sel + 1;
+        if(index < m_matchInfo.GetCount()) {
+            DoSelectAndOpenMatch(index);
+        } else {
+            clMainFrame::Get()->GetStatusBar()->SetMessage(_("Reached the end of the 'Find In Files' results"));
+        }
+        return;
+    }
+
     // locate the last match
     int firstLine = m_sci->MarkerNext(0, 255);
     if(firstLine == wxNOT_FOUND) { firstLine = 0; }
 
-    // We found the last marker
-    for(int i = firstLine + 1; i < m_sci->GetLineCount(); i++) {
-
-        // Find the next match
-        MatchInfo_t::const_iterator iter = m_matchInfo.find(i);
-        if(iter != m_matchInfo.end()) {
-            SearchResult sr = iter->second;
-
-            // open the new searchresult in the editor
-            DoOpenSearchResult(sr, m_sci, i);
-            return;
-        }
+    // We found the last marker, find the next match
+    int index = m_matchInfo.FindNext(firstLine);
+    if(index != wxNOT_FOUND) {
+        // open the new searchresult in the editor
+        DoOpenSearchResult(m_matchInfo.Get(index), m_sci, m_matchInfo.GetViewLine(index));
+        return;
     }
 
     // if we are here, it means we are the end of the search results list, add a status message
@@ -341,22 +490,28 @@ void FindResultsTab::NextMatch()
 
 void FindResultsTab::PrevMatch()
 {
+    if(m_view) {
+        // the match before the selected one
+        int sel = m_view->GetSelectedMatch();
+        int index = (sel == wxNOT_FOUND) ? (int)m_matchInfo.GetCount() - 1 : sel - 1;
+        if(index >= 0) {
+            DoSelectAndOpenMatch(index);
+        } else {
+            clMainFrame::Get()->GetStatusBar()->SetMessage(_("Reached the start of the 'Find In Files' results"));
+        }
+        return;
+    }
+
     // locate the last match
     int firstLine = m_sci->MarkerPrevious(m_sci->GetLineCount() - 1, 255);
     if(firstLine == wxNOT_FOUND) { firstLine = m_sci->GetLineCount(); }
 
-    // We found the last marker
-    for(int i = firstLine - 1; i >= 0; i--) {
-
-        // Find the next match
-        MatchInfo_t::const_iterator iter = m_matchInfo.find(i);
-        if(iter != m_matchInfo.end()) {
-            SearchResult sr = iter->second;
-
-            // open the new searchresult in the editor
-            DoOpenSearchResult(sr, m_sci, i);
-            return;
-        }
+    // We found the last marker, find the previous match
+    int index = m_matchInfo.FindPrev(firstLine);
+    if(index != wxNOT_FOUND) {
+        // open the new searchresult in the editor
+        DoOpenSearchResult(m_matchInfo.Get(index), m_sci, m_matchInfo.GetViewLine(index));
+        return;
     }
     // if we are here, it means we are the top of the search results list, add a status message
     clMainFrame::Get()->GetStatusBar()->SetMessage(_("Reached the start of the 'Find In Files' results"));
@@ -448,6 +603,12 @@ void FindResultsTab::OnStyleNeeded(wxStyledTextEvent& e)
     StyleText(ctrl, e);
 }
 
+void FindResultsTab::OnUpdateUI(wxStyledTextEvent& e)
+{
+    e.Skip();
+    DoFillVisibleIndicators();
+}
+
 void FindResultsTab::StyleText(wxStyledTextCtrl* ctrl, wxStyledTextEvent& e, bool hasSope)
 {
     m_styler->StyleText(ctrl, e, hasSope);
@@ -492,14 +653,16 @@ void FindResultsTab::OnRecentSearches(wxCommandEvent& e)
 void FindResultsTab::SaveSearchData()
 {
     History entry;
-    entry.text = m_sci->GetText();
+    if(m_view) {
+        entry.header = m_view->GetHeader();
+        entry.footer = m_view->GetFooter();
+    } else {
+        entry.text = m_sci->GetText();
+    }
     entry.searchData = m_searchData;
     entry.title = m_searchTitle;
     entry.matchInfo = m_matchInfo;
 
-    // Save the indicators as well
-    entry.indicators = m_indicators;
-
     // search for an entry with the same title
     if(m_history.Contains(entry.title)) { m_history.Remove(entry.title); }
     m_history.PushBack(entry.title, entry);
@@ -510,13 +673,17 @@ void FindResultsTab::LoadSearch(const History& h)
     m_searchData = h.searchData;
     m_matchInfo = h.matchInfo;
     m_searchTitle = h.title;
+    if(m_view) {
+        m_view->Clear();
+        m_view->SetDisplayScope(m_searchData.GetDisplayScope());
+        m_view->SetHeader(h.header);
+        m_view->Rebuild();
+        m_view->SetFooter(h.footer);
+        return;
+    }
     m_sci->SetEditable(true);
     m_sci->ClearAll();
     m_sci->SetText(h.text);
-
-    // restore the indicators
-    std::for_each(h.indicators.begin(), h.indicators.end(),
-                  [&](int pos) { m_sci->IndicatorFillRange(pos, h.title.length()); });
     m_sci->SetFirstVisibleLine(0);
     m_sci->SetEditable(false);
 }
@@ -31,6 +31,7 @@
 #include <vector>
 #include <wx/stc/stc.h>
 
+#include "FindResultsStore.h"
 #include "Notebook.h"
 #include "findinfilesdlg.h"
 #include "outputtabwindow.h"
@@ -38,32 +39,41 @@
 #include "wx_ordered_map.h"
 #include <wx/aui/auibar.h>
 
-// Map between the line numbers and a search results
-typedef std::map<int, SearchResult> MatchInfo_t;
+class FindResultsView;
 
 class FindResultsTab : public OutputTabWindow
 {
 protected:
     SearchData m_searchData;
     wxString m_searchTitle;
-    std::list<int> m_indicators;
     bool m_searchInProgress;
 
     struct History {
         wxString title;
         SearchData searchData;
         wxString text;
-        MatchInfo_t matchInfo;
-        std::list<int> indicators;
+        wxString header;      // the virtual view header
+        wxArrayString footer; // the virtual view summary lines
+        FindResultsStore matchInfo;
         typedef wxOrderedMap<wxString, History> Map_t;
     };
 
     History::Map_t m_history;
 
 protected:
-    MatchInfo_t m_matchInfo;
+    FindResultsStore m_matchInfo;
+
+    // When set, the matches are displayed by this virtual view instead of the text control. The view line of a
+    // match in m_matchInfo is then its index
+    FindResultsView* m_view;
 
     void AppendText(const wxString& line);
+    void DoApplyViewStyles();
+    bool DoIsViewEmpty() const;
+    void DoSelectAndOpenMatch(size_t index);
+    void OnViewDClick(wxCommandEvent& e);
+    wxString DoGetMatchPrefix(const SearchResult& result) const;
+    void DoFillVisibleIndicators();
     void Clear();
     void SaveSearchData();
     void LoadSearch(const History& h);
@@ -75,8 +85,11 @@ protected:
     virtual void OnSearchCancel(wxCommandEvent& e);
     virtual void OnClearAll(wxCommandEvent& e);
     virtual void OnRepeatOutput(wxCommandEvent& e);
+    virtual void OnCollapseAll(wxCommandEvent& e);
 
     virtual void OnClearAllUI(wxUpdateUIEvent& e);
+    virtual void OnCollapseAllUI(wxUpdateUIEvent& e);
+    virtual void OnWordWrapUI(wxUpdateUIEvent& e);
     virtual void OnRecentSearchesUI(wxUpdateUIEvent& e);
     virtual void OnRepeatOutputUI(wxUpdateUIEvent& e);
     virtual void OnMouseDClick(wxStyledTextEvent& e);
@@ -85,6 +98,7 @@ protected:
     virtual void OnStopSearchUI(wxUpdateUIEvent& e);
     virtual void OnHoldOpenUpdateUI(wxUpdateUIEvent& e);
     virtual void OnStyleNeeded(wxStyledTextEvent& e);
+    virtual void OnUpdateUI(wxStyledTextEvent& e);
     SearchData* GetSearchData();
     void DoOpenSearchResult(const SearchResult& result, wxStyledTextCtrl* sci, int markerLine);
     void OnThemeChanged(wxCommandEvent& e);
@@ -92,7 +106,11 @@ protected:
     DECLARE_EVENT_TABLE()
 
 public:
-    FindResultsTab(wxWindow* parent, wxWindowID id, const wxString& name);
+    /**
+     * @param virtualView display the matches in a virtual list grouped by file instead of the text control. The
+     * derived tabs that work on the text control (markers, margins) keep it
+     */
+    FindResultsTab(wxWindow* parent, wxWindowID id, const wxString& name, bool virtualView = false);
     ~FindResultsTab();
 
     virtual void SetStyles(wxStyledTextCtrl* sci);
@@ -51,6 +51,7 @@
 #include "cl_command_event.h"
 #include "cl_config.h"
 #include "cl_defs.h"
+#include "clPerfTrace.h"
 #include "cl_standard_paths.h"
 #include "cl_unredo.h"
 #include "code_completion_manager.h"
@@ -596,6 +597,9 @@ EVT_MENU(wxID_ABOUT, clMainFrame::OnAbout)
 EVT_MENU(XRCID("wxID_REPORT_BUG"), clMainFrame::OnReportIssue)
 EVT_MENU(XRCID("check_for_update"), clMainFrame::OnCheckForUpdate)
 EVT_MENU(XRCID("run_setup_wizard"), clMainFrame::OnRunSetupWizard)
+EVT_MENU(XRCID("record_perf_trace"), clMainFrame::OnRecordPerfTrace)
+EVT_UPDATE_UI(XRCID("record_perf_trace"), clMainFrame::OnRecordPerfTraceUI)
+EVT_MENU(XRCID("save_perf_trace"), clMainFrame::OnSavePerfTrace)
 
 //-------------------------------------------------------
 // Perspective menu
@@ -1714,6 +1718,7 @@ void clMainFrame::OnClose(wxCloseEvent& event)
 
 void clMainFrame::LoadSession(const wxString& sessionName)
 {
+    CL_TRACE_SCOPE("startup", "clMainFrame::LoadSession");
     SessionEntry session;
     if(SessionManager::Get().GetSession(sessionName, session)) {
         wxString wspFile = session.GetWorkspaceName();
@@ -3207,7 +3212,10 @@ void clMainFrame::CompleteInitialization()
 #else
     DebuggerMgr::Get().Initialize(this, EnvironmentConfig::Instance(), ManagerST::Get()->GetInstallDir());
 #endif
-    DebuggerMgr::Get().LoadDebuggers(ManagerST::Get());
+    {
+        CL_TRACE_SCOPE("startup", "DebuggerMgr::LoadDebuggers");
+        DebuggerMgr::Get().LoadDebuggers(ManagerST::Get());
+    }
 
     // Connect some system events
     m_mgr.Connect(wxEVT_AUI_PANE_CLOSE, wxAuiManagerEventHandler(clMainFrame::OnDockablePaneClosed), NULL, this);
@@ -5802,6 +5810,29 @@ void clMainFrame::OnReportIssue(wxCommandEvent& event)
     ::wxLaunchDefaultBrowser("https://github.com/eranif/codelite/issues");
 }
 
+void clMainFrame::OnRecordPerfTrace(wxCommandEvent& event)
+{
+    // Start a new recording each time the trace is enabled
+    if(event.IsChecked()) { clPerfTrace::Get().Clear(); }
+    clPerfTrace::Get().Enable(event.IsChecked());
+}
+
+void clMainFrame::OnRecordPerfTraceUI(wxUpdateUIEvent& event) { event.Check(clPerfTrace::Get().IsEnabled()); }
+
+void clMainFrame::OnSavePerfTrace(wxCommandEvent& event)
+{
+    wxUnusedVar(event);
+    wxString filename = ::wxFileSelector(_("Save trace file"), clStandardPaths::Get().GetUserDataDir(),
+                                         "codelite-trace.json", wxEmptyString, "JSON files (*.json)|*.json",
+                                         wxFD_SAVE | wxFD_OVERWRITE_PROMPT, this);
+    if(filename.IsEmpty()) { return; }
+    if(!clPerfTrace::Get().Save(filename)) {
+        ::wxMessageBox(_("Failed to save trace file:\n") + filename, "CodeLite", wxOK | wxICON_ERROR, this);
+        return;
+    }
+    GetStatusBar()->SetMessage(_("Trace saved to: ") + filename);
+}
+
 void clMainFrame::DoFullscreen(bool b)
 {
     ShowFullScreen(b, wxFULLSCREEN_NOMENUBAR | wxFULLSCREEN_NOTOOLBAR | wxFULLSCREEN_NOBORDER | wxFULLSCREEN_NOCAPTION);
@@ -422,6 +422,9 @@ protected:
     void OnReportIssue(wxCommandEvent& event);
     void OnCheckForUpdate(wxCommandEvent& e);
     void OnRunSetupWizard(wxCommandEvent& e);
+    void OnRecordPerfTrace(wxCommandEvent& event);
+    void OnRecordPerfTraceUI(wxUpdateUIEvent& event);
+    void OnSavePerfTrace(wxCommandEvent& event);
     void OnFileNew(wxCommandEvent& event);
     void OnFileOpen(wxCommandEvent& event);
     void OnFileOpenFolder(wxCommandEvent& event);
@@ -111,7 +111,6 @@ void LocalsTable::OnCreateVariableObj(const DebuggerEventData& event)
             IDebugger* dbgr = DoGetDebugger();
             if(dbgr) DoRefreshItem(dbgr, iter->second, false);
 
-            dbgr->UpdateVariableObject(data->_gdbId, m_DBG_USERR);
             dbgr->ListChildren(data->_gdbId, m_LIST_CHILDS);
             m_listChildItemId[data->_gdbId] = iter->second;
         }
@@ -182,7 +181,7 @@ void LocalsTable::OnVariableObjUpdate(const DebuggerEventData& event)
     IDebugger* dbgr = DoGetDebugger();
     if(dbgr) {
         wxArrayString itemsToRefresh = event.m_varObjUpdateInfo.refreshIds;
-        DoRefreshItemRecursively(dbgr, m_listTable->GetRootItem(), itemsToRefresh);
+        DoRefreshItemRecursively(dbgr, m_listTable->GetRootItem(), itemsToRefresh, updateInfo.values);
     }
 }
 
@@ -280,6 +279,9 @@ void LocalsTable::DoUpdateLocals(const LocalVariables& localsUnSorted, size_t ki
 
     std::map<wxString, wxString> oldValues;
     DoClearNonVariableObjectEntries(itemsNotRemoved, kind, oldValues);
+
+    // The variable objects are kept between stops, so only ask the debugger for the ones that changed
+    if(dbgr && kind == DbgTreeItemData::Locals) { DoUpdateVariableObjects(dbgr); }
     for(size_t i = 0; i < locals.size(); i++) {
 
         // try to replace the
@@ -354,6 +356,18 @@ void LocalsTable::DoUpdateLocals(const LocalVariables& localsUnSorted, size_t ki
     }
 }
 
+void LocalsTable::DoUpdateVariableObjects(IDebugger* dbgr)
+{
+    wxTreeItemIdValue cookie;
+    wxTreeItemId item = m_listTable->GetFirstChild(m_listTable->GetRootItem(), cookie);
+    while(item.IsOk()) {
+        // updating a variable object also updates its children that were already listed
+        wxString gdbId = DoGetGdbId(item);
+        if(!gdbId.IsEmpty()) { dbgr->UpdateVariableObject(gdbId, m_DBG_USERR); }
+        item = m_listTable->GetNextChild(m_listTable->GetRootItem(), cookie);
+    }
+}
+
 void LocalsTable::UpdateFrameInfo()
 {
     if(ManagerST::Get()->DbgGetCurrentFrameInfo().IsValid() &&
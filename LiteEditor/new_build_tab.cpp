@@ -23,11 +23,14 @@
 //////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////
 
+#include "BuildOutputParserThread.h"
 #include "BuildTabTopPanel.h"
 #include "ColoursAndFontsManager.h"
 #include "Notebook.h"
+#include "StringUtils.h"
 #include "attribute_style.h"
 #include "bitmap_loader.h"
+#include "clPerfTrace.h"
 #include "build_settings_config.h"
 #include "buildtabsettingsdata.h"
 #include "clSingleChoiceDialog.h"
@@ -91,6 +94,9 @@ typedef std::map<int, AnnotationInfo> AnnotationInfoByLineMap_t;
 
 #define LEX_GCC_MARKER 1
 
+// The rate at which the build output is flushed to the view (~20 updates per second)
+#define BUILD_OUTPUT_FLUSH_INTERVAL_MS 50
+
 NewBuildTab::NewBuildTab(wxWindow* parent)
     : wxPanel(parent)
     , m_warnCount(0)
@@ -103,8 +109,16 @@ NewBuildTab::NewBuildTab(wxWindow* parent)
     , m_buildInProgress(false)
     , m_maxlineWidth(wxNOT_FOUND)
     , m_lastLineColoured(wxNOT_FOUND)
+    , m_generation(0)
+    , m_buildTime(0)
 {
     SetSize(wxNOT_FOUND, 400);
+    m_outputTimer = new wxTimer(this);
+    Bind(wxEVT_TIMER, &NewBuildTab::OnOutputTimer, this, m_outputTimer->GetId());
+
+    // The output is split into lines and matched against the compiler patterns by this thread
+    m_parserThread = new BuildOutputParserThread(this);
+    m_parserThread->Start();
     m_curError = m_errorsAndWarningsList.end();
     wxBoxSizer* bs = new wxBoxSizer(wxVERTICAL);
     SetSizer(bs);
@@ -144,6 +158,11 @@ NewBuildTab::NewBuildTab(wxWindow* parent)
 
 NewBuildTab::~NewBuildTab()
 {
+    m_parserThread->Stop();
+    wxDELETE(m_parserThread);
+    m_outputTimer->Stop();
+    Unbind(wxEVT_TIMER, &NewBuildTab::OnOutputTimer, this, m_outputTimer->GetId());
+    wxDELETE(m_outputTimer);
     EventNotifier::Get()->Unbind(wxEVT_CL_THEME_CHANGED, &NewBuildTab::OnThemeChanged, this);
     EventNotifier::Get()->Disconnect(wxEVT_SHELL_COMMAND_STARTED, clCommandEventHandler(NewBuildTab::OnBuildStarted),
                                      NULL, this);
@@ -164,9 +183,16 @@ void NewBuildTab::OnBuildEnded(clCommandEvent& e)
     e.Skip();
     CL_DEBUG("Build Ended!");
     m_buildInProgress = false;
+    m_buildTime = m_sw.Time();
 
-    DoProcessOutput(true, false);
+    // flush any pending output. The rest of the work is done in DoBuildEnded(), once the parser thread is done with
+    // the output of this build
+    m_outputTimer->Stop();
+    DoQueueOutput(true);
+}
 
+void NewBuildTab::DoBuildEnded()
+{
     std::vector<clEditor*> editors;
     clMainFrame::Get()->GetMainBook()->GetAllEditors(editors, MainBook::kGetAll_Default);
     for(size_t i = 0; i < editors.size(); i++) {
@@ -177,7 +203,7 @@ void NewBuildTab::OnBuildEnded(clCommandEvent& e)
     wxString problemcount =
         wxString::Format(wxT("%d %s, %d %s"), m_errorCount, _("errors"), m_warnCount, _("warnings"));
     wxString term = problemcount;
-    long elapsed = m_sw.Time() / 1000;
+    long elapsed = m_buildTime / 1000;
     if(elapsed > 10) {
         long sec = elapsed % 60;
         long hours = elapsed / 3600;
@@ -185,15 +211,13 @@ void NewBuildTab::OnBuildEnded(clCommandEvent& e)
         term << wxString::Format(wxT(", %s: %02ld:%02ld:%02ld %s"), _("total time"), hours, minutes, sec, _("seconds"));
     }
 
-    m_output = term;
-    DoProcessOutput(true, true);
-
+    wxArrayString summary;
+    summary.Add("====" + term + "====");
     if(m_buildInterrupted) {
-        wxString InterruptedMsg;
-        InterruptedMsg << _("(Build Cancelled)") << wxT("\n\n");
-        m_output = InterruptedMsg;
-        DoProcessOutput(true, false);
+        summary.Add(_("(Build Cancelled)"));
+        summary.Add(wxEmptyString);
     }
+    DoAppendLines(summary);
 
     // Hide / Show the build tab according to the settings
     DoToggleWindow();
@@ -216,7 +240,11 @@ void NewBuildTab::OnBuildEnded(clCommandEvent& e)
     }
 
     if(m_buildTabSettings.GetBuildPaneScrollDestination() == ScrollToEnd) { m_view->ScrollToEnd(); }
+    DoNotifyBuildEnded();
+}
 
+void NewBuildTab::DoNotifyBuildEnded()
+{
     // notify the plugins that the build has ended
     clBuildEvent buildEvent(wxEVT_BUILD_ENDED);
     buildEvent.SetErrorCount(m_errorCount);
@@ -287,42 +315,31 @@ void NewBuildTab::OnBuildStarted(clCommandEvent& e)
         const wxString& cmpname = clFileSystemWorkspace::Get().GetSettings().GetSelectedConfig()->GetCompiler();
         m_cmp = BuildSettingsConfigST::Get()->GetCompiler(cmpname);
     }
+    m_parserThread->QueueStart(m_generation, e.GetEventType() != wxEVT_SHELL_COMMAND_STARTED_NOCLEAN, m_cmp,
+                               m_cygwinRoot);
 }
 
 void NewBuildTab::OnBuildAddLine(clCommandEvent& e)
 {
     e.Skip(); // Always call skip..
     m_output << e.GetString();
-    DoProcessOutput(false, false);
+
+    // Coalesce the output: instead of updating the view for every chunk we receive, collect the output
+    // and flush it to the view at a fixed rate
+    if(!m_outputTimer->IsRunning()) { m_outputTimer->StartOnce(BUILD_OUTPUT_FLUSH_INTERVAL_MS); }
 }
 
-BuildLineInfo* NewBuildTab::DoProcessLine(const wxString& line)
+void NewBuildTab::CompilePatterns(const Compiler::CmpListInfoPattern& patterns, LINE_SEVERITY severity,
+                                  std::vector<CmpPatternPtr>& compiledPatterns)
 {
-    BuildLineInfo* buildLineInfo = new BuildLineInfo();
-    LINE_SEVERITY severity;
-    // Get the matching regex for this line
-    CmpPatternPtr cmpPatterPtr = GetMatchingRegex(line, severity);
-    buildLineInfo->SetSeverity(severity);
-    BuildLineInfo bli;
-    if(cmpPatterPtr && cmpPatterPtr->Matches(line, bli)) {
-        buildLineInfo->SetFilename(bli.GetFilename());
-        buildLineInfo->SetSeverity(bli.GetSeverity());
-        buildLineInfo->SetLineNumber(bli.GetLineNumber());
-        buildLineInfo->NormalizeFilename(m_directories, m_cygwinRoot);
-        buildLineInfo->SetRegexLineMatch(bli.GetRegexLineMatch());
-        buildLineInfo->SetColumn(bli.GetColumn());
-        if(severity == SV_WARNING) {
-            // Warning
-            m_errorsAndWarningsList.push_back(buildLineInfo);
-            m_warnCount++;
-        } else {
-            // Error
-            m_errorsAndWarningsList.push_back(buildLineInfo);
-            m_errorsList.push_back(buildLineInfo);
-            m_errorCount++;
-        }
+    Compiler::CmpListInfoPattern::const_iterator iter;
+    for(iter = patterns.begin(); iter != patterns.end(); iter++) {
+        CmpPatternPtr compiledPatternPtr(new CmpPattern(new wxRegEx(iter->pattern, wxRE_ADVANCED | wxRE_ICASE),
+                                                        iter->fileNameIndex, iter->lineNumberIndex, iter->columnIndex,
+                                                        severity));
+        compiledPatternPtr->SetRequiredLiteral(CmpPattern::ExtractRequiredLiteral(iter->pattern));
+        if(compiledPatternPtr->GetRegex()->IsValid()) { compiledPatterns.push_back(compiledPatternPtr); }
     }
-    return buildLineInfo;
 }
 
 void NewBuildTab::DoCacheRegexes()
@@ -334,36 +351,18 @@ void NewBuildTab::DoCacheRegexes()
     CompilerPtr cmp = BuildSettingsConfigST::Get()->GetFirstCompiler(cookie);
     while(cmp) {
         CmpPatterns cmpPatterns;
-        const Compiler::CmpListInfoPattern& errPatterns = cmp->GetErrPatterns();
-        const Compiler::CmpListInfoPattern& warnPatterns = cmp->GetWarnPatterns();
-        Compiler::CmpListInfoPattern::const_iterator iter;
-        for(iter = errPatterns.begin(); iter != errPatterns.end(); iter++) {
-
-            CmpPatternPtr compiledPatternPtr(new CmpPattern(new wxRegEx(iter->pattern, wxRE_ADVANCED | wxRE_ICASE),
-                                                            iter->fileNameIndex, iter->lineNumberIndex,
-                                                            iter->columnIndex, SV_ERROR));
-            if(compiledPatternPtr->GetRegex()->IsValid()) { cmpPatterns.errorsPatterns.push_back(compiledPatternPtr); }
-        }
-
-        for(iter = warnPatterns.begin(); iter != warnPatterns.end(); iter++) {
-
-            CmpPatternPtr compiledPatternPtr(new CmpPattern(new wxRegEx(iter->pattern, wxRE_ADVANCED | wxRE_ICASE),
-                                                            iter->fileNameIndex, iter->lineNumberIndex,
-                                                            iter->columnIndex, SV_WARNING));
-            if(compiledPatternPtr->GetRegex()->IsValid()) { cmpPatterns.warningPatterns.push_back(compiledPatternPtr); }
-        }
-
+        CompilePatterns(cmp->GetErrPatterns(), SV_ERROR, cmpPatterns.errorsPatterns);
+        CompilePatterns(cmp->GetWarnPatterns(), SV_WARNING, cmpPatterns.warningPatterns);
         m_cmpPatterns.insert(std::make_pair(cmp->GetName(), cmpPatterns));
         cmp = BuildSettingsConfigST::Get()->GetNextCompiler(cookie);
     }
 }
 
-bool NewBuildTab::DoGetCompilerPatterns(const wxString& compilerName, CmpPatterns& patterns)
+const CmpPatterns* NewBuildTab::DoGetCompilerPatterns(const wxString& compilerName) const
 {
-    MapCmpPatterns_t::iterator iter = m_cmpPatterns.find(compilerName);
-    if(iter == m_cmpPatterns.end()) { return false; }
-    patterns = iter->second;
-    return true;
+    MapCmpPatterns_t::const_iterator iter = m_cmpPatterns.find(compilerName);
+    if(iter == m_cmpPatterns.end()) { return nullptr; }
+    return &(iter->second);
 }
 
 void NewBuildTab::DoClear()
@@ -372,7 +371,6 @@ void NewBuildTab::DoClear()
     m_lastLineColoured = wxNOT_FOUND;
     m_maxlineWidth = wxNOT_FOUND;
     m_buildInterrupted = false;
-    m_directories.Clear();
     m_buildInfoPerFile.clear();
     m_warnCount = 0;
     m_errorCount = 0;
@@ -380,6 +378,9 @@ void NewBuildTab::DoClear()
     m_errorsList.clear();
     m_cmpPatterns.clear();
 
+    // The output parsed for the view we are clearing is discarded when it arrives
+    ++m_generation;
+
     // Delete all the user data
     std::for_each(m_viewData.begin(), m_viewData.end(), [&](std::pair<int, BuildLineInfo*> p) { delete p.second; });
     m_viewData.clear();
@@ -481,25 +482,6 @@ void NewBuildTab::MarkEditor(clEditor* editor)
     editor->Refresh();
 }
 
-void NewBuildTab::DoSearchForDirectory(const wxString& line)
-{
-    // Check for makefile directory changes lines
-    if(line.Contains(wxT("Entering directory `"))) {
-        wxString currentDir = line.AfterFirst(wxT('`'));
-        currentDir = currentDir.BeforeLast(wxT('\''));
-
-        // Collect the m_baseDir
-        m_directories.Add(currentDir);
-
-    } else if(line.Contains(wxT("Entering directory '"))) {
-        wxString currentDir = line.AfterFirst(wxT('\''));
-        currentDir = currentDir.BeforeLast(wxT('\''));
-
-        // Collect the m_baseDir
-        m_directories.Add(currentDir);
-    }
-}
-
 void NewBuildTab::OnWorkspaceClosed(wxCommandEvent& e)
 {
     e.Skip();
@@ -514,70 +496,89 @@ void NewBuildTab::OnWorkspaceLoaded(wxCommandEvent& e)
     InitView();
 }
 
-void NewBuildTab::DoProcessOutput(bool compilationEnded, bool isSummaryLine)
+void NewBuildTab::DoQueueOutput(bool buildEnded)
+{
+    if(!buildEnded && m_output.IsEmpty()) { return; }
+    m_parserThread->QueueOutput(m_generation, m_output, buildEnded);
+    m_output.Clear();
+}
+
+void NewBuildTab::OnBuildOutputParsed(wxSharedPtr<BuildOutputBatch> batch)
 {
-    wxUnusedVar(isSummaryLine);
-    if(!compilationEnded && m_output.Find(wxT("\n")) == wxNOT_FOUND) {
-        // still dont have a complete line
+    if(batch->generation != m_generation) {
+        // the view was cleared after this output was queued. The plugins are still told that the build ended
+        if(batch->buildEnded) { DoNotifyBuildEnded(); }
         return;
     }
 
-    wxArrayString lines = ::wxStringTokenize(m_output, wxT("\n"), wxTOKEN_RET_DELIMS);
-    m_output.Clear();
+    DoAppendBatch(*batch);
+    if(batch->buildEnded) { DoBuildEnded(); }
+}
 
-    // Process only completed lines (i.e. a line that ends with '\n')
+void NewBuildTab::DoAppendLines(const wxArrayString& lines)
+{
+    BuildOutputBatch batch;
     for(size_t i = 0; i < lines.GetCount(); ++i) {
-        if(!compilationEnded && !lines.Item(i).EndsWith(wxT("\n"))) {
-            m_output << lines.Item(i);
-            return;
-        }
+        batch.lines.push_back(new BuildLineInfo());
+        batch.text << lines.Item(i) << "\n";
+        if(lines.Item(i).length() > batch.longestLine.length()) { batch.longestLine = lines.Item(i); }
+    }
+    DoAppendBatch(batch);
+}
 
-        wxString buildLine = lines.Item(i); //.Trim().Trim(false);
-        // If this is a line similar to 'Entering directory `'
-        // add the path in the directories array
-        DoSearchForDirectory(buildLine);
-        BuildLineInfo* buildLineInfo = DoProcessLine(buildLine);
+void NewBuildTab::DoAppendBatch(BuildOutputBatch& batch)
+{
+    if(batch.lines.empty()) { return; }
+    CL_TRACE_SCOPE("build", "NewBuildTab::DoAppendBatch");
+
+    // Every line of the batch is one line of the view: the line numbers are taken from the view itself
+    int firstLine = m_view->GetLineCount() - 1; // -1 because the view always has 1 extra "\n"
+    for(size_t i = 0; i < batch.lines.size(); ++i) {
+        // the view owns the line info from now on
+        BuildLineInfo* buildLineInfo = batch.lines[i];
+        batch.lines[i] = nullptr;
+
+        if(buildLineInfo->GetSeverity() == SV_WARNING) {
+            m_errorsAndWarningsList.push_back(buildLineInfo);
+            m_warnCount++;
+        } else if(buildLineInfo->GetSeverity() == SV_ERROR) {
+            m_errorsAndWarningsList.push_back(buildLineInfo);
+            m_errorsList.push_back(buildLineInfo);
+            m_errorCount++;
+        }
 
         // keep the line info
         if(buildLineInfo->GetFilename().IsEmpty() == false) {
             m_buildInfoPerFile.insert(std::make_pair(buildLineInfo->GetFilename(), buildLineInfo));
         }
 
-        if(isSummaryLine) {
-            buildLine.Trim();
-            buildLine.Prepend("====");
-            buildLine.Append("====");
-            buildLineInfo->SetSeverity(SV_NONE);
-        }
-
         // Keep the line number in the build tab
-        buildLineInfo->SetLineInBuildTab(m_view->GetLineCount() - 1); // -1 because the view always has 1 extra "\n"
+        buildLineInfo->SetLineInBuildTab(firstLine + (int)i);
         // Store the line info *before* we add the text
         // it is needed in the OnStyle function
         m_viewData.insert(std::make_pair(buildLineInfo->GetLineInBuildTab(), buildLineInfo));
+    }
 
-        m_view->SetEditable(true);
-        buildLine.Trim();
-        wxString modText;
-        ::clStripTerminalColouring(buildLine, modText);
-
-        int curline = m_view->GetLineCount() - 1;
-        m_view->AppendText(modText + "\n");
-
-        // get the newly added line width
-        int endPosition = m_view->GetLineEndPosition(curline); // get character position from begin
-        int beginPosition = m_view->PositionFromLine(curline); // and end of line
+    // All the lines are appended to the view as a single batch: updating the view per line
+    // (append, measure, scroll) is what makes the IDE unresponsive on large builds
+    m_view->SetEditable(true);
+    m_view->AppendText(batch.text);
 
-        wxPoint beginPos = m_view->PointFromPosition(beginPosition);
-        wxPoint endPos = m_view->PointFromPosition(endPosition);
+    // update the scroll width using the longest line of this batch
+    int curLen = m_view->TextWidth(LEX_GCC_DEFAULT, batch.longestLine) + 10;
+    if(curLen > m_maxlineWidth) {
+        m_maxlineWidth = curLen;
+        m_view->SetScrollWidth(m_maxlineWidth);
+    }
+    m_view->SetEditable(false);
 
-        int curLen = (endPos.x - beginPos.x) + 10;
-        m_maxlineWidth = wxMax(m_maxlineWidth, curLen);
-        if(m_maxlineWidth > 0) { m_view->SetScrollWidth(m_maxlineWidth); }
-        m_view->SetEditable(false);
+    if(clConfig::Get().Read(kConfigBuildAutoScroll, true)) { m_view->ScrollToEnd(); }
+}
 
-        if(clConfig::Get().Read(kConfigBuildAutoScroll, true)) { m_view->ScrollToEnd(); }
-    }
+void NewBuildTab::OnOutputTimer(wxTimerEvent& event)
+{
+    wxUnusedVar(event);
+    DoQueueOutput(false);
 }
 
 void NewBuildTab::CenterLineInView(int line)
@@ -801,7 +802,7 @@ void NewBuildTab::ScrollToBottom() { m_view->ScrollToEnd(); }
 void NewBuildTab::AppendLine(const wxString& text)
 {
     m_output << text;
-    DoProcessOutput(false, false);
+    DoQueueOutput(false);
 }
 
 void NewBuildTab::OnStyleNeeded(wxStyledTextEvent& event)
@@ -961,10 +962,15 @@ void NewBuildTab::ColourOutput()
         m_view->StartStyling(startPos, 0x1f);
 #endif
 
-        // Run the regexes
-        wxString lineText = m_view->GetLine(i);
+        // Use the severity computed when the line was added. Only run the regexes for lines we know nothing about
         LINE_SEVERITY severity;
-        GetMatchingRegex(lineText, severity);
+        std::map<int, BuildLineInfo*>::const_iterator iter = m_viewData.find(i);
+        if(iter != m_viewData.end()) {
+            severity = iter->second->GetSeverity();
+        } else {
+            wxString lineText = m_view->GetLine(i);
+            GetMatchingRegex(lineText, severity);
+        }
         switch(severity) {
         case SV_WARNING:
             m_view->SetStyling((lineEndPos - startPos), LEX_GCC_WARNING);
@@ -987,9 +993,18 @@ void NewBuildTab::ColourOutput()
     m_lastLineColoured = untilLine;
 }
 
-CmpPatternPtr NewBuildTab::GetMatchingRegex(const wxString& lineText, LINE_SEVERITY& severity)
+CmpPatternPtr NewBuildTab::GetMatchingRegex(const wxString& lineText, LINE_SEVERITY& severity, BuildLineInfo* lineInfo)
 {
-    if(lineText.Lower().Contains("entering directory") || lineText.Lower().Contains("leaving directory")) {
+    const CmpPatterns* cmpPatterns = m_cmp ? DoGetCompilerPatterns(m_cmp->GetName()) : nullptr;
+    return MatchPatterns(cmpPatterns, lineText, severity, lineInfo);
+}
+
+CmpPatternPtr NewBuildTab::MatchPatterns(const CmpPatterns* cmpPatterns, const wxString& lineText,
+                                         LINE_SEVERITY& severity, BuildLineInfo* lineInfo)
+{
+    // Lower the line once: it is used for the directory check and for the patterns pre-filtering
+    wxString lowerLine = lineText.Lower();
+    if(lowerLine.Contains("entering directory") || lowerLine.Contains("leaving directory")) {
         severity = SV_DIR_CHANGE;
         return NULL;
 
@@ -999,37 +1014,34 @@ CmpPatternPtr NewBuildTab::GetMatchingRegex(const wxString& lineText, LINE_SEVER
 
     } else {
 
-        // Find *warnings* first
-        bool isWarning = false;
-
-        if(!m_cmp) {
-            severity = SV_NONE;
-            return NULL;
-        }
-
-        CmpPatterns cmpPatterns;
-        if(!DoGetCompilerPatterns(m_cmp->GetName(), cmpPatterns)) {
+        if(!cmpPatterns) {
             severity = SV_NONE;
             return NULL;
         }
 
-        // If it is not an error, maybe it's a warning
-        for(size_t i = 0; i < cmpPatterns.warningPatterns.size(); i++) {
-            CmpPatternPtr cmpPatterPtr = cmpPatterns.warningPatterns.at(i);
+        // Find *warnings* first
+        // Patterns whose required literal does not appear in the line can not match it, so we skip them without
+        // running the regex
+        for(size_t i = 0; i < cmpPatterns->warningPatterns.size(); i++) {
+            CmpPatternPtr cmpPatterPtr = cmpPatterns->warningPatterns.at(i);
+            if(!cmpPatterPtr->MayMatch(lowerLine)) { continue; }
             BuildLineInfo bli;
             if(cmpPatterPtr->Matches(lineText, bli)) {
                 severity = SV_WARNING;
+                if(lineInfo) { *lineInfo = bli; }
                 return cmpPatterPtr;
             }
         }
-        if(!isWarning) {
-            for(size_t i = 0; i < cmpPatterns.errorsPatterns.size(); i++) {
-                BuildLineInfo bli;
-                CmpPatternPtr cmpPatterPtr = cmpPatterns.errorsPatterns.at(i);
-                if(cmpPatterPtr->Matches(lineText, bli)) {
-                    severity = SV_ERROR;
-                    return cmpPatterPtr;
-                }
+
+        // If it is not a warning, maybe it's an error
+        for(size_t i = 0; i < cmpPatterns->errorsPatterns.size(); i++) {
+            CmpPatternPtr cmpPatterPtr = cmpPatterns->errorsPatterns.at(i);
+            if(!cmpPatterPtr->MayMatch(lowerLine)) { continue; }
+            BuildLineInfo bli;
+            if(cmpPatterPtr->Matches(lineText, bli)) {
+                severity = SV_ERROR;
+                if(lineInfo) { *lineInfo = bli; }
+                return cmpPatterPtr;
             }
         }
     }
@@ -1048,6 +1060,12 @@ void NewBuildTab::OnIdle(wxIdleEvent& event)
 ////////////////////////////////////////////
 // CmpPatter
 
+wxString CmpPattern::ExtractRequiredLiteral(const wxString& pattern)
+{
+    // the patterns are compiled with wxRE_ICASE
+    return StringUtils::GetRegexRequiredLiteral(pattern).Lower();
+}
+
 bool CmpPattern::Matches(const wxString& line, BuildLineInfo& lineInfo)
 {
     long fidx, lidx;
@@ -32,6 +32,7 @@
 #include <wx/fdrepdlg.h>
 #include <wx/dataview.h>
 #include <wx/stopwatch.h>
+#include <wx/timer.h>
 #include <wx/panel.h> // Base class: wxPanel
 #include "buildtabsettingsdata.h"
 #include "compiler.h"
@@ -39,8 +40,11 @@
 #include <wx/regex.h>
 #include "cl_command_event.h"
 #include <wx/stc/stc.h>
+#include <wx/sharedptr.h>
 
 class wxDataViewListCtrl;
+class BuildOutputParserThread;
+struct BuildOutputBatch;
 
 ///////////////////////////////
 // Holds the information about
@@ -103,6 +107,7 @@ protected:
     wxString m_lineIndex;
     wxString m_colIndex;
     LINE_SEVERITY m_severity;
+    wxString m_requiredLiteral;
 
 public:
     CmpPattern(wxRegEx* re, const wxString& file, const wxString& line, const wxString& column, LINE_SEVERITY severity)
@@ -122,6 +127,22 @@ public:
      */
     bool Matches(const wxString& line, BuildLineInfo& lineInfo);
 
+    /**
+     * @brief a cheap pre-filter for Matches(): return false if the line can not match this pattern
+     * because it does not contain the pattern required literal
+     * @param lowerLine the line, in lower case
+     */
+    bool MayMatch(const wxString& lowerLine) const
+    {
+        return m_requiredLiteral.IsEmpty() || lowerLine.Contains(m_requiredLiteral);
+    }
+
+    /**
+     * @brief return the longest literal (in lower case) that must appear in any line matched by
+     * the regular expression "pattern". Return an empty string if no such literal can be determined
+     */
+    static wxString ExtractRequiredLiteral(const wxString& pattern);
+
     void SetFileIndex(const wxString& fileIndex) { this->m_fileIndex = fileIndex; }
     void SetLineIndex(const wxString& lineIndex) { this->m_lineIndex = lineIndex; }
     void SetRegex(wxRegEx* regex) { this->m_regex = regex; }
@@ -130,6 +151,8 @@ public:
     const wxString& GetLineIndex() const { return m_lineIndex; }
     void SetColIndex(const wxString& colIndex) { this->m_colIndex = colIndex; }
     const wxString& GetColIndex() const { return m_colIndex; }
+    void SetRequiredLiteral(const wxString& requiredLiteral) { this->m_requiredLiteral = requiredLiteral; }
+    const wxString& GetRequiredLiteral() const { return m_requiredLiteral; }
     wxRegEx* GetRegex() { return m_regex; }
     LINE_SEVERITY GetSeverity() const { return m_severity; }
 };
@@ -164,7 +187,6 @@ class NewBuildTab : public wxPanel
     BuildTabSettingsData::ShowBuildPane m_showMe;
     wxStopWatch m_sw;
     MultimapBuildInfo_t m_buildInfoPerFile;
-    wxArrayString m_directories;
     bool m_skipWarnings;
     BuildpaneScrollTo m_buildpaneScrollTo;
     BuildInfoList_t m_errorsAndWarningsList;
@@ -175,15 +197,21 @@ class NewBuildTab : public wxPanel
     std::map<int, BuildLineInfo*> m_viewData;
     int m_maxlineWidth;
     int m_lastLineColoured;
+    wxTimer* m_outputTimer;
+    BuildOutputParserThread* m_parserThread;
+    size_t m_generation; // incremented when the view is cleared, the output parsed before is discarded
+    long m_buildTime;
 
 protected:
     void InitView(const wxString& theme = "");
     void CenterLineInView(int line);
     void DoCacheRegexes();
-    BuildLineInfo* DoProcessLine(const wxString& line);
-    void DoProcessOutput(bool compilationEnded, bool isSummaryLine);
-    void DoSearchForDirectory(const wxString& line);
-    bool DoGetCompilerPatterns(const wxString& compilerName, CmpPatterns& patterns);
+    void DoQueueOutput(bool buildEnded);
+    void DoAppendBatch(BuildOutputBatch& batch);
+    void DoAppendLines(const wxArrayString& lines);
+    void DoBuildEnded();
+    void DoNotifyBuildEnded();
+    const CmpPatterns* DoGetCompilerPatterns(const wxString& compilerName) const;
     void DoClear();
     void MarkEditor(clEditor* editor);
     void DoToggleWindow();
@@ -191,7 +219,8 @@ protected:
     wxFont DoGetFont() const;
     void DoCentreErrorLine(BuildLineInfo* bli, clEditor* editor, bool centerLine);
     void ColourOutput();
-    CmpPatternPtr GetMatchingRegex(const wxString& lineText, LINE_SEVERITY& severity);
+    CmpPatternPtr GetMatchingRegex(const wxString& lineText, LINE_SEVERITY& severity,
+                                   BuildLineInfo* lineInfo = nullptr);
 
 public:
     NewBuildTab(wxWindow* parent);
@@ -210,6 +239,26 @@ public:
     wxString GetBuildContent() const;
     void AppendLine(const wxString& text);
 
+    /**
+     * @brief called by the BuildOutputParserThread with the lines it parsed
+     */
+    void OnBuildOutputParsed(wxSharedPtr<BuildOutputBatch> batch);
+
+    /**
+     * @brief compile 'patterns' into 'compiledPatterns'. The invalid patterns are skipped
+     */
+    static void CompilePatterns(const Compiler::CmpListInfoPattern& patterns, LINE_SEVERITY severity,
+                                std::vector<CmpPatternPtr>& compiledPatterns);
+
+    /**
+     * @brief return the pattern of 'cmpPatterns' that matches 'lineText' (warnings are tried first), or NULL
+     * @param cmpPatterns the patterns of the compiler. When NULL, only the directory changes are detected
+     * @param severity [output]
+     * @param lineInfo [output] the information extracted by the matching pattern
+     */
+    static CmpPatternPtr MatchPatterns(const CmpPatterns* cmpPatterns, const wxString& lineText,
+                                       LINE_SEVERITY& severity, BuildLineInfo* lineInfo = nullptr);
+
 protected:
     void OnThemeChanged(wxCommandEvent& event);
     void OnBuildStarted(clCommandEvent& e);
@@ -227,6 +276,7 @@ protected:
     void OnStyleNeeded(wxStyledTextEvent& event);
     void OnHotspotClicked(wxStyledTextEvent& event);
     void OnIdle(wxIdleEvent& event);
+    void OnOutputTimer(wxTimerEvent& event);
 };
 
 #endif // NEWBUILDTAB_H
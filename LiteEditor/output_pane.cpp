@@ -116,7 +116,7 @@ void OutputPane::CreateGUIControls()
 #endif
 
     // Find in files
-    m_findResultsTab = new FindResultsTab(m_book, wxID_ANY, wxGetTranslation(FIND_IN_FILES_WIN));
+    m_findResultsTab = new FindResultsTab(m_book, wxID_ANY, wxGetTranslation(FIND_IN_FILES_WIN), true);
     m_book->AddPage(m_findResultsTab, wxGetTranslation(FIND_IN_FILES_WIN), false, bmpLoader->LoadBitmap(wxT("find")));
     m_tabs.insert(
         std::make_pair(wxGetTranslation(FIND_IN_FILES_WIN),
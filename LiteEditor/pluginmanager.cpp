@@ -60,6 +60,7 @@
 #include <wx/tokenzr.h>
 #include <wx/toolbook.h>
 #include "clInfoBar.h"
+#include "clPerfTrace.h"
 
 PluginManager* PluginManager::Get()
 {
@@ -70,6 +71,9 @@ PluginManager* PluginManager::Get()
 
 void PluginManager::UnLoad()
 {
+    // Wait for the plugins background initialisation before we delete them
+    WaitForBackgroundInitialisation();
+
     // Before we unload the plugins, store the list of visible workspace tabs
     {
         wxArrayString visibleTabs;
@@ -103,6 +107,7 @@ PluginManager::~PluginManager() {}
 
 PluginManager::PluginManager()
     : m_bmpLoader(NULL)
+    , m_backgroundInitThread(nullptr)
 {
     m_menusToBeHooked.insert(MenuTypeFileExplorer);
     m_menusToBeHooked.insert(MenuTypeFileView_Workspace);
@@ -112,8 +117,35 @@ PluginManager::PluginManager()
     m_menusToBeHooked.insert(MenuTypeEditor);
 }
 
+void PluginManager::StartBackgroundInitialisation()
+{
+    WaitForBackgroundInitialisation();
+
+    std::vector<IPlugin*> plugins;
+    for(const auto& vt : m_plugins) {
+        plugins.push_back(vt.second);
+    }
+    if(plugins.empty()) { return; }
+
+    m_backgroundInitThread = new std::thread([plugins]() {
+        CL_TRACE_THREAD_NAME("Plugins background initialisation");
+        for(IPlugin* plugin : plugins) {
+            CL_TRACE_SCOPE("plugins", plugin->GetShortName() + " (background)");
+            plugin->InitialiseInBackground();
+        }
+    });
+}
+
+void PluginManager::WaitForBackgroundInitialisation()
+{
+    if(!m_backgroundInitThread) { return; }
+    m_backgroundInitThread->join();
+    wxDELETE(m_backgroundInitThread);
+}
+
 void PluginManager::Load()
 {
+    CL_TRACE_SCOPE("startup", "PluginManager::Load");
     wxString ext;
 #if defined(__WXGTK__)
     ext = wxT("so");
@@ -176,6 +208,7 @@ void PluginManager::Load()
             }
 #endif
 
+            CL_TRACE_SCOPE("plugins", wxFileName(fileName).GetName());
             clDynamicLibrary* dl = new clDynamicLibrary();
             if(!dl->Load(fileName)) {
                 CL_ERROR(wxT("Failed to load plugin's dll: ") + fileName);
@@ -577,7 +610,10 @@ bool PluginManager::IsShutdownInProgress() const { return ManagerST::Get()->IsSh
 
 BitmapLoader* PluginManager::GetStdIcons()
 {
-    if(!m_bmpLoader) { m_bmpLoader = BitmapLoader::Create(); }
+    if(!m_bmpLoader) {
+        CL_TRACE_SCOPE("startup", "BitmapLoader::Create");
+        m_bmpLoader = BitmapLoader::Create();
+    }
     return m_bmpLoader;
 }
 
@@ -36,6 +36,7 @@
 #include "project.h"
 #include <set>
 #include <map>
+#include <thread>
 #include "plugindata.h"
 #include "debugger.h"
 
@@ -58,6 +59,7 @@ class PluginManager : public IManager
     std::set<MenuType> m_menusToBeHooked;
     std::map<wxString, wxString> m_backticks;
     wxAuiManager* m_dockingManager;
+    std::thread* m_backgroundInitThread;
 
 private:
     PluginManager();
@@ -70,6 +72,17 @@ public:
     virtual void UnLoad();
     virtual void EnableToolbars();
 
+    /**
+     * @brief call IPlugin::InitialiseInBackground() of every loaded plugin, in order, on a worker thread.
+     * Called once the main frame is shown
+     */
+    void StartBackgroundInitialisation();
+
+    /**
+     * @brief wait for the plugins background initialisation to complete
+     */
+    void WaitForBackgroundInitialisation();
+
     /**
      * \brief return a map of all loaded plugins
      */
@@ -44,12 +44,18 @@
 #include "replaceinfilespanel.h"
 #include <wx/dcgraph.h>
 #include <wx/dcmemory.h>
+#include <wx/fontmap.h>
 #include <wx/renderer.h>
 
+// How often the progress of the replace is updated
+#define REPLACE_PROGRESS_INTERVAL_MS 100
+
 ReplaceInFilesPanel::ReplaceInFilesPanel(wxWindow* parent, int id, const wxString& name)
     : FindResultsTab(parent, id, name)
 {
     clThemeUpdater::Get().RegisterWindow(this);
+    m_replaceTimer = new wxTimer(this);
+    Bind(wxEVT_TIMER, &ReplaceInFilesPanel::OnReplaceTimer, this, m_replaceTimer->GetId());
     Bind(wxEVT_UPDATE_UI, &ReplaceInFilesPanel::OnHoldOpenUpdateUI, this, XRCID("hold_pane_open"));
     wxBoxSizer* horzSizer = new wxBoxSizer(wxHORIZONTAL);
 
@@ -99,11 +105,26 @@ ReplaceInFilesPanel::ReplaceInFilesPanel(wxWindow* parent, int id, const wxStrin
     mainSizer->Layout();
 }
 
-ReplaceInFilesPanel::~ReplaceInFilesPanel() { clThemeUpdater::Get().UnRegisterWindow(this); }
+ReplaceInFilesPanel::~ReplaceInFilesPanel()
+{
+    m_replaceTimer->Stop();
+    Unbind(wxEVT_TIMER, &ReplaceInFilesPanel::OnReplaceTimer, this, m_replaceTimer->GetId());
+    wxDELETE(m_replaceTimer);
+    clThemeUpdater::Get().UnRegisterWindow(this);
+}
 
 void ReplaceInFilesPanel::OnSearchStart(wxCommandEvent& e)
 {
     e.Skip();
+    if(m_engine.IsRunning()) {
+        // the results are about to be cleared, stop replacing
+        m_replaceTimer->Stop();
+        m_engine.Cancel();
+        m_engine.Wait();
+        m_engine.GetFiles().clear();
+        m_progress->SetValue(0);
+    }
+
     // set the "Replace With" field with the user value
     SearchData* data = (SearchData*)e.GetClientData();
     m_replaceWith->ChangeValue(data->GetReplaceWith());
@@ -120,8 +141,8 @@ void ReplaceInFilesPanel::OnSearchMatch(wxCommandEvent& e)
 {
     e.Skip();
     FindResultsTab::OnSearchMatch(e);
-    if(m_matchInfo.size() != 1 || !m_replaceWith->GetValue().IsEmpty()) return;
-    m_replaceWith->SetValue(m_matchInfo.begin()->second.GetFindWhat());
+    if(m_matchInfo.GetCount() != 1 || !m_replaceWith->GetValue().IsEmpty()) return;
+    m_replaceWith->SetValue(m_matchInfo.GetFindWhat());
     m_replaceWith->SetFocus();
 }
 
@@ -144,7 +165,7 @@ void ReplaceInFilesPanel::OnSearchEnded(wxCommandEvent& e)
 void ReplaceInFilesPanel::OnMarginClick(wxStyledTextEvent& e)
 {
     int line = m_sci->LineFromPosition(e.GetPosition());
-    if(m_matchInfo.find(line) == m_matchInfo.end()) {
+    if(m_matchInfo.Find(line) == wxNOT_FOUND) {
         FindResultsTab::OnMarginClick(e);
 
     } else if(m_sci->MarkerGet(line) & 7 << 0x7) {
@@ -156,177 +177,202 @@ void ReplaceInFilesPanel::OnMarginClick(wxStyledTextEvent& e)
 
 void ReplaceInFilesPanel::OnMarkAll(wxCommandEvent& e)
 {
-    MatchInfo_t::const_iterator i = m_matchInfo.begin();
-    for(; i != m_matchInfo.end(); ++i) {
-        if(m_sci->MarkerGet(i->first) & 7 << 0x7) continue;
-        m_sci->MarkerAdd(i->first, 0x7);
+    for(size_t i = 0; i < m_matchInfo.GetCount(); ++i) {
+        int line = m_matchInfo.GetViewLine(i);
+        if(m_sci->MarkerGet(line) & 7 << 0x7) continue;
+        m_sci->MarkerAdd(line, 0x7);
     }
 }
 
-void ReplaceInFilesPanel::OnMarkAllUI(wxUpdateUIEvent& e) { e.Enable((m_sci->GetLength() > 0) && !m_searchInProgress); }
+void ReplaceInFilesPanel::OnMarkAllUI(wxUpdateUIEvent& e)
+{
+    e.Enable((m_sci->GetLength() > 0) && !m_searchInProgress && !m_engine.IsRunning());
+}
 void ReplaceInFilesPanel::OnUnmarkAll(wxCommandEvent& e) { m_sci->MarkerDeleteAll(0x7); }
 void ReplaceInFilesPanel::OnUnmarkAllUI(wxUpdateUIEvent& e)
 {
-    e.Enable((m_sci->GetLength() > 0) && !m_searchInProgress);
+    e.Enable((m_sci->GetLength() > 0) && !m_searchInProgress && !m_engine.IsRunning());
 }
 
-void ReplaceInFilesPanel::DoSaveResults(wxStyledTextCtrl* sci, std::map<int, SearchResult>::iterator begin,
-                                        std::map<int, SearchResult>::iterator end)
+void ReplaceInFilesPanel::DoReplaceInEditor(clEditor* editor, ReplaceInFilesEngine::File& file,
+                                            const wxString& replaceWith)
 {
-    if(!sci || begin == end) return;
-    bool ok = true;
-    if(dynamic_cast<clEditor*>(sci) == NULL) {
-        // it's a temp editor, check if we have any changes to save
-        if(sci->GetModify() && !WriteFileWithBackup(begin->second.GetFileName(), sci->GetText(), false)) {
-            wxMessageBox(_("Failed to save file:\n") + begin->second.GetFileName(), _("CodeLite - Replace"),
-                         wxICON_ERROR | wxOK);
-            clDEBUG() << "Replace: Failed to write file" << begin->second.GetFileName();
-            ok = false;
+    // Replace from the last match to the first one: the matches before the replaced one do not move.
+    // All the replacements of the file are undone at once
+    editor->BeginUndoAction();
+    for(int i = (int)file.m_matches.size() - 1; i >= 0; --i) {
+        ReplaceInFilesEngine::Match& match = file.m_matches[i];
+        if(!match.m_selected) continue;
+
+        const SearchResult& result = match.m_result;
+        int pos = editor->PositionFromLine(result.GetLineNumber() - 1);
+        if(pos < 0) {
+            // invalid line number
+            continue;
         }
+        pos += result.GetColumn();
 
-        if(sci && ok) {
-            // Keep the modified file name
-            m_filesModified.Add(begin->second.GetFileName());
-        }
+        // the editor content may differ from the file that was searched, make sure the match is still there
+        wxString text = result.GetPattern().Mid(result.GetColumnInChars(), result.GetLenInChars());
+        if(editor->GetTextRange(pos, pos + result.GetLen()) != text) continue;
 
-        delete sci;
-    }
-    for(; begin != end; begin++) {
-        if((m_sci->MarkerGet(begin->first) & 7 << 0x7) == 1 << 0x7) { m_sci->MarkerAdd(begin->first, ok ? 0x9 : 0x8); }
+        editor->SetTargetStart(pos);
+        editor->SetTargetEnd(pos + result.GetLen());
+        editor->ReplaceTarget(replaceWith);
+        match.m_replaced = true;
     }
+    editor->EndUndoAction();
+    file.m_status = ReplaceInFilesEngine::kFileReplaced;
+
+    ReplaceInFilesEngine::UpdateMatches(file, replaceWith, [&](const SearchResult& result) {
+        wxString line = editor->GetLine(result.GetLineNumber() - 1);
+        if(line.EndsWith("\n")) { line.RemoveLast(); }
+        return line;
+    });
 }
 
-wxStyledTextCtrl* ReplaceInFilesPanel::DoGetEditor(const wxString& fileName)
+void ReplaceInFilesPanel::DoApplyResults(const ReplaceInFilesEngine::File& file)
 {
-    // look for open editor first
-    wxStyledTextCtrl* sci = clMainFrame::Get()->GetMainBook()->FindEditor(fileName);
-    if(sci) {
-        // FIXME: if editor is already modified, the found locations may not be accurate
-        return sci;
-    }
-
-    // not open for editing, so make our own temp editor
-    wxString content;
-    if(!ReadFileWithConversion(fileName, content)) {
-        wxMessageBox(_("Failed to open file:\n") + fileName, _("CodeLite - Replace"), wxICON_ERROR | wxOK);
-        clDEBUG() << "Replace: Failed to read file" << fileName;
-        return NULL;
+    for(size_t i = 0; i < file.m_matches.size(); ++i) {
+        const ReplaceInFilesEngine::Match& match = file.m_matches[i];
+        // the results may have been cleared while replacing
+        int index = m_matchInfo.Find(match.m_viewLine);
+        if((index == wxNOT_FOUND) || (m_matchInfo.GetFileName(index) != file.m_fileName)) { continue; }
+
+        if(match.m_replaced) {
+            m_sci->MarkerAdd(match.m_viewLine, 0x9);
+            continue;
+        }
+        if(match.m_selected && (file.m_status != ReplaceInFilesEngine::kFileCancelled)) {
+            m_sci->MarkerAdd(match.m_viewLine, 0x8);
+        }
+        m_matchInfo.Update(index, match.m_result);
     }
-
-    sci = new wxStyledTextCtrl(this);
-    sci->Hide();
-    sci->SetText(content);
-    return sci;
 }
 
 void ReplaceInFilesPanel::OnReplace(wxCommandEvent& e)
 {
+    if(m_engine.IsRunning()) { return; }
     m_filesModified.clear();
-    // FIX bug#2770561
-    int lineNumber(0);
-    clEditor* activeEditor = clMainFrame::Get()->GetMainBook()->GetActiveEditor();
-    if(activeEditor) { lineNumber = activeEditor->GetCurrentLine(); }
-
-    if(m_replaceWith->FindString(m_replaceWith->GetValue(), true) == wxNOT_FOUND) {
-        m_replaceWith->Append(m_replaceWith->GetValue());
-    }
-
-    // Step 1: apply selected replacements
-
-    wxStyledTextCtrl* sci = NULL; // file that is being altered by replacements
 
-    wxString lastFile; // track offsets of pending substitutions caused by previous substitutions
-    long lastLine = 0;
-    long delta = 0;
+    wxString replaceWith = m_replaceWith->GetValue();
+    if(m_replaceWith->FindString(replaceWith, true) == wxNOT_FOUND) { m_replaceWith->Append(replaceWith); }
 
-    // remembers first entry in the file being updated
-    MatchInfo_t::iterator firstInFile = m_matchInfo.begin();
+    // Step 1: group the matches per file
 
-    m_progress->SetRange(m_matchInfo.size());
-
-    // Disable the 'buffer limit' feature during replace
-    clMainFrame::Get()->GetMainBook()->SetUseBuffereLimit(false);
-    MatchInfo_t::iterator i = firstInFile;
-    for(; i != m_matchInfo.end(); ++i) {
-        m_progress->SetValue(m_progress->GetValue() + 1);
-        m_progress->Update();
+    ReplaceInFilesEngine::File::Vec_t files;
+    std::vector<bool> hasSelection;
+    for(size_t i = 0; i < m_matchInfo.GetCount(); ++i) {
+        SearchResult result = m_matchInfo.Get(i);
+        if(files.empty() || (files.back().m_fileName != result.GetFileName())) {
+            files.push_back(ReplaceInFilesEngine::File());
+            files.back().m_fileName = result.GetFileName();
+            hasSelection.push_back(false);
+        }
 
-        if(i->second.GetFileName() != lastFile) {
-            // about to start a different file, save current results
-            DoSaveResults(sci, firstInFile, i);
-            firstInFile = i;
-            lastFile = i->second.GetFileName();
-            lastLine = 0;
-            sci = NULL;
+        ReplaceInFilesEngine::Match match;
+        match.m_viewLine = m_matchInfo.GetViewLine(i);
+        if(m_sci->MarkerGet(match.m_viewLine) & 1 << 0x7) {
+            // no change needed if the match is already the replacement
+            match.m_selected =
+                (result.GetPattern().Mid(result.GetColumnInChars(), result.GetLenInChars()) != replaceWith);
         }
+        hasSelection.back() = hasSelection.back() || match.m_selected;
+        match.m_result = result;
+        files.back().m_matches.push_back(match);
+    }
 
-        if(i->second.GetLineNumber() == lastLine) {
-            // prior substitutions affected the location of this one
-            i->second.SetColumn(i->second.GetColumn() + delta);
+    // Step 2: apply the replacements. The files opened in an editor are modified here, through the editor, so
+    // the changes can be undone. The other files are modified by the replace engine on worker threads
+
+    ReplaceInFilesEngine::File::Vec_t closedFiles;
+    for(size_t i = 0; i < files.size(); ++i) {
+        if(!hasSelection[i]) continue;
+        ReplaceInFilesEngine::File& file = files[i];
+        clEditor* editor = clMainFrame::Get()->GetMainBook()->FindEditor(file.m_fileName);
+        if(editor) {
+            DoReplaceInEditor(editor, file, replaceWith);
+            DoApplyResults(file);
         } else {
-            delta = 0;
+            closedFiles.push_back(std::move(file));
         }
-        if((m_sci->MarkerGet(i->first) & 1 << 0x7) == 0)
-            // not selected for application
-            continue;
-
-        // extract originally matched text for safety check later
-        wxString text = i->second.GetPattern().Mid(i->second.GetColumn() - delta, i->second.GetLen());
-        if(text == m_replaceWith->GetValue()) continue; // no change needed
+    }
+    files.clear();
 
-        // need an editor for this file (try only once per file though)
-        if(!sci && lastLine == 0) {
-            sci = DoGetEditor(i->second.GetFileName());
-            lastLine = i->second.GetLineNumber();
-        }
-        if(!sci) {
-            // couldn't open file
-            m_sci->MarkerAdd(i->first, 0x8);
-            continue;
-        }
+    if(closedFiles.empty()) {
+        DoReplaceCompleted();
+        return;
+    }
 
-        long pos = sci->PositionFromLine(i->second.GetLineNumber() - 1);
-        if(pos < 0) {
-            // invalid line number
-            m_sci->MarkerAdd(i->first, 0x8);
-            continue;
-        }
-        pos += i->second.GetColumn();
+    // Read and write the files with the encoding used by the search
+    wxFontEncoding encoding = wxFontMapper::GetEncodingFromName(m_searchData.GetEncoding());
+    m_progress->SetRange(closedFiles.size());
+    m_progress->SetValue(0);
+    m_engine.Start(closedFiles, replaceWith, encoding);
+    m_replaceTimer->Start(REPLACE_PROGRESS_INTERVAL_MS);
+}
 
-        sci->SetSelection(pos, pos + i->second.GetLen());
-        if(sci->GetSelectedText() != text) {
-            // couldn't locate the original match (file may have been modified)
-            m_sci->MarkerAdd(i->first, 0x8);
-            continue;
+void ReplaceInFilesPanel::OnReplaceTimer(wxTimerEvent& event)
+{
+    m_progress->SetValue(m_engine.GetFilesProcessed());
+    if(m_engine.IsRunning()) { return; }
+
+    m_replaceTimer->Stop();
+    m_engine.Wait();
+
+    size_t failedFiles = 0;
+    ReplaceInFilesEngine::File::Vec_t& files = m_engine.GetFiles();
+    for(size_t i = 0; i < files.size(); ++i) {
+        const ReplaceInFilesEngine::File& file = files[i];
+        switch(file.m_status) {
+        case ReplaceInFilesEngine::kFileReplaced:
+            // Keep the modified file name
+            m_filesModified.Add(file.m_fileName);
+            break;
+        case ReplaceInFilesEngine::kFileModified:
+            clDEBUG() << "Replace: file was modified since the search" << file.m_fileName;
+            ++failedFiles;
+            break;
+        case ReplaceInFilesEngine::kFileReadFailed:
+            clDEBUG() << "Replace: Failed to read file" << file.m_fileName;
+            ++failedFiles;
+            break;
+        case ReplaceInFilesEngine::kFileWriteFailed:
+            clDEBUG() << "Replace: Failed to write file" << file.m_fileName;
+            ++failedFiles;
+            break;
+        default:
+            break;
         }
-        sci->ReplaceSelection(m_replaceWith->GetValue());
-
-        delta += m_replaceWith->GetValue().Length() - i->second.GetLen();
-        lastLine = i->second.GetLineNumber();
+        DoApplyResults(file);
+    }
+    files.clear();
 
-        i->second.SetPattern(m_sci->GetLine(i->first)); // includes prior updates to same line
-        i->second.SetLen(m_replaceWith->GetValue().Length());
+    if(failedFiles) {
+        clMainFrame::Get()->GetStatusBar()->SetMessage(
+            wxString::Format(_("Replace: %u file(s) were modified since the search or could not be written"),
+                             (unsigned int)failedFiles));
     }
-    m_progress->SetValue(0);
-    DoSaveResults(sci, firstInFile, m_matchInfo.end());
+    DoReplaceCompleted();
+}
 
-    // Disable the 'buffer limit' feature during replace
-    clMainFrame::Get()->GetMainBook()->SetUseBuffereLimit(true);
+void ReplaceInFilesPanel::DoReplaceCompleted()
+{
+    m_progress->SetValue(0);
 
-    // Step 2: Update the Replace pane
+    // Step 3: Update the Replace pane
 
     std::set<wxString> updatedEditors;
-    delta = 0;    // offset from old line number to new
-    lastLine = 1; // points to the filename line
-    lastFile.Clear();
+    int delta = 0;    // offset from old line number to new
+    int lastLine = 1; // points to the filename line
+    wxString lastFile;
     m_sci->MarkerDeleteAll(0x7);
     m_sci->SetReadOnly(false);
 
-    std::vector<int> itemsToRemove;
-    i = m_matchInfo.begin();
-    for(; i != m_matchInfo.end(); i++) {
-        int line = i->first + delta;
-        if(i->second.GetFileName() != lastFile) {
+    std::vector<size_t> itemsToRemove;
+    for(size_t i = 0; i < m_matchInfo.GetCount(); i++) {
+        int line = m_matchInfo.GetViewLine(i) + delta;
+        if(m_matchInfo.GetFileName(i) != lastFile) {
             if(lastLine == line - 2) {
                 // previous file's replacements are all done, so remove its filename line
                 m_sci->SetCurrentPos(m_sci->PositionFromLine(lastLine));
@@ -336,7 +382,7 @@ void ReplaceInFilesPanel::OnReplace(wxCommandEvent& e)
             } else {
                 lastLine = line - 1;
             }
-            lastFile = i->second.GetFileName();
+            lastFile = m_matchInfo.GetFileName(i);
         }
 
         if(m_sci->MarkerGet(line) & 1 << 0x9) {
@@ -346,26 +392,22 @@ void ReplaceInFilesPanel::OnReplace(wxCommandEvent& e)
             m_sci->MarkerDelete(line, 0x9);
             m_sci->SetCurrentPos(m_sci->PositionFromLine(line));
             m_sci->LineDelete();
-            itemsToRemove.push_back(i->first);
+            itemsToRemove.push_back(i);
             delta--;
-        } else if(line != i->first) {
+        } else {
             // need to adjust line number
-            m_matchInfo[line] = i->second;
-            itemsToRemove.push_back(i->first);
+            m_matchInfo.SetViewLine(i, line);
         }
     }
 
-    // update the match info map
-    for(std::vector<int>::size_type i = 0; i < itemsToRemove.size(); i++) {
-        MatchInfo_t::iterator iter = m_matchInfo.find(itemsToRemove.at(i));
-        if(iter != m_matchInfo.end()) { m_matchInfo.erase(iter); }
-    }
+    // update the match info
+    m_matchInfo.Erase(itemsToRemove);
 
     m_sci->SetReadOnly(true);
     m_sci->GotoLine(0);
-    if(m_matchInfo.empty()) { Clear(); }
+    if(m_matchInfo.IsEmpty()) { Clear(); }
 
-    // Step 3: Notify user of changes to already opened files, ask to save
+    // Step 4: Notify user of changes to already opened files, ask to save
     std::vector<std::pair<wxFileName, bool>> filesToSave;
     for(std::set<wxString>::iterator i = updatedEditors.begin(); i != updatedEditors.end(); i++) {
         filesToSave.push_back(std::make_pair(wxFileName(*i), true));
@@ -381,15 +423,6 @@ void ReplaceInFilesPanel::OnReplace(wxCommandEvent& e)
         }
     }
 
-    // FIX bug#2770561
-    if(activeEditor) {
-
-        clMainFrame::Get()->GetMainBook()->SelectPage(activeEditor);
-
-        // restore the line
-        activeEditor->GotoLine(lineNumber);
-    }
-
     if(!m_filesModified.IsEmpty()) {
         // Some files were modified directly on the file system, notify about it to the plugins
         clFileSystemEvent event(wxEVT_FILES_MODIFIED_REPLACE_IN_FILES);
@@ -399,13 +432,28 @@ void ReplaceInFilesPanel::OnReplace(wxCommandEvent& e)
     }
 }
 
-void ReplaceInFilesPanel::OnReplaceUI(wxUpdateUIEvent& e) { e.Enable((m_sci->GetLength() > 0) && !m_searchInProgress); }
+void ReplaceInFilesPanel::OnReplaceUI(wxUpdateUIEvent& e)
+{
+    e.Enable((m_sci->GetLength() > 0) && !m_searchInProgress && !m_engine.IsRunning());
+}
 
 void ReplaceInFilesPanel::OnReplaceWithComboUI(wxUpdateUIEvent& e)
 {
-    e.Enable((m_sci->GetLength() > 0) && !m_searchInProgress);
+    e.Enable((m_sci->GetLength() > 0) && !m_searchInProgress && !m_engine.IsRunning());
 }
 
+void ReplaceInFilesPanel::OnStopSearch(wxCommandEvent& e)
+{
+    if(m_engine.IsRunning()) {
+        // the files that were not processed yet are left untouched
+        m_engine.Cancel();
+    } else {
+        FindResultsTab::OnStopSearch(e);
+    }
+}
+
+void ReplaceInFilesPanel::OnStopSearchUI(wxUpdateUIEvent& e) { e.Enable(m_searchInProgress || m_engine.IsRunning()); }
+
 void ReplaceInFilesPanel::OnHoldOpenUpdateUI(wxUpdateUIEvent& e)
 {
     int sel = clMainFrame::Get()->GetOutputPane()->GetNotebook()->GetSelection();
@@ -432,8 +480,8 @@ void ReplaceInFilesPanel::OnMouseDClick(wxStyledTextEvent& e)
         m_sci->ToggleFold(toggleLine);
 
     } else {
-        MatchInfo_t::const_iterator m = m_matchInfo.find(clickedLine);
-        if(m != m_matchInfo.end()) { DoOpenSearchResult(m->second, NULL, m->first); }
+        int index = m_matchInfo.Find(clickedLine);
+        if(index != wxNOT_FOUND) { DoOpenSearchResult(m_matchInfo.Get(index), NULL, clickedLine); }
     }
 }
 
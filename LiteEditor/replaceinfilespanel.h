@@ -25,7 +25,11 @@
 #ifndef __replaceinfilespanel__
 #define __replaceinfilespanel__
 
+#include "ReplaceInFilesEngine.h"
 #include "findresultstab.h"
+#include <wx/timer.h>
+
+class clEditor;
 
 class ReplaceInFilesPanel : public FindResultsTab
 {
@@ -37,12 +41,16 @@ protected:
     wxBitmap m_bmpChecked;
     wxBitmap m_bmpUnchecked;
     bool m_bmpsForDarkTheme = false;
-    
-protected:
-    void DoSaveResults(wxStyledTextCtrl* sci, std::map<int, SearchResult>::iterator begin,
-                       std::map<int, SearchResult>::iterator end);
+    ReplaceInFilesEngine m_engine;
+    wxTimer* m_replaceTimer;
 
-    wxStyledTextCtrl* DoGetEditor(const wxString& fileName);
+protected:
+    void DoReplaceInEditor(clEditor* editor, ReplaceInFilesEngine::File& file, const wxString& replaceWith);
+    /**
+     * @brief update the markers and the matches of the view after replacing in 'file'
+     */
+    void DoApplyResults(const ReplaceInFilesEngine::File& file);
+    void DoReplaceCompleted();
 
     // Event handlers
     virtual void OnSearchStart(wxCommandEvent& e);
@@ -53,6 +61,9 @@ protected:
     virtual void OnMarkAll(wxCommandEvent& e);
     virtual void OnUnmarkAll(wxCommandEvent& e);
     virtual void OnReplace(wxCommandEvent& e);
+    void OnReplaceTimer(wxTimerEvent& event);
+    virtual void OnStopSearch(wxCommandEvent& e);
+    virtual void OnStopSearchUI(wxUpdateUIEvent& e);
 
     virtual void OnMarkAllUI(wxUpdateUIEvent& e);
     virtual void OnUnmarkAllUI(wxUpdateUIEvent& e);
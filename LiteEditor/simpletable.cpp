@@ -535,7 +535,7 @@ void WatchesTable::OnUpdateVariableObject(const DebuggerEventData& event)
     wxArrayString itemsToRefresh = event.m_varObjUpdateInfo.refreshIds;
     IDebugger* dbgr = DoGetDebugger();
     if(dbgr) {
-        DoRefreshItemRecursively(dbgr, m_listTable->GetRootItem(), itemsToRefresh);
+        DoRefreshItemRecursively(dbgr, m_listTable->GetRootItem(), itemsToRefresh, event.m_varObjUpdateInfo.values);
     }
 }
 
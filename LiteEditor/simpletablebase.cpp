@@ -102,18 +102,22 @@ void DebuggerTreeListCtrlBase::OnEvaluateVariableObj(const DebuggerEventData& ev
 
     std::map<wxString, wxTreeItemId>::iterator iter = m_gdbIdToTreeId.find(gdbId);
     if(iter != m_gdbIdToTreeId.end()) {
-        wxString newValue = value;
-        wxString curValue = m_listTable->GetItemText(iter->second, 1);
-        if(!(newValue == curValue || curValue.IsEmpty())) { m_listTable->SetItemTextColour(iter->second, *wxRED, 1); }
-        m_listTable->SetItemText(iter->second, value, 1);
+        DoSetItemValue(iter->second, value);
 
         // keep the red items IDs in the array
         m_gdbIdToTreeId.erase(iter);
     }
 }
 
+void DebuggerTreeListCtrlBase::DoSetItemValue(const wxTreeItemId& item, const wxString& value)
+{
+    wxString curValue = m_listTable->GetItemText(item, 1);
+    if(!(value == curValue || curValue.IsEmpty())) { m_listTable->SetItemTextColour(item, *wxRED, 1); }
+    m_listTable->SetItemText(item, value, 1);
+}
+
 void DebuggerTreeListCtrlBase::DoRefreshItemRecursively(IDebugger* dbgr, const wxTreeItemId& item,
-                                                        wxArrayString& itemsToRefresh)
+                                                        wxArrayString& itemsToRefresh, const wxStringMap_t& values)
 {
     if(itemsToRefresh.IsEmpty()) return;
 
@@ -125,13 +129,19 @@ void DebuggerTreeListCtrlBase::DoRefreshItemRecursively(IDebugger* dbgr, const w
         if(data) {
             int where = itemsToRefresh.Index(data->_gdbId);
             if(where != wxNOT_FOUND) {
-                dbgr->EvaluateVariableObject(data->_gdbId, m_DBG_USERR);
-                m_gdbIdToTreeId[data->_gdbId] = exprItem;
+                wxStringMap_t::const_iterator iter = values.find(data->_gdbId);
+                if(iter != values.end()) {
+                    // the debugger already reported the new value, no need to evaluate it again
+                    DoSetItemValue(exprItem, iter->second);
+                } else {
+                    dbgr->EvaluateVariableObject(data->_gdbId, m_DBG_USERR);
+                    m_gdbIdToTreeId[data->_gdbId] = exprItem;
+                }
                 itemsToRefresh.RemoveAt((size_t)where);
             }
         }
 
-        if(m_listTable->HasChildren(exprItem)) { DoRefreshItemRecursively(dbgr, exprItem, itemsToRefresh); }
+        if(m_listTable->HasChildren(exprItem)) { DoRefreshItemRecursively(dbgr, exprItem, itemsToRefresh, values); }
         exprItem = m_listTable->GetNextChild(item, cookieOne);
     }
 }
@@ -124,7 +124,9 @@ public:
     virtual void DoResetItemColour(const wxTreeItemId& item, size_t itemKind);
     virtual void OnEvaluateVariableObj(const DebuggerEventData& event);
     virtual void OnCreateVariableObjError(const DebuggerEventData& event);
-    virtual void DoRefreshItemRecursively(IDebugger* dbgr, const wxTreeItemId& item, wxArrayString& itemsToRefresh);
+    virtual void DoRefreshItemRecursively(IDebugger* dbgr, const wxTreeItemId& item, wxArrayString& itemsToRefresh,
+                                          const wxStringMap_t& values = wxStringMap_t());
+    virtual void DoSetItemValue(const wxTreeItemId& item, const wxString& value);
     virtual void Clear();
     virtual void DoRefreshItem(IDebugger* dbgr, const wxTreeItemId& item, bool forceCreate);
     virtual wxString DoGetGdbId(const wxTreeItemId& item);
@@ -5,9 +5,14 @@
  * @copyright GNU General Public License v2
  */
 
+#include <wx/ffile.h>
+#include <wx/mstream.h>
 #include <wx/stdpaths.h>
 #include <wx/textfile.h>
 
+#include <string>
+#include <vector>
+
 #include "file_logger.h"
 #include "workspace.h"
 
@@ -69,26 +74,67 @@ bool ValgrindMemcheckProcessor::Process(const wxString& outputLogFileName)
 
     CL_DEBUG(PLUGIN_PREFIX("Processing file '%s'", m_outputLogFileName));
 
-    wxXmlDocument doc;
-    if(!doc.Load(m_outputLogFileName) || doc.GetRoot()->GetName() != wxT("valgrindoutput")) {
+    // The log can be hundreds of MB, so instead of loading it into a single wxXmlDocument we read it in chunks and
+    // parse every <error> element on its own. This keeps the memory bounded to a single error at a time
+    wxFFile fp(m_outputLogFileName, wxT("rb"));
+    if(!fp.IsOpened()) {
         CL_WARNING("Error while loading file '%s'", m_outputLogFileName);
         return false;
     }
     m_errorList.clear();
 
+    static const std::string errorStart = "<error>";
+    static const std::string errorEnd = "</error>";
+
+    std::string buffer;
+    std::vector<char> chunk(VALGRIND_READ_CHUNK_SIZE);
+    bool rootFound = false;
     int i = 0;
-    wxXmlNode* errorNode = doc.GetRoot()->GetChildren();
-    while(errorNode) {
-        if(errorNode->GetName() == wxT("error")) { m_errorList.push_back(ProcessError(doc, errorNode)); }
-        errorNode = errorNode->GetNext();
-
-        if(i < 1000)
-            i++;
-        else {
-            i = 0;
-            // ATTN  m_mgr->GetTheApp()
-            wxTheApp->Yield();
+    while(!fp.Eof()) {
+        size_t bytesRead = fp.Read(chunk.data(), chunk.size());
+        if(bytesRead == 0) break;
+        buffer.append(chunk.data(), bytesRead);
+
+        if(!rootFound) {
+            rootFound = (buffer.find("<valgrindoutput>") != std::string::npos);
+            if(!rootFound && buffer.find(errorStart) != std::string::npos) break;
         }
+
+        size_t consumed = 0;
+        while(true) {
+            size_t start = buffer.find(errorStart, consumed);
+            if(start == std::string::npos) {
+                // keep enough bytes for a tag split between two chunks
+                if(buffer.length() > errorStart.length()) { consumed = buffer.length() - errorStart.length(); }
+                break;
+            }
+            size_t end = buffer.find(errorEnd, start);
+            if(end == std::string::npos) {
+                // in-complete error, wait for more data
+                consumed = start;
+                break;
+            }
+            end += errorEnd.length();
+
+            wxMemoryInputStream is(buffer.data() + start, end - start);
+            wxXmlDocument doc;
+            if(doc.Load(is) && doc.GetRoot()) { m_errorList.push_back(ProcessError(doc, doc.GetRoot())); }
+            consumed = end;
+
+            if(i < 1000)
+                i++;
+            else {
+                i = 0;
+                // ATTN  m_mgr->GetTheApp()
+                wxTheApp->Yield();
+            }
+        }
+        buffer.erase(0, consumed);
+    }
+
+    if(!rootFound) {
+        CL_WARNING("Error while loading file '%s'", m_outputLogFileName);
+        return false;
     }
     return true;
 }
@@ -36,6 +36,8 @@
 #include "imemcheckprocessor.h"
 #include <wx/xml/xml.h>
 
+#define VALGRIND_READ_CHUNK_SIZE (1024 * 1024)
+
 /**
  * @class ValgrindMemcheckProcessor
  * @brief Implementation of valgrind's memcheck tool parser
@@ -74,7 +76,7 @@ public:
      * @param outputLogFileName
      * @return
      *
-     * Loads Valgrind's xml log to wxXmlDocument, and goes trought nodes
+     * Reads Valgrind's xml log in chunks and loads each <error> element to its own wxXmlDocument
      */
     virtual bool Process(const wxString& outputLogFileName = wxEmptyString);
 
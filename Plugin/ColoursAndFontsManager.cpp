@@ -100,12 +100,14 @@ ColoursAndFontsManager::ColoursAndFontsManager()
     }
     m_lexersVersion = clConfig::Get().Read(LEXERS_VERSION_STRING, LEXERS_UPGRADE_LINENUM_DEFAULT_COLOURS);
     EventNotifier::Get()->Bind(wxEVT_INFO_BAR_BUTTON, &ColoursAndFontsManager::OnAdjustTheme, this);
+    EventNotifier::Get()->Bind(wxEVT_FILE_SAVED, &ColoursAndFontsManager::OnFileSaved, this);
 }
 
 ColoursAndFontsManager::~ColoursAndFontsManager()
 {
     clConfig::Get().Write(LEXERS_VERSION_STRING, LEXERS_VERSION);
     EventNotifier::Get()->Unbind(wxEVT_INFO_BAR_BUTTON, &ColoursAndFontsManager::OnAdjustTheme, this);
+    EventNotifier::Get()->Unbind(wxEVT_FILE_SAVED, &ColoursAndFontsManager::OnFileSaved, this);
 }
 
 ColoursAndFontsManager& ColoursAndFontsManager::Get()
@@ -414,6 +416,8 @@ LexerConf::Ptr_t ColoursAndFontsManager::GetLexerForFile(const wxString& filenam
     wxFileName fnFileName(filename);
     wxString fileNameLowercase = fnFileName.GetFullName();
     fileNameLowercase.MakeLower();
+    wxString extLowercase = fileNameLowercase.AfterLast('.');
+    if(extLowercase.length() == fileNameLowercase.length()) { extLowercase.clear(); }
 
     LexerConf::Ptr_t defaultLexer(NULL);
     LexerConf::Ptr_t firstLexer(NULL);
@@ -421,8 +425,7 @@ LexerConf::Ptr_t ColoursAndFontsManager::GetLexerForFile(const wxString& filenam
     // Scan the list of lexers, locate the active lexer for it and return it
     ColoursAndFontsManager::Vec_t::const_iterator iter = m_allLexers.begin();
     for(; iter != m_allLexers.end(); ++iter) {
-        wxString fileMask = (*iter)->GetFileSpec();
-        if(FileUtils::WildMatch(fileMask, filename)) {
+        if(GetFileSpec((*iter)->GetFileSpec()).Matches(fileNameLowercase, extLowercase)) {
             if((*iter)->IsActive()) {
                 return *iter;
 
@@ -443,9 +446,19 @@ LexerConf::Ptr_t ColoursAndFontsManager::GetLexerForFile(const wxString& filenam
 
     // Try this:
     // Use the FileExtManager to get the file type by examinig its content
+    // The result is cached per file (reading the file on every call is expensive), a file save
+    // invalidates its entry
     LexerConf::Ptr_t lexerByContent; // Null by default
     FileExtManager::FileType fileType = FileExtManager::TypeOther;
-    if(FileExtManager::AutoDetectByContent(filename, fileType) && fileType != FileExtManager::TypeOther) {
+    std::unordered_map<wxString, FileExtManager::FileType>::const_iterator typeIter = m_typeByContent.find(filename);
+    if(typeIter != m_typeByContent.end()) {
+        fileType = typeIter->second;
+    } else if(fnFileName.FileExists()) {
+        if(!FileExtManager::AutoDetectByContent(filename, fileType)) { fileType = FileExtManager::TypeOther; }
+        m_typeByContent.insert({ filename, fileType });
+    }
+
+    if(fileType != FileExtManager::TypeOther) {
         switch(fileType) {
         case FileExtManager::TypeScript:
             lexerByContent = GetLexer("script");
@@ -496,6 +509,8 @@ void ColoursAndFontsManager::Clear()
 {
     m_allLexers.clear();
     m_lexersMap.clear();
+    m_fileSpecs.clear();
+    m_typeByContent.clear();
     m_initialized = false;
 }
 
@@ -1052,3 +1067,68 @@ bool ColoursAndFontsManager::IsDarkTheme() const
     if(!lexer) { return false; }
     return lexer->IsDark();
 }
+
+void ColoursAndFontsManager::FileSpec::Add(const wxString& mask, bool exclude)
+{
+    if(!exclude && mask == "*") {
+        m_matchAll = true;
+
+    } else if(!mask.Contains("*")) {
+        // exact file name
+        (exclude ? m_excludeNames : m_names).insert(mask);
+
+    } else if(!exclude && mask.StartsWith("*.") && mask.length() > 2 &&
+              mask.find_first_of("*?.", 2) == wxString::npos) {
+        // plain extension
+        m_extensions.insert(mask.Mid(2));
+
+    } else {
+        (exclude ? m_excludePatterns : m_patterns).Add(mask);
+    }
+}
+
+bool ColoursAndFontsManager::FileSpec::Matches(const wxString& lcFullname, const wxString& lcExt) const
+{
+    if(m_matchAll) { return true; }
+    if(m_excludeNames.count(lcFullname)) { return false; }
+    for(const wxString& pattern : m_excludePatterns) {
+        if(::wxMatchWild(pattern, lcFullname)) { return false; }
+    }
+
+    if(!lcExt.IsEmpty() && m_extensions.count(lcExt)) { return true; }
+    if(m_names.count(lcFullname)) { return true; }
+    for(const wxString& pattern : m_patterns) {
+        if(::wxMatchWild(pattern, lcFullname)) { return true; }
+    }
+    return false;
+}
+
+const ColoursAndFontsManager::FileSpec& ColoursAndFontsManager::GetFileSpec(const wxString& fileSpec) const
+{
+    std::unordered_map<wxString, FileSpec>::const_iterator iter = m_fileSpecs.find(fileSpec);
+    if(iter != m_fileSpecs.end()) { return iter->second; }
+
+    // Same rules as FileUtils::WildMatch(): masks are separated by ";" or "," and
+    // masks starting with "!" or "-" are exclude masks
+    FileSpec spec;
+    wxArrayString masks = ::wxStringTokenize(fileSpec.Lower(), ";,", wxTOKEN_STRTOK);
+    for(size_t i = 0; i < masks.size(); ++i) {
+        wxString& mask = masks.Item(i);
+        mask.Trim().Trim(false);
+        if(mask.IsEmpty()) { continue; }
+        if((mask[0] == '!') || (mask[0] == '-')) {
+            spec.Add(mask.Mid(1), true);
+        } else {
+            spec.Add(mask, false);
+        }
+    }
+    return m_fileSpecs.insert({ fileSpec, spec }).first->second;
+}
+
+void ColoursAndFontsManager::OnFileSaved(clCommandEvent& event)
+{
+    event.Skip();
+    // the file content might have changed, detect it again next time
+    m_typeByContent.erase(event.GetFileName());
+    m_typeByContent.erase(wxFileName(event.GetFileName()).GetFullName());
+}
@@ -36,6 +36,8 @@
 #include "cl_command_event.h"
 #include <wx/font.h>
 #include "wxStringHash.h"
+#include "fileextmanager.h"
+#include "macros.h"
 
 // When the version is 0, it means that we need to upgrade the colours for the line numbers
 // and for the default state
@@ -50,6 +52,22 @@ class WXDLLIMPEXP_SDK ColoursAndFontsManager : public wxEvtHandler
     typedef std::vector<LexerConf::Ptr_t> Vec_t;
     typedef std::unordered_map<wxString, ColoursAndFontsManager::Vec_t> Map_t;
 
+    /**
+     * @brief a lexer file spec (e.g. "*.cpp;*.h;makefile") split into lookup tables so
+     * matching a file name against it does not require tokenizing the spec again
+     */
+    struct FileSpec {
+        bool m_matchAll = false;
+        wxStringSet_t m_extensions;        ///< "*.cpp" is kept as "cpp"
+        wxStringSet_t m_names;             ///< masks without wildcards
+        wxArrayString m_patterns;          ///< any other wildcard mask
+        wxStringSet_t m_excludeNames;      ///< same as above for the "!" or "-" masks
+        wxArrayString m_excludePatterns;
+
+        void Add(const wxString& mask, bool exclude);
+        bool Matches(const wxString& lcFullname, const wxString& lcExt) const;
+    };
+
 protected:
     bool m_initialized;
     ColoursAndFontsManager::Map_t m_lexersMap;
@@ -58,6 +76,8 @@ protected:
     LexerConf::Ptr_t m_defaultLexer;
     int m_lexersVersion;
     wxFont m_globalFont;
+    mutable std::unordered_map<wxString, FileSpec> m_fileSpecs;                      ///< compiled file specs
+    mutable std::unordered_map<wxString, FileExtManager::FileType> m_typeByContent; ///< content detection cache
 
 private:
     ColoursAndFontsManager();
@@ -69,9 +89,11 @@ private:
     void Clear();
     wxFileName GetConfigFile() const;
     void LoadJSON(const wxFileName& path);
+    const FileSpec& GetFileSpec(const wxString& fileSpec) const;
 
 protected:
     void OnAdjustTheme(clCommandEvent& event);
+    void OnFileSaved(clCommandEvent& event);
 
 public:
     static ColoursAndFontsManager& Get();
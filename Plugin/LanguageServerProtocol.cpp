@@ -15,6 +15,7 @@
 #include "LSPNetworkSTDIO.h"
 #include "LSPNetworkSocketClient.h"
 #include "LanguageServerProtocol.h"
+#include "clPerfTrace.h"
 #include "clWorkspaceManager.h"
 #include "cl_exception.h"
 #include "codelite_events.h"
@@ -190,6 +191,7 @@ void LanguageServerProtocol::DoClear()
     m_initializeRequestID = wxNOT_FOUND;
     m_Queue.Clear();
     m_lastCompletionRequestId = wxNOT_FOUND;
+    m_requestsSentTime.clear();
     // Destory the current connection
     m_network->Close();
 }
@@ -469,6 +471,11 @@ void LanguageServerProtocol::ProcessQueue()
         return;
     }
 
+    // Remember when the request was sent so the trace can show the complete round trip
+    if(clPerfTrace::Get().IsEnabled() && req->As<LSP::Request>()) {
+        m_requestsSentTime[req->As<LSP::Request>()->GetId()] = clPerfTrace::Now();
+    }
+
     // Write the message length as string of 10 bytes
     m_network->Send(req->ToString());
     m_Queue.SetWaitingReponse(true);
@@ -539,6 +546,7 @@ void LanguageServerProtocol::OnNetError(clCommandEvent& event)
 
 void LanguageServerProtocol::OnNetDataReady(clCommandEvent& event)
 {
+    CL_TRACE_SCOPE("lsp", "LanguageServerProtocol::OnNetDataReady");
     clDEBUG() << GetLogPrefix() << event.GetString();
     wxString buffer = std::move(event.GetString());
     m_outputBuffer << buffer;
@@ -550,6 +558,14 @@ void LanguageServerProtocol::OnNetDataReady(clCommandEvent& event)
         if(res.IsOk()) {
             if(IsInitialized()) {
                 LSP::MessageWithParams::Ptr_t msg_ptr = m_Queue.TakePendingReplyMessage(res.GetId());
+                auto iterSent = m_requestsSentTime.find(res.GetId());
+                if(iterSent != m_requestsSentTime.end()) {
+                    if(msg_ptr && clPerfTrace::Get().IsEnabled()) {
+                        clPerfTrace::Get().AddSpan("lsp", GetName() + ": " + msg_ptr->GetMethod(), iterSent->second,
+                                                   clPerfTrace::Now() - iterSent->second);
+                    }
+                    m_requestsSentTime.erase(iterSent);
+                }
                 // Is this an error message?
                 if(res.Has("error")) {
                     clDEBUG() << GetLogPrefix() << "received an error message";
@@ -66,6 +66,7 @@ class WXDLLIMPEXP_SDK LanguageServerProtocol : public ServiceProvider
     wxStringSet_t m_unimplementedMethods;
     bool m_disaplayDiagnostics = true;
     int m_lastCompletionRequestId = wxNOT_FOUND;
+    std::unordered_map<int, long long> m_requestsSentTime; ///< trace only: request ID -> send time
 
 public:
     typedef wxSharedPtr<LanguageServerProtocol> Ptr_t;
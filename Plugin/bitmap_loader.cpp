@@ -42,6 +42,7 @@
 #include <wx/msgdlg.h>
 
 std::unordered_map<wxString, wxBitmap> BitmapLoader::m_toolbarsBitmaps;
+std::unordered_map<wxString, wxMemoryBuffer> BitmapLoader::m_pngs;
 std::unordered_map<wxString, wxString> BitmapLoader::m_manifest;
 
 BitmapLoader::~BitmapLoader() {}
@@ -63,7 +64,31 @@ const wxBitmap& BitmapLoader::LoadBitmap(const wxString& name, int requestedSize
         const wxBitmap& b = iter->second;
         return b;
     }
-    return wxNullBitmap;
+
+    // Not decoded yet
+    const wxBitmap* bmp = DoDecodeBitmap(newName);
+    return bmp ? *bmp : wxNullBitmap;
+}
+
+const wxBitmap* BitmapLoader::DoDecodeBitmap(const wxString& name)
+{
+    std::unordered_map<wxString, wxMemoryBuffer>::iterator iter = m_pngs.find(name);
+    if(iter == m_pngs.end()) { return nullptr; }
+
+    std::function<bool(const wxString&, void**, size_t&)> fnGetHiResVersion = [&](const wxString& hiresName,
+                                                                                  void** ppData, size_t& nLen) {
+        std::unordered_map<wxString, wxMemoryBuffer>::iterator hiresIter = m_pngs.find(hiresName);
+        if(hiresIter == m_pngs.end()) { return false; }
+        *ppData = hiresIter->second.GetData();
+        nLen = hiresIter->second.GetDataLen();
+        return true;
+    };
+
+    wxMemoryInputStream is(iter->second.GetData(), iter->second.GetDataLen());
+    clBitmap bmp;
+    if(!bmp.LoadPNGFromMemory(name, is, fnGetHiResVersion)) { return nullptr; }
+    clDEBUG1() << "Decoded image:" << name;
+    return &(m_toolbarsBitmaps.insert({ name, bmp }).first->second);
 }
 
 int BitmapLoader::GetMimeImageId(int type) { return GetMimeBitmaps().GetIndex(type); }
@@ -105,31 +130,19 @@ void BitmapLoader::initialize()
         std::unordered_map<wxString, clZipReader::Entry> buffers;
         zip.ExtractAll(buffers);
 
-        std::function<bool(const wxString&, void**, size_t&)> fnGetHiResVersion = [&](const wxString& name,
-                                                                                      void** ppData, size_t& nLen) {
-            wxString key;
-            key << name << ".png";
-            if(buffers.count(key)) {
-                *ppData = buffers[key].buffer;
-                nLen = buffers[key].len;
-                return true;
-            }
-            return false;
-        };
-
+        // Keep the images PNG encoded, an image is decoded the first time it is requested by LoadBitmap()
         for(const auto& entry : buffers) {
             if(!entry.first.EndsWith(".png")) { continue; }
 
             wxString name = wxFileName(entry.first).GetName();
             clZipReader::Entry d = entry.second;
             if(d.len && d.buffer) {
-                wxMemoryInputStream is(d.buffer, d.len);
-                clBitmap bmp;
-                if(bmp.LoadPNGFromMemory(name, is, fnGetHiResVersion)) {
-                    clDEBUG1() << "Adding new image:" << name;
-                    m_toolbarsBitmaps.erase(name);
-                    m_toolbarsBitmaps.insert({ name, bmp });
-                }
+                wxMemoryBuffer mb(d.len);
+                mb.AppendData(d.buffer, d.len);
+                m_pngs.erase(name);
+                m_pngs.insert({ name, mb });
+                // drop any bitmap decoded from a previously loaded archive
+                m_toolbarsBitmaps.erase(name);
             }
         }
 
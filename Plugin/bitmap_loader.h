@@ -31,6 +31,7 @@
 #include "wxStringHash.h"
 #include <vector>
 #include <wx/bitmap.h>
+#include <wx/buffer.h>
 #include <wx/filename.h>
 #include <wx/imaglist.h>
 
@@ -105,7 +106,8 @@ public:
 
 protected:
     wxFileName m_zipPath;
-    static std::unordered_map<wxString, wxBitmap> m_toolbarsBitmaps;
+    static std::unordered_map<wxString, wxBitmap> m_toolbarsBitmaps; ///< decoded bitmaps
+    static std::unordered_map<wxString, wxMemoryBuffer> m_pngs;      ///< PNG images not decoded yet
     static std::unordered_map<wxString, wxString> m_manifest;
     std::unordered_map<FileExtManager::FileType, int> m_fileIndexMap;
     bool m_bMapPopulated;
@@ -155,6 +157,11 @@ public:
 
 protected:
     void CreateMimeList();
+    /**
+     * @brief decode the PNG image 'name' from the archive content and cache the result
+     * @return the bitmap or nullptr if there is no such image
+     */
+    const wxBitmap* DoDecodeBitmap(const wxString& name);
 
 private:
     void initialize();
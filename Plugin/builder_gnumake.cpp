@@ -41,7 +41,9 @@
 #include "globals.h"
 #include "macromanager.h"
 #include "macros.h"
+#include "fileutils.h"
 #include "wx/sstream.h"
+#include "wxmd5.h"
 #include "wx/tokenzr.h"
 #include <algorithm>
 #include <wx/stopwatch.h>
@@ -423,9 +425,7 @@ bool BuilderGNUMakeClassic::Export(const wxString& project, const wxString& conf
     }
 
     // dump the content to file
-    wxFileOutputStream output(fn);
-    wxStringInputStream content(text);
-    output << content;
+    DoWriteFileIfChanged(fn, text);
 
     CL_DEBUG("Generating Makefile...is completed");
     return true;
@@ -469,10 +469,26 @@ void BuilderGNUMakeClassic::GenerateMakefile(ProjectPtr proj, const wxString& co
     wxString fn(path);
     fn << PATH_SEP << proj->GetName() << wxT(".mk");
 
+    EvnVarList vars;
+    EnvironmentConfig::Instance()->ReadObject(wxT("Variables"), &vars);
+    EnvMap varMap = vars.GetVariables(wxT(""), true, proj->GetName(), bldConf->GetName());
+
     // skip the next test if the makefile does not exist
+    wxString signature;
     if(wxFileName::FileExists(fn)) {
         if(!force) {
             if(proj->IsModified() == false) { return; }
+
+            // The project is marked as modified, but this does not mean that any of the makefile inputs
+            // were changed (e.g. the project was modified by switching the build configuration back and forth)
+            // Compare the inputs with the ones used for the last generation and skip it if they match
+            signature = DoGetMakefileSignature(proj, bldConf, depsProj, varMap.String());
+            wxStringMap_t::const_iterator iter = m_makefileSignatures.find(fn);
+            if(iter != m_makefileSignatures.end() && iter->second == signature) {
+                CL_DEBUG("Makefile %s is up-to-date", fn);
+                proj->SetModified(false);
+                return;
+            }
         }
     }
 
@@ -497,10 +513,6 @@ void BuilderGNUMakeClassic::GenerateMakefile(ProjectPtr proj, const wxString& co
     // so user will be able to override any of the default
     // variables by defining its own
     //----------------------------------------------------------
-    EvnVarList vars;
-    EnvironmentConfig::Instance()->ReadObject(wxT("Variables"), &vars);
-    EnvMap varMap = vars.GetVariables(wxT(""), true, proj->GetName(), bldConf->GetName());
-
     text << wxT("##") << wxT("\n");
     text << wxT("## User defined environment variables") << wxT("\n");
     text << wxT("##") << wxT("\n");
@@ -540,18 +552,91 @@ void BuilderGNUMakeClassic::GenerateMakefile(ProjectPtr proj, const wxString& co
     CreateFileTargets(proj, confToBuild, text);
     CreateCleanTargets(proj, confToBuild, text);
 
-    // dump the content to a file
-    wxFFile output;
-    output.Open(fn, wxT("w+"));
-    if(output.IsOpened()) {
-        output.Write(text);
-        output.Close();
-    }
+    // dump the content to a file. If the content did not change, leave the file untouched so its timestamp
+    // remains stable
+    DoWriteFileIfChanged(fn, text);
+
+    // remember the inputs used to generate this makefile
+    if(signature.IsEmpty()) { signature = DoGetMakefileSignature(proj, bldConf, depsProj, varMap.String()); }
+    m_makefileSignatures[fn] = signature;
 
     // mark the project as non-modified one
     proj->SetModified(false);
 }
 
+wxString BuilderGNUMakeClassic::DoGetMakefileSignature(ProjectPtr proj, BuildConfigPtr bldConf,
+                                                       const wxArrayString& depsProj, const wxString& envVars) const
+{
+    // Hash the content of the inputs rather than the file times: the project XML holds the file list and the
+    // build configurations (saved or not) and the build configuration is serialized as it was resolved for this build
+    wxString inputs;
+    inputs << proj->GetFileName().GetFullPath() << "|" << clCxxWorkspaceST::Get()->GetFileName().GetFullPath() << "|"
+           << m_objectChunks << "|" << proj->GetXmlString() << "|";
+    {
+        wxXmlDocument doc;
+        doc.SetRoot(bldConf->ToXml());
+        wxStringOutputStream sos(&inputs);
+        doc.Save(sos);
+    }
+    inputs << "|";
+
+    for(size_t i = 0; i < depsProj.GetCount(); ++i) {
+        inputs << depsProj.Item(i) << ";";
+    }
+    inputs << "|" << envVars << "|";
+
+    // The compiler settings
+    CompilerPtr cmp = bldConf->GetCompiler();
+    if(cmp) {
+        wxXmlDocument doc;
+        doc.SetRoot(cmp->ToXml());
+        wxStringOutputStream sos(&inputs);
+        doc.Save(sos);
+    }
+    inputs << "|";
+
+    // The project global settings, merged into the build configurations
+    BuildConfigCommonPtr globalSettings = proj->GetSettings() ? proj->GetSettings()->GetGlobalSettings() : NULL;
+    if(globalSettings) {
+        wxXmlDocument doc;
+        doc.SetRoot(globalSettings->ToXml());
+        wxStringOutputStream sos(&inputs);
+        doc.Save(sos);
+    }
+    inputs << "|";
+
+    // The builder settings (build_settings.xml)
+    BuilderConfigPtr builderConfig = BuildSettingsConfigST::Get()->GetBuilderConfig(GetName());
+    if(builderConfig) {
+        wxXmlDocument doc;
+        doc.SetRoot(builderConfig->ToXml());
+        wxStringOutputStream sos(&inputs);
+        doc.Save(sos);
+    }
+    return wxMD5::GetDigest(inputs);
+}
+
+// Return content without the "Date" variable line, so that two generations that differ only by their date compare equal
+static wxString RemoveDateVariable(const wxString& content)
+{
+    size_t where = content.find("\nDate ");
+    if(where == wxString::npos) { return content; }
+    size_t end = content.find('\n', where + 1);
+    wxString result = content.Mid(0, where);
+    if(end != wxString::npos) { result << content.Mid(end); }
+    return result;
+}
+
+bool BuilderGNUMakeClassic::DoWriteFileIfChanged(const wxString& filename, const wxString& content) const
+{
+    wxString currentContent;
+    if(wxFileName::FileExists(filename) && FileUtils::ReadFileContent(filename, currentContent) &&
+       RemoveDateVariable(currentContent) == RemoveDateVariable(content)) {
+        return true;
+    }
+    return FileUtils::WriteFileContent(filename, content);
+}
+
 void BuilderGNUMakeClassic::CreateMakeDirsTarget(ProjectPtr proj, BuildConfigPtr bldConf, const wxString& targetName,
                                                  wxString& text)
 {
@@ -1133,6 +1218,8 @@ void BuilderGNUMakeClassic::CreateConfigsVariables(ProjectPtr proj, BuildConfigP
     text << "CurrentFilePath        :=\n"; // TODO:: Need implementation
     text << "CurrentFileFullPath    :=\n"; // TODO:: Need implementation
     text << "User                   :=" << wxGetUserName() << "\n";
+    // The makefile is rewritten only when its content changes (see DoWriteFileIfChanged), so this is the date of the
+    // last generation that changed the makefile, not the date of the build
     text << "Date                   :=" << wxDateTime::Now().FormatDate() << "\n";
     text << "CodeLitePath           :=" << ::WrapWithQuotes(startupdir) << "\n";
     text << "LinkerName             :=" << cmp->GetTool("LinkerName") << "\n";
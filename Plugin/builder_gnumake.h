@@ -27,6 +27,7 @@
 
 #include "builder.h"
 #include "codelite_exports.h"
+#include "macros.h"
 #include "project.h"
 #include "workspace.h"
 #include <wx/txtstrm.h>
@@ -39,6 +40,7 @@ class WXDLLIMPEXP_SDK BuilderGNUMakeClassic : public Builder
 {
     size_t m_objectChunks;
     Project::FilesMap_t* m_projectFilesMetadata;
+    wxStringMap_t m_makefileSignatures; // makefile path -> signature of the inputs used to generate it
 
 protected:
     enum eBuildFlags {
@@ -107,5 +109,16 @@ private:
     wxString DoGetCompilerMacro(const wxString& filename);
     wxString DoGetTargetPrefix(const wxFileName& filename, const wxString& cwd, CompilerPtr cmp);
     wxString DoGetMarkerFileDir(const wxString& projname, const wxString& projectPath = "");
+
+    /**
+     * @brief return a digest of the content of the inputs used to generate the project makefile
+     */
+    wxString DoGetMakefileSignature(ProjectPtr proj, BuildConfigPtr bldConf, const wxArrayString& depsProj,
+                                    const wxString& envVars) const;
+    /**
+     * @brief write content to filename, unless the file already has this content. The "Date" variable is not
+     * compared: it holds the date of the last generation that changed the makefile content, not the current date
+     */
+    bool DoWriteFileIfChanged(const wxString& filename, const wxString& content) const;
 };
 #endif // BUILDER_GNUMAKE_H
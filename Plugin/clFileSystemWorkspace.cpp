@@ -373,6 +373,7 @@ void clFileSystemWorkspace::New(const wxString& folder) { DoCreate("", folder, t
 
 void clFileSystemWorkspace::OnScanCompleted(clFileSystemEvent& event)
 {
+    event.Skip();
     clDEBUG() << "FSW: CacheFiles completed. Found" << event.GetPaths().size() << "files";
     m_files.clear();
     m_files.reserve(event.GetPaths().size());
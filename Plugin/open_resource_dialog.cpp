@@ -45,6 +45,115 @@
 #include <wx/xrc/xmlres.h>
 #include "clFileSystemWorkspace.hpp"
 
+#define OPEN_RESOURCE_MAX_FILES 100
+
+/**
+ * @brief the workspace files as seen by the "Open Resource" dialog. The list is kept between
+ * dialog invocations and is rebuilt only after the workspace or its file list has changed
+ */
+class OpenResourceFilesCache : public wxEvtHandler
+{
+public:
+    struct File {
+        wxString m_fullpath;
+        wxString m_lcFullpath; ///< lower case full path, used for matching
+        wxString m_lcHumps;    ///< lower case initials of the file name "humps" (e.g. "ord" for OpenResourceDialog.cpp)
+        size_t m_nameOffset;   ///< where the file name starts within the full path
+    };
+    typedef std::vector<File> Vec_t;
+
+protected:
+    Vec_t m_files;
+    bool m_dirty;
+
+protected:
+    void OnFilesChanged(wxCommandEvent& event)
+    {
+        event.Skip();
+        m_dirty = true;
+    }
+
+    static wxString GetHumps(const wxString& name)
+    {
+        wxString humps;
+        wxChar prev = 0;
+        for(size_t i = 0; i < name.length(); ++i) {
+            wxChar ch = name[i];
+            if(ch == '.') { break; }
+            bool newWord = (i == 0) || (wxIsupper(ch) && !wxIsupper(prev)) || (prev == '_' || prev == '-');
+            if(newWord && wxIsalnum(ch)) { humps << (wxChar)wxTolower(ch); }
+            prev = ch;
+        }
+        return humps;
+    }
+
+    void Add(const wxString& fullpath)
+    {
+        File f;
+        f.m_fullpath = fullpath;
+        f.m_lcFullpath = fullpath.Lower();
+        size_t sep = fullpath.find_last_of("/\\");
+        f.m_nameOffset = (sep == wxString::npos) ? 0 : sep + 1;
+        f.m_lcHumps = GetHumps(fullpath.Mid(f.m_nameOffset));
+        m_files.push_back(f);
+    }
+
+    void Rebuild(IManager* manager)
+    {
+        m_files.clear();
+        if(!::clIsCxxWorkspaceOpened()) { return; }
+        if(manager->IsWorkspaceOpen()) {
+            wxArrayString projects;
+            manager->GetWorkspace()->GetProjectList(projects);
+            for(size_t i = 0; i < projects.GetCount(); i++) {
+                ProjectPtr p = manager->GetWorkspace()->GetProject(projects.Item(i));
+                if(p) {
+                    const Project::FilesMap_t& files = p->GetFiles();
+                    std::for_each(files.begin(), files.end(),
+                                  [&](const Project::FilesMap_t::value_type& vt) { Add(vt.second->GetFilename()); });
+                }
+            }
+        } else if(clFileSystemWorkspace::Get().IsOpen()) {
+            const std::vector<wxFileName>& files = clFileSystemWorkspace::Get().GetFiles();
+            m_files.reserve(files.size());
+            for(const wxFileName& fn : files) {
+                Add(fn.GetFullPath());
+            }
+        }
+    }
+
+public:
+    OpenResourceFilesCache()
+        : m_dirty(true)
+    {
+        EventNotifier::Get()->Bind(wxEVT_WORKSPACE_LOADED, &OpenResourceFilesCache::OnFilesChanged, this);
+        EventNotifier::Get()->Bind(wxEVT_WORKSPACE_CLOSED, &OpenResourceFilesCache::OnFilesChanged, this);
+        EventNotifier::Get()->Bind(wxEVT_PROJ_ADDED, &OpenResourceFilesCache::OnFilesChanged, this);
+        EventNotifier::Get()->Bind(wxEVT_PROJ_REMOVED, &OpenResourceFilesCache::OnFilesChanged, this);
+        EventNotifier::Get()->Bind(wxEVT_PROJ_FILE_ADDED, &OpenResourceFilesCache::OnFilesChanged, this);
+        EventNotifier::Get()->Bind(wxEVT_PROJ_FILE_REMOVED, &OpenResourceFilesCache::OnFilesChanged, this);
+        EventNotifier::Get()->Bind(wxEVT_FS_SCAN_COMPLETED, &OpenResourceFilesCache::OnFilesChanged, this);
+    }
+
+    /**
+     * @brief the cache lives for the lifetime of the application
+     */
+    static OpenResourceFilesCache& Get()
+    {
+        static OpenResourceFilesCache* s_cache = new OpenResourceFilesCache();
+        return *s_cache;
+    }
+
+    const Vec_t& GetFiles(IManager* manager)
+    {
+        if(m_dirty) {
+            Rebuild(manager);
+            m_dirty = false;
+        }
+        return m_files;
+    }
+};
+
 BEGIN_EVENT_TABLE(OpenResourceDialog, OpenResourceDialogBase)
 EVT_TIMER(XRCID("OR_TIMER"), OpenResourceDialog::OnTimer)
 END_EVENT_TABLE()
@@ -92,31 +201,6 @@ OpenResourceDialog::OpenResourceDialog(wxWindow* parent, IManager* manager, cons
     SetName("OpenResourceDialog");
     WindowAttrManager::Load(this);
 
-    // load all files from the workspace
-    if(::clIsCxxWorkspaceOpened()) {
-        if(m_manager->IsWorkspaceOpen()) {
-            wxArrayString projects;
-            m_manager->GetWorkspace()->GetProjectList(projects);
-
-            for(size_t i = 0; i < projects.GetCount(); i++) {
-                ProjectPtr p = m_manager->GetWorkspace()->GetProject(projects.Item(i));
-                if(p) {
-                    const Project::FilesMap_t& files = p->GetFiles();
-                    // convert std::vector to wxArrayString
-                    std::for_each(files.begin(), files.end(), [&](const Project::FilesMap_t::value_type& vt) {
-                        wxFileName fn(vt.second->GetFilename());
-                        m_files.insert(std::make_pair(fn.GetFullName(), fn.GetFullPath()));
-                    });
-                }
-            }
-        } else if(clFileSystemWorkspace::Get().IsOpen()) {
-            const std::vector<wxFileName>& files = clFileSystemWorkspace::Get().GetFiles();
-            for(const wxFileName& fn : files) {
-                m_files.insert({ fn.GetFullName(), fn.GetFullPath() });
-            }
-        }
-    }
-
     wxString lastStringTyped = clConfig::Get().Read("OpenResourceDialog/SearchString", wxString());
     // Set the initial selection
     // We use here 'SetValue' so an event will get fired and update the control
@@ -195,6 +279,16 @@ void OpenResourceDialog::DoPopulateList()
         m_userFilters.Item(i).MakeLower();
     }
 
+    // Prepare the words used by MatchesFilter()
+    m_matchWords.Clear();
+    wxString matchFilter = m_textCtrlResourceName->GetValue();
+    if(matchFilter.Contains(':')) { matchFilter = matchFilter.BeforeLast(':'); }
+    size_t offset = 0;
+    wxString word;
+    while(FileUtils::NextWord(matchFilter, offset, word, true)) {
+        m_matchWords.Add(word);
+    }
+
     // Build the filter class
     if(m_checkBoxFiles->IsChecked()) { DoPopulateWorkspaceFile(); }
     if(m_checkBoxShowSymbols->IsChecked() && (nLineNumber == -1)) { DoPopulateTags(); }
@@ -248,22 +342,63 @@ void OpenResourceDialog::DoPopulateWorkspaceFile()
     // do we need to include files?
     if(!m_filters.IsEmpty() && m_filters.Index(KIND_FILE) == wxNOT_FOUND) return;
 
-    if(!m_userFilters.IsEmpty()) {
-
-        std::unordered_multimap<wxString, wxString>::iterator iter = m_files.begin();
-        const int maxFileSize = 100;
-        int counter = 0;
-        for(; (iter != m_files.end()) && (counter < maxFileSize); iter++) {
-            const wxString& fullpath = iter->second;
-            if(!MatchesFilter(fullpath)) continue;
-
-            wxFileName fn(iter->second);
-            int imgId = clGetManager()->GetStdIcons()->GetMimeImageId(fn.GetFullName());
-            DoAppendLine(fn.GetFullName(), fn.GetFullPath(), false,
-                         new OpenResourceDialogItemData(fn.GetFullPath(), -1, wxT(""), fn.GetFullName(), wxT("")),
-                         imgId);
-            ++counter;
+    if(m_userFilters.IsEmpty() || m_matchWords.IsEmpty()) { return; }
+
+    // Files that are already opened in an editor get a small bonus
+    wxStringSet_t openFiles;
+    IEditor::List_t editors;
+    m_manager->GetAllEditors(editors);
+    for(IEditor* editor : editors) {
+        openFiles.insert(editor->GetFileName().GetFullPath());
+    }
+
+    // Score every matching file and keep only the best OPEN_RESOURCE_MAX_FILES entries
+    typedef std::pair<int, const OpenResourceFilesCache::File*> Match_t;
+    std::vector<Match_t> matches;
+    const OpenResourceFilesCache::Vec_t& files = OpenResourceFilesCache::Get().GetFiles(m_manager);
+    for(const OpenResourceFilesCache::File& file : files) {
+        int score = 0;
+        bool matched = true;
+        for(size_t i = 0; i < m_matchWords.GetCount() && matched; ++i) {
+            const wxString& word = m_matchWords.Item(i);
+            size_t where = file.m_lcFullpath.find(word);
+            if(where == wxString::npos) {
+                // no plain match, try the file name humps
+                matched = file.m_lcHumps.StartsWith(word);
+                if(matched) { score += 15; }
+                continue;
+            }
+
+            // prefer matches in the file name over matches in the folders
+            size_t inName = file.m_lcFullpath.find(word, file.m_nameOffset);
+            if(inName == file.m_nameOffset) {
+                score += (file.m_lcFullpath.length() - inName == word.length()) ? 100 : 40;
+            } else if(inName != wxString::npos) {
+                score += 20;
+            } else if(where == 0 || file.m_lcFullpath[where - 1] == '/' || file.m_lcFullpath[where - 1] == '\\') {
+                // starts a path segment
+                score += 5;
+            }
         }
+        if(!matched) { continue; }
+        if(openFiles.count(file.m_fullpath)) { score += 10; }
+        matches.push_back({ score, &file });
+    }
+
+    auto Compare = [](const Match_t& a, const Match_t& b) {
+        if(a.first != b.first) { return a.first > b.first; }
+        // shorter paths first
+        return a.second->m_fullpath.length() < b.second->m_fullpath.length();
+    };
+    size_t count = std::min(matches.size(), (size_t)OPEN_RESOURCE_MAX_FILES);
+    std::partial_sort(matches.begin(), matches.begin() + count, matches.end(), Compare);
+
+    for(size_t i = 0; i < count; ++i) {
+        const OpenResourceFilesCache::File& file = *matches[i].second;
+        wxString fullname = file.m_fullpath.Mid(file.m_nameOffset);
+        int imgId = clGetManager()->GetStdIcons()->GetMimeImageId(fullname);
+        DoAppendLine(fullname, file.m_fullpath, false,
+                     new OpenResourceDialogItemData(file.m_fullpath, -1, wxT(""), fullname, wxT("")), imgId);
     }
 }
 
@@ -372,11 +507,13 @@ int OpenResourceDialog::DoGetTagImg(TagEntryPtr tag)
     return clGetManager()->GetStdIcons()->GetImageIndex(imgId);
 }
 
-bool OpenResourceDialog::MatchesFilter(const wxString& name)
+bool OpenResourceDialog::MatchesFilter(const wxString& name) const
 {
-    wxString filter = m_textCtrlResourceName->GetValue();
-    if(filter.Contains(':') == true) { filter = filter.BeforeLast(':'); }
-    return FileUtils::FuzzyMatch(filter, name);
+    wxString lcName = name.Lower();
+    for(size_t i = 0; i < m_matchWords.GetCount(); ++i) {
+        if(!lcName.Contains(m_matchWords.Item(i))) { return false; }
+    }
+    return true;
 }
 
 void OpenResourceDialog::OnCheckboxfilesCheckboxClicked(wxCommandEvent& event) { DoPopulateList(); }
@@ -79,12 +79,12 @@ public:
 class WXDLLIMPEXP_SDK OpenResourceDialog : public OpenResourceDialogBase
 {
     IManager* m_manager;
-    std::unordered_multimap<wxString, wxString> m_files;
     std::unordered_map<wxString, int> m_fileTypeHash;
     wxTimer* m_timer;
     bool m_needRefresh;
     wxArrayString m_filters;
     wxArrayString m_userFilters;
+    wxArrayString m_matchWords; ///< lower case words used by MatchesFilter, computed once per search
     long m_lineNumber;
 
 protected:
@@ -95,7 +95,7 @@ protected:
     virtual void OnCheckboxshowsymbolsCheckboxClicked(wxCommandEvent& event);
     void DoPopulateList();
     void DoPopulateWorkspaceFile();
-    bool MatchesFilter(const wxString& name);
+    bool MatchesFilter(const wxString& name) const;
     void DoPopulateTags();
     void DoSelectItem(const wxDataViewItem& item);
     void Clear();
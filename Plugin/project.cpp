@@ -116,6 +116,12 @@ bool Project::Create(const wxString& name, const wxString& description, const wx
 }
 
 bool Project::Load(const wxString& path)
+{
+    if(!ParseXml(path)) { return false; }
+    return CompleteLoad();
+}
+
+bool Project::ParseXml(const wxString& path)
 {
     if(!m_doc.Load(path)) { return false; }
 
@@ -130,6 +136,11 @@ bool Project::Load(const wxString& path)
     m_projectPath = m_fileName.GetPath();
 
     DoBuildCacheFromXml();
+    return true;
+}
+
+bool Project::CompleteLoad()
+{
     SetModified(true);
     SetProjectLastModifiedTime(GetFileLastModifiedTime());
 
@@ -907,6 +918,14 @@ void Project::SetAllPluginsData(const std::map<wxString, wxString>& pluginsDataM
 
 time_t Project::GetFileLastModifiedTime() const { return GetFileModificationTime(GetFileName()); }
 
+wxString Project::GetXmlString() const
+{
+    wxString projectXml;
+    wxStringOutputStream sos(&projectXml);
+    m_doc.Save(sos);
+    return projectXml;
+}
+
 void Project::ConvertToUnixFormat(wxXmlNode* parent)
 {
     if(!parent) return;
@@ -460,6 +460,19 @@ public:
      * \return
      */
     bool Load(const wxString& path);
+
+    /**
+     * @brief first phase of Load(): parse the XML file and build the files and virtual folders cache.
+     * This method only touches this project's members, so it is safe to call it from a worker thread
+     * (as long as no other thread accesses this project)
+     */
+    bool ParseXml(const wxString& path);
+
+    /**
+     * @brief second phase of Load(): load the project settings and upgrade the file version if needed.
+     * Must be called from the main thread after a successful call to ParseXml()
+     */
+    bool CompleteLoad();
     /**
      * \brief Create new project
      * \param name project name
@@ -724,6 +737,12 @@ public:
      */
     time_t GetFileLastModifiedTime() const;
 
+    /**
+     * @brief return the project XML, as it would be written to the disk (including the changes that were not
+     * saved yet)
+     */
+    wxString GetXmlString() const;
+
     /**
      * return/set the last modification time that was made by the editor
      */
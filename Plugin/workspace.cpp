@@ -49,6 +49,9 @@
 #include "compiler_command_line_parser.h"
 #include "fileutils.h"
 #include <wx/sstream.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
 
 clCxxWorkspace::clCxxWorkspace()
     : m_saveOnExit(true)
@@ -1245,20 +1248,79 @@ void clCxxWorkspace::DoUnselectActiveProject()
 
 void clCxxWorkspace::DoLoadProjectsFromXml(wxXmlNode* parentNode, const wxString& folder,
                                            std::vector<wxXmlNode*>& removedChildren)
+{
+    std::vector<ProjectLoadEntry> entries;
+    DoCollectProjectsFromXml(parentNode, folder, entries);
+    if(entries.empty()) { return; }
+
+    // Parsing the project files is the expensive part of loading a workspace and it does not touch any global
+    // state, so we do it concurrently. Each worker picks the next unparsed project until none are left
+    std::vector<ProjectPtr> projects;
+    projects.reserve(entries.size());
+    for(size_t i = 0; i < entries.size(); ++i) {
+        projects.push_back(ProjectPtr(new Project()));
+    }
+
+    // Note: std::vector<bool> is not safe for concurrent writes to different elements
+    std::vector<char> parsed(entries.size(), 0);
+    std::atomic_size_t nextEntry(0);
+    auto parseProjects = [&]() {
+        size_t index = nextEntry++;
+        while(index < entries.size()) {
+            parsed[index] = projects[index]->ParseXml(entries[index].path) ? 1 : 0;
+            index = nextEntry++;
+        }
+    };
+
+    size_t threadsCount = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), entries.size());
+    std::vector<std::thread> workers;
+    for(size_t i = 1; i < threadsCount; ++i) {
+        workers.push_back(std::thread(parseProjects));
+    }
+    // The calling thread also takes its share of the work
+    parseProjects();
+    for(std::thread& worker : workers) {
+        worker.join();
+    }
+    clDEBUG() << "Parsed" << entries.size() << "project files using" << threadsCount << "threads" << clEndl;
+
+    // Complete the loading on the main thread, in the order the projects appear in the workspace file
+    for(size_t i = 0; i < entries.size(); ++i) {
+        ProjectPtr proj = projects[i];
+        if(!parsed[i] || !proj->CompleteLoad()) {
+            clWARNING() << "Corrupted project file:" << entries[i].path << clEndl;
+            removedChildren.push_back(entries[i].node);
+            continue;
+        }
+        m_projects.insert(std::make_pair(proj->GetName(), proj));
+        proj->AssociateToWorkspace(this);
+        proj->SetWorkspaceFolder(entries[i].folder);
+    }
+}
+
+void clCxxWorkspace::DoCollectProjectsFromXml(wxXmlNode* parentNode, const wxString& folder,
+                                              std::vector<ProjectLoadEntry>& entries)
 {
     wxXmlNode* child = parentNode->GetChildren();
     while(child) {
         if(child->GetName() == wxT("Project")) {
-            wxString projectPath = child->GetPropVal(wxT("Path"), wxEmptyString);
-            wxString errmsg;
-            if(!DoAddProject(projectPath, folder, errmsg)) { removedChildren.push_back(child); }
+            // Convert the path to absolute path
+            wxFileName projectFile(child->GetPropVal(wxT("Path"), wxEmptyString));
+            if(projectFile.IsRelative()) { projectFile.MakeAbsolute(m_fileName.GetPath()); }
+
+            ProjectLoadEntry entry;
+            entry.path = projectFile.GetFullPath();
+            entry.folder = folder;
+            entry.node = child;
+            entries.push_back(entry);
+
         } else if(child->GetName() == wxT("VirtualDirectory")) {
             // Virtual directory
             wxString currentFolder = folder;
             wxString vdName = child->GetAttribute("Name", wxEmptyString);
             if(!currentFolder.IsEmpty()) { currentFolder << "/"; }
             currentFolder << vdName;
-            DoLoadProjectsFromXml(child, currentFolder, removedChildren);
+            DoCollectProjectsFromXml(child, currentFolder, entries);
         } else if((child->GetName() == wxT("WorkspaceParserPaths")) ||
                   (child->GetName() == wxT("WorkspaceParserMacros"))) {
             wxString swtlw = XmlUtils::ReadString(m_doc.GetRoot(), "SWTLW");
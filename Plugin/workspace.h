@@ -109,10 +109,25 @@ private:
     void DoUnselectActiveProject();
 
     /**
-     * @brief load projects from the XML file
+     * @brief a project found in the workspace XML file, waiting to be loaded
+     */
+    struct ProjectLoadEntry {
+        wxString path;   // project file full path
+        wxString folder; // workspace folder
+        wxXmlNode* node; // the workspace XML node of this project
+    };
+
+    /**
+     * @brief load projects from the XML file. The project files are parsed concurrently
      */
     void DoLoadProjectsFromXml(wxXmlNode* parentNode, const wxString& folder, std::vector<wxXmlNode*>& removedChildren);
 
+    /**
+     * @brief collect the projects listed in the XML file (recursively)
+     */
+    void DoCollectProjectsFromXml(wxXmlNode* parentNode, const wxString& folder,
+                                  std::vector<ProjectLoadEntry>& entries);
+
     // return the wxXmlNode instance for the give path
     // the path is separated by "/"
     // return NULL if no such virtual directory exists
@@ -97,13 +97,7 @@ void SFTPWorkerThread::ProcessRequest(ThreadRequest* request)
             case eSFTPActions::kDownloadAndOpenContainingFolder:
             case eSFTPActions::kDownloadAndOpenWithDefaultApp: {
                 DoReportStatusBarMessage(wxString() << _("Downloading file: ") << req->GetRemoteFile());
-                wxMemoryBuffer buffer;
-                SFTPAttribute::Ptr_t fileAttr = m_sftp->Read(req->GetRemoteFile(), buffer);
-                wxFFile fp(req->GetLocalFile(), "w+b");
-                if(fp.IsOpened()) {
-                    fp.Write(buffer.GetData(), buffer.GetDataLen());
-                    fp.Close();
-                }
+                SFTPAttribute::Ptr_t fileAttr = m_sftp->Read(req->GetRemoteFile(), wxFileName(req->GetLocalFile()));
 
                 msg << "Successfully downloaded file: " << req->GetLocalFile() << " <- " << req->GetRemoteFile();
                 DoReportMessage(accountName, msg, SFTPThreadMessage::STATUS_OK);
@@ -57,6 +57,7 @@
 
 // ------------------------------------------------------------
 #define MIN_TOKEN_LEN 3
+#define MAX_CACHED_WORDS 50000
 // ------------------------------------------------------------
 IHunSpell::IHunSpell() :
     m_caseSensitiveUserDictionary(true),
@@ -117,6 +118,7 @@ bool IHunSpell::InitEngine()
 // ------------------------------------------------------------
 void IHunSpell::CloseEngine()
 {
+    ClearWordCache();
     if(m_pSpell != NULL) {
         Hunspell_destroy(m_pSpell);
         SaveUserDict(m_userDictPath + s_userDict);
@@ -174,7 +176,7 @@ wxArrayString IHunSpell::GetSuggestions(const wxString& misspelled)
     return suggestions;
 }
 // ------------------------------------------------------------
-void IHunSpell::CheckCppSpelling(const wxString& check)
+void IHunSpell::CheckCppSpelling(const wxString& check, int from, int to)
 {
     IEditor* pEditor = m_pPlugIn->GetEditor();
 
@@ -198,7 +200,8 @@ void IHunSpell::CheckCppSpelling(const wxString& check)
     }
     posLen query;
 
-    for(int i = 0; i < pEditor->GetLength(); i++) {
+    if(to == wxNOT_FOUND || to > pEditor->GetLength()) { to = pEditor->GetLength(); }
+    for(int i = from; i < to; i++) {
         switch(pTextCtrl->GetStyleAt(i)) {
         case SCT_STRING: {
             query.first = i;
@@ -257,13 +260,12 @@ void IHunSpell::CheckCppSpelling(const wxString& check)
         retVal = MarkErrors(pEditor);
 }
 // ------------------------------------------------------------
-void IHunSpell::CheckSpelling(const wxString& check)
+void IHunSpell::CheckSpelling(const wxString& check, int offset)
 {
     IEditor* pEditor = m_pPlugIn->GetEditor();
 
     if(!pEditor) return;
 
-    int offset = 0;
     bool error = false;
     wxString text = check + wxT(" ");
 
@@ -277,6 +279,9 @@ void IHunSpell::CheckSpelling(const wxString& check)
     m_pSpellDlg->SetPHs(this);
     wxStringTokenizer tkz(text, s_defDelimiters);
 
+    // in continuous mode, remove the marks of the previous check
+    if(m_pPlugIn->GetCheckContinuous()) { pEditor->ClearUserIndicators(); }
+
     while(tkz.HasMoreTokens()) {
         wxString token = tkz.GetNextToken();
         int pos = tkz.GetPosition() - token.Len() - 1;
@@ -345,6 +350,7 @@ void IHunSpell::AddWordToIgnoreList(const wxString& word)
     if(word.IsEmpty()) return;
 
     m_ignoreList.insert(word);
+    ClearWordCache();
 }
 // ------------------------------------------------------------
 void IHunSpell::AddWordToUserDict(const wxString& word)
@@ -352,6 +358,7 @@ void IHunSpell::AddWordToUserDict(const wxString& word)
     if(word.IsEmpty()) return;
 
     m_userDict.insert(word);
+    ClearWordCache();
 }
 // ------------------------------------------------------------
 bool IHunSpell::LoadUserDict(const wxString& filename)
@@ -525,7 +532,7 @@ int IHunSpell::CheckCppType(IEditor* pEditor)
 
         if(m_parseValues[i].second ==
            kString) { // replace \n\r\t in strings with blanks to correctly tokenize content like '\nNext line'
-            wxRegEx re(s_wsRegEx, wxRE_ADVANCED);
+            static thread_local wxRegEx re(s_wsRegEx, wxRE_ADVANCED);
             // to ensure that \\n will not get captured by the regex, we temporarily replace it
             text.Replace(s_DOUBLE_BACKSLASH, s_PLACE_HOLDER);
 
@@ -601,9 +608,15 @@ int IHunSpell::MarkErrors(IEditor* pEditor)
         wxString text = pEditor->GetTextRange(pl.first, pl.second);
         wxString del = s_commentDelimiters;
 
+        if(m_parseValues[i].second == kString) {
+            // ignore filenames in #include
+            wxString line = pEditor->GetCtrl()->GetLine(pEditor->LineFromPos(pl.first));
+            if(line.Find(s_include) != wxNOT_FOUND) continue;
+        }
+
         if(m_parseValues[i].second ==
            kString) { // replace \n\r\t in strings with blanks to correctly tokenize content like '\nNext line'
-            wxRegEx re(s_wsRegEx, wxRE_ADVANCED);
+            static thread_local wxRegEx re(s_wsRegEx, wxRE_ADVANCED);
             // to ensure that \\n will not get captured by the regex, we temporarily replace it
             text.Replace(s_DOUBLE_BACKSLASH, s_PLACE_HOLDER);
             if(re.Matches(text)) {
@@ -620,14 +633,7 @@ int IHunSpell::MarkErrors(IEditor* pEditor)
 
             if(token.Len() <= MIN_TOKEN_LEN) continue;
 
-            if(m_parseValues[i].second == kString) {
-                wxString line = pEditor->GetCtrl()->GetLine(pEditor->LineFromPos(pl.first));
-
-                if(line.Find(s_include) != wxNOT_FOUND) // ignore filenames
-                    continue;
-            }
-
-            if(!CheckWord(token) && !IsTag(token)) {
+            if(IsMisspelled(token)) {
                 pEditor->SetUserIndicator(pos, token.Len());
                 counter++;
             }
@@ -636,6 +642,18 @@ int IHunSpell::MarkErrors(IEditor* pEditor)
 
     return counter;
 }
+// ------------------------------------------------------------
+bool IHunSpell::IsMisspelled(const wxString& word)
+{
+    // Looking up the tags database is expensive, so keep the verdicts between checks
+    std::unordered_map<wxString, bool>::const_iterator iter = m_wordCache.find(word);
+    if(iter != m_wordCache.end()) { return iter->second; }
+
+    if(m_wordCache.size() >= MAX_CACHED_WORDS) { ClearWordCache(); }
+    bool misspelled = !CheckWord(word) && !IsTag(word);
+    m_wordCache.insert(std::make_pair(word, misspelled));
+    return misspelled;
+}
 
 void IHunSpell::SetCaseSensitiveUserDictionary(const bool caseSensitiveUserDictionary) {
     if (caseSensitiveUserDictionary != m_caseSensitiveUserDictionary)
@@ -650,6 +668,7 @@ void IHunSpell::SetCaseSensitiveUserDictionary(const bool caseSensitiveUserDicti
         CustomDictionary ignoreList(m_ignoreList.begin(), m_ignoreList.end(), 0,
             StringHashOptionalCase(caseSensitiveUserDictionary), StringCompareOptionalCase(caseSensitiveUserDictionary));
         m_ignoreList.swap(ignoreList);
+        ClearWordCache();
     }
 }
 
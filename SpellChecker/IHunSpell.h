@@ -40,6 +40,7 @@
 #include <wx/hashmap.h>
 #include <vector>
 #include <utility>
+#include <unordered_map>
 #include <unordered_set>
 #include "wxStringHash.h"
 // ------------------------------------------------------------
@@ -101,7 +102,13 @@ public:
     virtual ~IHunSpell();
 
     /// Clears the ignore list
-    void ClearIgnoreList() { m_ignoreList.clear(); }
+    void ClearIgnoreList()
+    {
+        m_ignoreList.clear();
+        ClearWordCache();
+    }
+    /// Clears the cached verdicts of the continuous check, must be called whenever the result of a check may change
+    void ClearWordCache() { m_wordCache.clear(); }
     /// initializes spelling engine. This will be done automatic on the first check.
     bool InitEngine();
     /// close the engine. The engine must be closed before a new init or when the program finishes.
@@ -115,9 +122,11 @@ public:
     /// returns an array with suggestions for the misspelled word.
     wxArrayString GetSuggestions(const wxString& misspelled);
     /// makes a spell check for the given cpp text. Canceled is set to true when the user cancels.
-    void CheckCppSpelling(const wxString& check);
+    /// from/to limit the check to a range of the editor (to == wxNOT_FOUND means up to the end)
+    void CheckCppSpelling(const wxString& check, int from = 0, int to = wxNOT_FOUND);
     /// makes a spell check for the given plain text. Canceled is set to true when the user cancels.
-    void CheckSpelling(const wxString& check);
+    /// offset is the position of the text in the editor
+    void CheckSpelling(const wxString& check, int offset = 0);
     /// retrieves all predefined language names, used as key to get the filename
     void GetAllLanguageKeyNames(wxArrayString& lang);
     /// checks for predefined language names, which could be found in path
@@ -135,7 +144,11 @@ public:
     void SetCaseSensitiveUserDictionary(const bool caseSensitiveUserDictionary);
     /// gets whether user dictionary and ignored words are case sensitive
     bool GetCaseSensitiveUserDictionary() const { return m_caseSensitiveUserDictionary; }
-    void SetIgnoreSymbolsInTagsDatabase(const bool ignoreSymbolsInTagsDatabase) { m_ignoreSymbolsInTagsDatabase = ignoreSymbolsInTagsDatabase; }
+    void SetIgnoreSymbolsInTagsDatabase(const bool ignoreSymbolsInTagsDatabase)
+    {
+        m_ignoreSymbolsInTagsDatabase = ignoreSymbolsInTagsDatabase;
+        ClearWordCache();
+    }
     /// gets whether to ignore words that match ctags symbols
     bool GetIgnoreSymbolsInTagsDatabase() const { return m_ignoreSymbolsInTagsDatabase; }
     ///
@@ -181,6 +194,7 @@ protected:
 
     int CheckCppType(IEditor* pEditor);
     int MarkErrors(IEditor* pEditor);
+    bool IsMisspelled(const wxString& word);
     void InitLanguageList();
 
     bool LoadUserDict(const wxString& filename);
@@ -201,6 +215,7 @@ protected:
     CorrectSpellingDlg* m_pSpellDlg; // pointer to correction dialog
 
     partList m_parseValues; // list with position results for CPP parsing
+    std::unordered_map<wxString, bool> m_wordCache; // continuous check verdicts: word -> misspelled
 
     int m_scanners; // flags for scanner types
 };
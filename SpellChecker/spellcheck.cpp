@@ -97,6 +97,7 @@ CL_PLUGIN_API int GetPluginInterfaceVersion() { return PLUGIN_INTERFACE_VERSION;
 SpellCheck::SpellCheck(IManager* manager)
     : IPlugin(manager)
     , m_pLastEditor(nullptr)
+    , m_lastFirstVisibleLine(wxNOT_FOUND)
 {
     Init();
 }
@@ -392,19 +393,33 @@ void SpellCheck::OnTimer(wxTimerEvent& e)
     if(!editor) return;
 
     if(GetCheckContinuous()) {
+        // Only the visible part of the editor is checked, so we also need to run the checks when it was scrolled
+        wxStyledTextCtrl* ctrl = editor->GetCtrl();
+        int firstLine = ctrl->DocLineFromVisible(ctrl->GetFirstVisibleLine());
+        int lastLine = ctrl->DocLineFromVisible(ctrl->GetFirstVisibleLine() + ctrl->LinesOnScreen());
+
         // Only run the checks if we've not run them or the file is modified.
         const auto modificationCount(editor->GetModificationCount());
-        if((editor == m_pLastEditor) && (m_lastModificationCount == modificationCount)) { return; }
+        if((editor == m_pLastEditor) && (m_lastModificationCount == modificationCount) &&
+           (m_lastFirstVisibleLine == firstLine)) {
+            return;
+        }
+
+        // the tags database may have changed in the meantime
+        if(editor != m_pLastEditor) { m_pEngine->ClearWordCache(); }
 
         m_pLastEditor = editor;
         m_lastModificationCount = modificationCount;
+        m_lastFirstVisibleLine = firstLine;
 
+        int from = ctrl->PositionFromLine(firstLine);
+        int to = ctrl->GetLineEndPosition(lastLine);
         switch(editor->GetLexerId()) {
         case wxSTC_LEX_CPP: {
-            if(m_mgr->IsWorkspaceOpen()) { m_pEngine->CheckCppSpelling(editor->GetEditorText()); }
+            if(m_mgr->IsWorkspaceOpen()) { m_pEngine->CheckCppSpelling(wxEmptyString, from, to); }
         } break;
         default: {
-            m_pEngine->CheckSpelling(editor->GetEditorText());
+            m_pEngine->CheckSpelling(ctrl->GetTextRange(from, to), from);
         } break;
         }
     }
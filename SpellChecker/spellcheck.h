@@ -91,6 +91,7 @@ protected:
 
     IEditor* m_pLastEditor;           // The editor checked last time the spell check ran.
     wxUint64 m_lastModificationCount; // Modification count of the editor last time the spell check ran.
+    int m_lastFirstVisibleLine;       // First visible line of the editor last time the spell check ran.
 };
 //------------------------------------------------------------
 #endif // SpellCheck
@@ -12,6 +12,40 @@
 #include <wx/ffile.h>
 #include <wx/filedlg.h>
 #include "clThemeUpdater.h"
+#include <string>
+#include <wx/filefn.h>
+
+namespace
+{
+// Return an identifier of the file on disk. It changes when the file is replaced by a new file with the same name
+// (e.g. log rotation), even when the new file is already larger than the old one
+wxString GetFileIdentity(const wxFileName& fn)
+{
+#ifdef __WXMSW__
+    wxDateTime created;
+    if(!fn.GetTimes(NULL, NULL, &created) || !created.IsValid()) { return ""; }
+    return created.GetValue().ToString();
+#else
+    wxStructStat buff;
+    if(wxStat(fn.GetFullPath(), &buff) != 0) { return ""; }
+    return wxString::Format("%llu:%llu", (unsigned long long)buff.st_dev, (unsigned long long)buff.st_ino);
+#endif
+}
+
+// Return the number of bytes at the end of 'buffer' that belong to an incomplete UTF-8 sequence
+size_t GetIncompleteUTF8Length(const std::string& buffer)
+{
+    size_t count = 0;
+    for(size_t i = buffer.length(); (i > 0) && (count < 4); --i) {
+        unsigned char ch = buffer[i - 1];
+        ++count;
+        if((ch & 0xC0) == 0x80) { continue; } // a continuation byte
+        size_t expected = (ch >= 0xF0) ? 4 : (ch >= 0xE0) ? 3 : (ch >= 0xC0) ? 2 : 1;
+        return (expected > count) ? count : 0;
+    }
+    return 0;
+}
+} // namespace
 
 TailPanel::TailPanel(wxWindow* parent, Tail* plugin)
     : TailPanelBase(parent)
@@ -24,6 +58,8 @@ TailPanel::TailPanel(wxWindow* parent, Tail* plugin)
     clThemeUpdater::Get().RegisterWindow(m_staticTextFileName);
     
     DoBuildToolbar();
+    // The view is read-only, keeping undo history for every appended chunk is just a waste of memory
+    m_stc->SetUndoCollection(false);
     m_fileWatcher.reset(new clFileSystemWatcher());
     m_fileWatcher->SetOwner(this);
     Bind(wxEVT_FILE_MODIFIED, &TailPanel::OnFileModified, this);
@@ -59,6 +95,7 @@ void TailPanel::DoClear()
     m_stc->ClearAll();
     m_stc->SetReadOnly(true);
     m_lastPos = 0;
+    m_fileId.Clear();
 
     m_staticTextFileName->SetLabel(_("<No opened file>"));
     SetFrameTitle();
@@ -70,21 +107,56 @@ void TailPanel::OnFileModified(clFileSystemEvent& event)
     wxFileName fn(event.GetPath());
     // Get the current file size
     size_t cursize = FileUtils::GetFileSize(m_file);
+    wxString fileId = GetFileIdentity(m_file);
+    if(fileId.IsEmpty()) {
+        // The file does not exist at the moment (e.g. it is being rotated)
+        return;
+    }
+    if((cursize < m_lastPos) || (fileId != m_fileId)) {
+        // The file was truncated or rotated (a new file was created with the same name), start over from the top
+        DoAppendText(_("\n>>> File truncated <<<\n"));
+        m_lastPos = 0;
+        m_fileId = fileId;
+    }
+    if(cursize == m_lastPos) { return; }
+
+    size_t bufferSize = cursize - m_lastPos;
+    bool skipped = false;
+    if(bufferSize > TAIL_MAX_BUFFER_SIZE) {
+        // Anything beyond the scrollback limit would be removed right away, so don't bother reading it
+        DoAppendText(wxString::Format(_("\n>>> Skipped %u bytes <<<\n"), (unsigned)(bufferSize - TAIL_MAX_BUFFER_SIZE)));
+        m_lastPos = cursize - TAIL_MAX_BUFFER_SIZE;
+        bufferSize = TAIL_MAX_BUFFER_SIZE;
+        skipped = true;
+    }
+
     wxFFile fp(m_file.GetFullPath(), "rb");
     if(fp.IsOpened() && fp.Seek(m_lastPos)) {
-        if(cursize > m_lastPos) {
-            size_t bufferSize = cursize - m_lastPos;
-            char* buffer = new char[bufferSize + 1];
-            if(fp.Read(buffer, bufferSize) == bufferSize) {
-                buffer[bufferSize] = '\0';
-                wxString content((const char*)buffer, wxConvUTF8);
-                DoAppendText(content);
+        std::string buffer(bufferSize, '\0');
+        if(fp.Read(&buffer[0], bufferSize) == bufferSize) {
+            if(skipped) {
+                // We are somewhere in the middle of a line, possibly in the middle of a multi-byte character:
+                // start from the next line
+                size_t where = buffer.find('\n');
+                buffer.erase(0, (where == std::string::npos) ? 0 : where + 1);
+                while(!buffer.empty() && ((buffer[0] & 0xC0) == 0x80)) {
+                    buffer.erase(0, 1);
+                }
+            }
+
+            // A character that is still being written is read on the next update
+            size_t incomplete = GetIncompleteUTF8Length(buffer);
+            buffer.resize(buffer.length() - incomplete);
+            wxString content(buffer.c_str(), wxConvUTF8, buffer.length());
+            if(content.IsEmpty() && !buffer.empty()) {
+                // Not a valid UTF-8 text: display the bytes as they are rather than nothing
+                content = wxString(buffer.c_str(), wxConvISO8859_1, buffer.length());
             }
-            wxDELETEA(buffer);
+            DoAppendText(content);
+            m_lastPos = cursize - incomplete;
         } else {
-            DoAppendText(_("\n>>> File truncated <<<\n"));
+            m_lastPos = cursize;
         }
-        m_lastPos = cursize;
     }
 }
 
@@ -92,6 +164,7 @@ void TailPanel::DoAppendText(const wxString& text)
 {
     m_stc->SetReadOnly(false);
     m_stc->AppendText(text);
+    DoTrimScrollback();
     m_stc->SetReadOnly(true);
     m_stc->SetSelectionEnd(m_stc->GetLength());
     m_stc->SetSelectionStart(m_stc->GetLength());
@@ -99,6 +172,17 @@ void TailPanel::DoAppendText(const wxString& text)
     m_stc->EnsureCaretVisible();
 }
 
+void TailPanel::DoTrimScrollback()
+{
+    int length = m_stc->GetLength();
+    if(length <= TAIL_MAX_BUFFER_SIZE) { return; }
+
+    // Remove whole lines from the top so the view stays within the scrollback limit
+    int line = m_stc->LineFromPosition(length - TAIL_MAX_BUFFER_SIZE);
+    int end = ((line + 1) < m_stc->GetLineCount()) ? m_stc->PositionFromLine(line + 1) : length;
+    m_stc->DeleteRange(0, end);
+}
+
 void TailPanel::OnThemeChanged(wxCommandEvent& event)
 {
     event.Skip(); // must call this to allow other handlers to work
@@ -141,6 +225,7 @@ void TailPanel::DoOpen(const wxString& filename)
 {
     m_file = filename;
     m_lastPos = FileUtils::GetFileSize(m_file);
+    m_fileId = GetFileIdentity(m_file);
 
     wxArrayString recentItems = clConfig::Get().Read("tail", wxArrayString());
     if(recentItems.Index(m_file.GetFullPath()) == wxNOT_FOUND) {
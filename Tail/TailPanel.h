@@ -10,6 +10,9 @@
 #include <vector>
 #include <wx/filename.h>
 
+// The maximum amount of text (in bytes) kept in the view, older lines are removed
+#define TAIL_MAX_BUFFER_SIZE (10 * 1024 * 1024)
+
 class TailFrame;
 class clToolBar;
 class Tail;
@@ -18,6 +21,7 @@ class TailPanel : public TailPanelBase
     clFileSystemWatcher::Ptr_t m_fileWatcher;
     wxFileName m_file;
     size_t m_lastPos;
+    wxString m_fileId; // identifies the file on disk, to detect a file replaced by another one
     clEditEventsHandler::Ptr_t m_editEvents;
     std::map<int, wxString> m_recentItemsMap;
     Tail* m_plugin;
@@ -41,6 +45,7 @@ private:
     void DoClear();
     void DoOpen(const wxString& filename);
     void DoAppendText(const wxString& text);
+    void DoTrimScrollback();
     void DoPrepareRecentItemsMenu(wxMenu& menu);
     wxString GetTailTitle() const;
 
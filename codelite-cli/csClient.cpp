@@ -0,0 +1,37 @@
+#include "csClient.h"
+#include "file_logger.h"
+#include <iostream>
+
+void csStdoutClient::Write(const wxString& reply)
+{
+    // Replies to different requests may be written by different threads: don't interleave them
+    static wxMutex mutex;
+    wxMutexLocker locker(mutex);
+    std::cout << reply << std::endl;
+}
+
+csSocketClient::csSocketClient(clSocketBase::Ptr_t socket)
+    : m_socket(socket)
+    , m_closed(false)
+{
+}
+
+csSocketClient::~csSocketClient() {}
+
+void csSocketClient::Write(const wxString& reply)
+{
+    wxMutexLocker locker(m_mutex);
+    if(m_closed) { return; }
+    try {
+        m_socket->Send(reply + "\n");
+    } catch(clSocketException& e) {
+        clWARNING() << "Failed to send reply:" << e.what();
+        m_closed = true;
+    }
+}
+
+void csSocketClient::Close()
+{
+    wxMutexLocker locker(m_mutex);
+    m_closed = true;
+}
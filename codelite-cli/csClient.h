@@ -0,0 +1,74 @@
+#ifndef CSCLIENT_H
+#define CSCLIENT_H
+
+#include "SocketAPI/clSocketBase.h"
+#include <wx/sharedptr.h>
+#include <wx/string.h>
+#include <wx/thread.h>
+
+/**
+ * @class csClient
+ * @brief the origin of a request and the destination of its reply. The requests of a client are processed one after
+ * the other, in the order they were received: replies are written in the same order
+ */
+class csClient
+{
+public:
+    typedef wxSharedPtr<csClient> Ptr_t;
+
+public:
+    csClient() {}
+    virtual ~csClient() {}
+
+    /**
+     * @brief write a reply to the client. Called from the worker threads
+     */
+    virtual void Write(const wxString& reply) = 0;
+};
+
+/**
+ * @brief a client reading the requests from the stdin, the replies are printed to the stdout
+ */
+class csStdoutClient : public csClient
+{
+public:
+    csStdoutClient() {}
+    virtual ~csStdoutClient() {}
+    void Write(const wxString& reply);
+};
+
+/**
+ * @brief a client connected to the server socket. A reply is followed by a new line
+ */
+class csSocketClient : public csClient
+{
+    clSocketBase::Ptr_t m_socket;
+    wxMutex m_mutex;
+    bool m_closed;
+
+public:
+    csSocketClient(clSocketBase::Ptr_t socket);
+    virtual ~csSocketClient();
+    void Write(const wxString& reply);
+
+    clSocketBase::Ptr_t GetSocket() const { return m_socket; }
+
+    /**
+     * @brief the connection was closed, the replies that are still to come are dropped
+     */
+    void Close();
+};
+
+/**
+ * @brief a client for the requests made by the server itself (e.g. re-parsing a modified file): the replies are
+ * dropped
+ */
+class csNullClient : public csClient
+{
+public:
+    csNullClient() {}
+    virtual ~csNullClient() {}
+    void Write(const wxString& reply) { wxUnusedVar(reply); }
+};
+
+#endif // CSCLIENT_H
@@ -21,5 +21,7 @@ void csCodeCompleteHandler::DoProcessCommand(const JSONItem& options)
         clERROR() << "I have no handler for:" << handlerName;
         return;
     }
+    handler->SetClient(m_client);
     handler->DoProcessCommand(options);
+    handler->SetClient(csClient::Ptr_t(nullptr));
 }
@@ -19,17 +19,18 @@ void csCodeCompletePhpHandler::DoProcessCommand(const JSONItem& options)
     CHECK_STR_PARAM("symbols-path", m_symbolsPath);
 
     // Guess the symbols db path
-    PHPLookupTable lookup;
     if(wxFileName::DirExists(m_symbolsPath)) {
         // the provided path is the folder, build the symbols path
         m_symbolsPath << wxFileName::GetPathSeparator() << ".codelite" << wxFileName::GetPathSeparator()
                       << "phpsymbols.db";
     }
     clDEBUG() << "Using symbols db:" << m_symbolsPath;
-    lookup.Open(wxFileName(m_symbolsPath));
-    if(!lookup.IsOpened()) {
+    wxMutexLocker locker(m_manager->GetPHPLookupTableMutex(wxFileName(m_symbolsPath)));
+    PHPLookupTable* pLookup = m_manager->GetPHPLookupTable(wxFileName(m_symbolsPath));
+    if(!pLookup) {
         return;
     }
+    PHPLookupTable& lookup = *pLookup;
 
     PHPSourceFile sourceFile(wxFileName(m_unsavedBufferPath.IsEmpty() ? m_path : m_unsavedBufferPath), &lookup);
     sourceFile.SetFilename(m_path); // update the file name to the real path
@@ -46,10 +47,10 @@ void csCodeCompletePhpHandler::DoProcessCommand(const JSONItem& options)
         JSONItem arr = root.toElement();
         std::for_each(matches.begin(), matches.end(), [&](PHPEntityBase::Ptr_t e) { arr.arrayAppend(e->ToJSON()); });
         char* result = arr.FormatRawString(m_manager->GetConfig().IsPrettyJSON());
-        std::cout << result << std::endl;
+        Reply(wxString(result, wxConvUTF8));
         free(result);
 
     } else {
-        std::cout << "[]" << std::endl;
+        Reply("[]");
     }
 }
@@ -10,17 +10,20 @@ csCommandHandlerBase::csCommandHandlerBase(csManager* manager)
 
 csCommandHandlerBase::~csCommandHandlerBase() {}
 
-void csCommandHandlerBase::NotifyCompletion()
-{
-    clCommandEvent e(wxEVT_COMMAND_PROCESSED);
-    m_manager->AddPendingEvent(e);
-}
+void csCommandHandlerBase::NotifyCompletion() { m_manager->OnRequestCompleted(m_client.get()); }
 
-void csCommandHandlerBase::Process(const JSONItem& options)
+void csCommandHandlerBase::Process(const JSONItem& options, csClient::Ptr_t client)
 {
+    m_client = client;
+
+    // Handlers are re-used between requests when running as a server, so reset
+    // the flag that a previous request might have cleared
+    m_notifyOnExit = true;
     DoProcessCommand(options);
     if(m_notifyOnExit) {
         // Make sure we call 'NotifyCompletion' here if needed
         NotifyCompletion();
     }
+    // Don't keep the client (and its connection) alive until the next request
+    m_client.reset();
 }
@@ -1,6 +1,7 @@
 #ifndef CSCOMMANDHANDLERBASE_H
 #define CSCOMMANDHANDLERBASE_H
 
+#include "csClient.h"
 #include "file_logger.h"
 #include "JSON.h"
 #include <cl_command_event.h>
@@ -14,7 +15,6 @@ wxDECLARE_EVENT(wxEVT_COMMAND_PROCESSED, clCommandEvent);
 #define CHECK_STR_PARAM(str_option, sVal)                       \
     if(!options.hasNamedObject(str_option)) {                   \
         clERROR() << "Command is missing field:" << str_option; \
-        NotifyCompletion();                                     \
         return;                                                 \
     }                                                           \
     sVal = options.namedObject(str_option).toString();
@@ -22,7 +22,6 @@ wxDECLARE_EVENT(wxEVT_COMMAND_PROCESSED, clCommandEvent);
 #define CHECK_INT_PARAM(str_option, iVal)                       \
     if(!options.hasNamedObject(str_option)) {                   \
         clERROR() << "Command is missing field:" << str_option; \
-        NotifyCompletion();                                     \
         return;                                                 \
     }                                                           \
     iVal = options.namedObject(str_option).toInt();
@@ -30,7 +29,6 @@ wxDECLARE_EVENT(wxEVT_COMMAND_PROCESSED, clCommandEvent);
 #define CHECK_BOOL_PARAM(str_option, bVal)                      \
     if(!options.hasNamedObject(str_option)) {                   \
         clERROR() << "Command is missing field:" << str_option; \
-        NotifyCompletion();                                     \
         return;                                                 \
     }                                                           \
     bVal = options.namedObject(str_option).toBool();
@@ -38,7 +36,6 @@ wxDECLARE_EVENT(wxEVT_COMMAND_PROCESSED, clCommandEvent);
 #define CHECK_ARRSTR_PARAM(str_option, arrVal)                  \
     if(!options.hasNamedObject(str_option)) {                   \
         clERROR() << "Command is missing field:" << str_option; \
-        NotifyCompletion();                                     \
         return;                                                 \
     }                                                           \
     arrVal = options.namedObject(str_option).toArrayString();
@@ -60,6 +57,7 @@ class csCommandHandlerBase
 protected:
     csManager* m_manager;
     bool m_notifyOnExit;
+    csClient::Ptr_t m_client;
 
 public:
     typedef wxSharedPtr<csCommandHandlerBase> Ptr_t;
@@ -68,13 +66,23 @@ protected:
     void NotifyCompletion();
     void SetNotifyCompletion(bool b) { m_notifyOnExit = b; }
 
+    /**
+     * @brief write the reply to the client of the request
+     */
+    void Reply(const wxString& reply) { m_client->Write(reply); }
+
 public:
     /**
-     * @brief process a request from the command line and print the result to the stdout
+     * @brief process a request and write the result to the client. A handler is used by a single thread at a time
      * @param the handler options
      */
     virtual void DoProcessCommand(const JSONItem& options) = 0;
 
+    /**
+     * @brief set the client of the request. Used by the handlers that pass a request to another handler
+     */
+    void SetClient(csClient::Ptr_t client) { m_client = client; }
+
 public:
     csCommandHandlerBase(csManager* manager);
     virtual ~csCommandHandlerBase();
@@ -82,10 +90,10 @@ public:
     csManager* GetSink() { return m_manager; }
 
     /**
-     * @brief process a request from the command line and print the result to the stdout
+     * @brief process a request of 'client' and write the result to it
      * @param the handler options
      */
-    void Process(const JSONItem& options);
+    void Process(const JSONItem& options, csClient::Ptr_t client);
 };
 
 #endif // CSCOMMANDHANDLERBASE_H
@@ -0,0 +1,49 @@
+#include "csConnectionThread.h"
+#include "csRequestDispatcher.h"
+#include "file_logger.h"
+#include <string>
+
+csConnectionThread::csConnectionThread(wxEvtHandler* manager, csRequestDispatcher* dispatcher,
+                                       clSocketBase::Ptr_t socket)
+    : csJoinableThread(manager)
+    , m_socketClient(new csSocketClient(socket))
+    , m_client(m_socketClient)
+    , m_dispatcher(dispatcher)
+{
+}
+
+csConnectionThread::~csConnectionThread() {}
+
+void* csConnectionThread::Entry()
+{
+    clDEBUG() << "Connection thread started";
+    std::string buffer;
+    char chunk[4096];
+    try {
+        while(!TestDestroy()) {
+            size_t bytesRead = 0;
+            if(m_socketClient->GetSocket()->Read(chunk, sizeof(chunk), bytesRead, 1) != clSocketBase::kSuccess) {
+                continue;
+            }
+            buffer.append(chunk, bytesRead);
+
+            // A request is a line. The lines are split before they are converted: a chunk may end in the middle of
+            // a multi byte character
+            size_t start = 0;
+            size_t end = buffer.find('\n');
+            while(end != std::string::npos) {
+                size_t len = end - start;
+                if(len && buffer[end - 1] == '\r') { --len; }
+                if(len) { m_dispatcher->Queue(m_client, wxString(buffer.c_str() + start, wxConvUTF8, len)); }
+                start = end + 1;
+                end = buffer.find('\n', start);
+            }
+            buffer.erase(0, start);
+        }
+    } catch(clSocketException& e) {
+        clDEBUG() << "Connection closed:" << e.what();
+    }
+    m_socketClient->Close();
+    NotifyGoingDown();
+    return NULL;
+}
@@ -0,0 +1,29 @@
+#ifndef CSCONNECTIONTHREAD_H
+#define CSCONNECTIONTHREAD_H
+
+#include "csClient.h"
+#include "csJoinableThread.h"
+
+class csRequestDispatcher;
+
+/**
+ * @class csConnectionThread
+ * @brief read the requests of a client connected to the server socket, one JSON object per line, and queue them
+ * in the dispatcher. Notifies the manager with wxEVT_THREAD_GOING_DOWN once the connection is closed
+ */
+class csConnectionThread : public csJoinableThread
+{
+protected:
+    csSocketClient* m_socketClient;
+    csClient::Ptr_t m_client; // owns m_socketClient
+    csRequestDispatcher* m_dispatcher;
+
+protected:
+    void* Entry();
+
+public:
+    csConnectionThread(wxEvtHandler* manager, csRequestDispatcher* dispatcher, clSocketBase::Ptr_t socket);
+    virtual ~csConnectionThread();
+};
+
+#endif // CSCONNECTIONTHREAD_H
@@ -0,0 +1,84 @@
+#include "clFilesCollector.h"
+#include "csFileIndex.h"
+#include "file_logger.h"
+#include <wx/filename.h>
+
+csFileIndex::csFileIndex() {}
+
+csFileIndex::~csFileIndex() {}
+
+bool csFileIndex::IsIndexed(const wxString& folder)
+{
+    wxFileName fn(folder, "");
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_folders.count(fn.GetPath()) > 0;
+}
+
+bool csFileIndex::GetFiles(const wxString& folder, wxArrayString& files)
+{
+    wxFileName fn(folder, "");
+    wxString path = fn.GetPath();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::map<wxString, std::set<wxString> >::iterator iter = m_folders.find(path);
+        if(iter != m_folders.end()) {
+            files.Alloc(iter->second.size());
+            for(std::set<wxString>::const_iterator file = iter->second.begin(); file != iter->second.end(); ++file) {
+                files.Add(*file);
+            }
+            return true;
+        }
+    }
+
+    // Scan the folder without holding the lock, other requests may use the index meanwhile
+    clFilesScanner scanner;
+    std::vector<wxString> scanned;
+    scanner.Scan(path, scanned, "*");
+    clDEBUG() << "Indexed folder" << path << ":" << scanned.size() << "files";
+
+    std::set<wxString> folderFiles(scanned.begin(), scanned.end());
+    files.Alloc(folderFiles.size());
+    for(std::set<wxString>::const_iterator file = folderFiles.begin(); file != folderFiles.end(); ++file) {
+        files.Add(*file);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_folders[path].swap(folderFiles);
+    return false;
+}
+
+void csFileIndex::AddFile(const wxString& file)
+{
+    // Nested folders are indexed separately: update every indexed folder containing the file
+    std::lock_guard<std::mutex> lock(m_mutex);
+    wxFileName fn(file);
+    while(fn.GetDirCount()) {
+        std::map<wxString, std::set<wxString> >::iterator iter = m_folders.find(fn.GetPath());
+        if(iter != m_folders.end()) { iter->second.insert(file); }
+        fn.RemoveLastDir();
+    }
+}
+
+void csFileIndex::RemoveFile(const wxString& file)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    wxFileName fn(file);
+    while(fn.GetDirCount()) {
+        std::map<wxString, std::set<wxString> >::iterator iter = m_folders.find(fn.GetPath());
+        if(iter != m_folders.end()) { iter->second.erase(file); }
+        fn.RemoveLastDir();
+    }
+}
+
+void csFileIndex::RemoveFolder(const wxString& folder)
+{
+    wxString prefix = wxFileName(folder, "").GetPath(wxPATH_GET_SEPARATOR);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for(std::map<wxString, std::set<wxString> >::iterator iter = m_folders.begin(); iter != m_folders.end(); ++iter) {
+        std::set<wxString>& files = iter->second;
+        std::set<wxString>::iterator file = files.lower_bound(prefix);
+        while(file != files.end() && file->StartsWith(prefix)) {
+            file = files.erase(file);
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef CSFILEINDEX_H
+#define CSFILEINDEX_H
+
+#include <map>
+#include <mutex>
+#include <set>
+#include <wx/arrstr.h>
+#include <wx/string.h>
+#include <wxStringHash.h>
+
+/**
+ * @class csFileIndex
+ * @brief the files found under the folders the clients work on. A folder is scanned once, on the first request
+ * that needs it, and then kept current with the file system notifications (see AddFile() / RemoveFile()) instead
+ * of being scanned again for every request. Thread safe
+ */
+class csFileIndex
+{
+    std::mutex m_mutex;
+    std::map<wxString, std::set<wxString> > m_folders; // folder -> files under it
+
+public:
+    csFileIndex();
+    virtual ~csFileIndex();
+
+    /**
+     * @brief return the files under 'folder' in 'files'. The folder is scanned if it is not indexed yet
+     * @return true if the folder was already indexed, false if it was scanned now
+     */
+    bool GetFiles(const wxString& folder, wxArrayString& files);
+
+    /**
+     * @brief is 'folder' indexed?
+     */
+    bool IsIndexed(const wxString& folder);
+
+    /**
+     * @brief a file was created (or renamed to 'file')
+     */
+    void AddFile(const wxString& file);
+
+    /**
+     * @brief a file was deleted (or renamed from 'file')
+     */
+    void RemoveFile(const wxString& file);
+
+    /**
+     * @brief a folder was deleted: remove the files under it
+     */
+    void RemoveFolder(const wxString& folder);
+};
+
+#endif // CSFILEINDEX_H
@@ -32,14 +32,18 @@ void csFindInFilesCommandHandler::DoProcessCommand(const JSONItem& options)
     // has completed the search. We will do it ourself when the search thread complete its task
     SetNotifyCompletion(false);
 
+    // Search the files of the index rather than scanning the folder: the index is kept current with the file system
+    // notifications. The search thread filters the files with the mask
+    wxArrayString files;
+    m_manager->GetFileIndex().GetFiles(m_folder, files);
+    m_manager->WatchFolder(m_folder);
+
     SearchData* req = new SearchData();
     req->SetExtensions(m_mask);
     req->SetFindString(m_what);
     req->SetMatchCase(m_case);
     req->SetMatchWholeWord(m_word);
-    wxArrayString folders;
-    folders.Add(m_folder);
-    req->SetRootDirs(folders);
+    req->SetFiles(files);
     req->SetOwner(GetSink());
-    SearchThreadST::Get()->Add(req);
+    m_manager->QueueFindInFiles(m_client, req);
 }
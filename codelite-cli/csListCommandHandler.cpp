@@ -1,7 +1,6 @@
 #include "csListCommandHandler.h"
 #include "JSON.h"
 #include <file_logger.h>
-#include <iostream>
 #include <wx/dir.h>
 #include "csManager.h"
 
@@ -34,6 +33,6 @@ void csListCommandHandler::DoProcessCommand(const JSONItem& options)
     }
     char* result = arr.FormatRawString(m_manager->GetConfig().IsPrettyJSON());
     clDEBUG() << result;
-    std::cout << result << std::endl;
+    Reply(wxString(result, wxConvUTF8));
     free(result);
 }
@@ -1,24 +1,41 @@
 #include "csCodeCompleteHandler.h"
+#include "csConnectionThread.h"
 #include "csFindInFilesCommandHandler.h"
 #include "csListCommandHandler.h"
 #include "csManager.h"
 #include "csNetworkThread.h"
 #include "csParseFolderHandler.h"
+#include "clFilesCollector.h"
+#include "clPerfTrace.h"
 #include "file_logger.h"
+#include "fileutils.h"
 #include "JSON.h"
+#include "PHPLookupTable.h"
 #include "search_thread.h"
 #include <algorithm>
 #include <iostream>
+#include <string>
+#include <thread>
 #include <wx/app.h>
 
+// Default number of worker threads when serving
+#define CS_DEFAULT_THREADS 4
+
 csManager::csManager()
     : m_startupCalled(false)
     , m_exitNow(false)
+    , m_runningCommandStart(0)
+    , m_serveMode(false)
+    , m_inputClosed(false)
+    , m_dispatcher(this)
+    , m_stdoutClient(new csStdoutClient())
+    , m_nullClient(new csNullClient())
+    , m_networkThread(nullptr)
+#if wxUSE_FSWATCHER
+    , m_watcher(nullptr)
+#endif
 {
-    m_handlers.Register("list", csCommandHandlerBase::Ptr_t(new csListCommandHandler(this)));
-    m_handlers.Register("find", csCommandHandlerBase::Ptr_t(new csFindInFilesCommandHandler(this)));
-    m_handlers.Register("parse", csCommandHandlerBase::Ptr_t(new csParseFolderHandler(this)));
-    m_handlers.Register("code-complete", csCommandHandlerBase::Ptr_t(new csCodeCompleteHandler(this)));
+    RegisterHandlers(m_handlers);
 
     SearchThreadST::Get()->Start();
     SearchThreadST::Get()->SetNotifyWindow(this);
@@ -27,18 +44,40 @@ csManager::csManager()
 
 csManager::~csManager()
 {
+    // Stop the threads that may still use the manager
+    if(m_networkThread) { wxDELETE(m_networkThread); }
+    for(size_t i = 0; i < m_connections.size(); ++i) {
+        delete m_connections[i];
+    }
+    m_connections.clear();
+    m_dispatcher.Stop();
+
     // First unbind all the events
     if(m_startupCalled) {
         Unbind(wxEVT_COMMAND_PROCESSED, &csManager::OnCommandProcessedCompleted, this);
+        Unbind(wxEVT_SOCKET_CONNECTION_READY, &csManager::OnConnectionReady, this);
+        Unbind(wxEVT_SOCKET_SERVER_ERROR, &csManager::OnServerError, this);
+        Unbind(wxEVT_THREAD_GOING_DOWN, &csManager::OnThreadGoingDown, this);
         // Search thread events
         Unbind(wxEVT_SEARCH_THREAD_MATCHFOUND, &csManager::OnSearchThreadMatch, this);
         Unbind(wxEVT_SEARCH_THREAD_SEARCHSTARTED, &csManager::OnSearchThreadStarted, this);
         Unbind(wxEVT_SEARCH_THREAD_SEARCHCANCELED, &csManager::OnSearchThreadCancelled, this);
         Unbind(wxEVT_SEARCH_THREAD_SEARCHEND, &csManager::OnSearchThreadEneded, this);
     }
+#if wxUSE_FSWATCHER
+    wxDELETE(m_watcher);
+#endif
     SearchThreadST::Get()->Stop();
 }
 
+void csManager::RegisterHandlers(csCommandHandlerManager& handlers)
+{
+    handlers.Register("list", csCommandHandlerBase::Ptr_t(new csListCommandHandler(this)));
+    handlers.Register("find", csCommandHandlerBase::Ptr_t(new csFindInFilesCommandHandler(this)));
+    handlers.Register("parse", csCommandHandlerBase::Ptr_t(new csParseFolderHandler(this)));
+    handlers.Register("code-complete", csCommandHandlerBase::Ptr_t(new csCodeCompleteHandler(this)));
+}
+
 bool csManager::Startup()
 {
     if(m_exitNow) {
@@ -47,6 +86,9 @@ bool csManager::Startup()
     }
 
     Bind(wxEVT_COMMAND_PROCESSED, &csManager::OnCommandProcessedCompleted, this);
+    Bind(wxEVT_SOCKET_CONNECTION_READY, &csManager::OnConnectionReady, this);
+    Bind(wxEVT_SOCKET_SERVER_ERROR, &csManager::OnServerError, this);
+    Bind(wxEVT_THREAD_GOING_DOWN, &csManager::OnThreadGoingDown, this);
     // Search thread events
     Bind(wxEVT_SEARCH_THREAD_MATCHFOUND, &csManager::OnSearchThreadMatch, this);
     Bind(wxEVT_SEARCH_THREAD_SEARCHSTARTED, &csManager::OnSearchThreadStarted, this);
@@ -55,27 +97,280 @@ bool csManager::Startup()
 
     m_startupCalled = true;
 
-    clDEBUG() << "Command:" << GetCommand();
-    clDEBUG() << "Options:" << GetOptions();
+    if(m_command == "serve") {
+        DoStartServing();
+        return true;
+    }
+    return DoProcessCommand(m_command, m_options);
+}
+
+bool csManager::DoProcessCommand(const wxString& command, const wxString& options)
+{
+    clDEBUG() << "Command:" << command;
+    clDEBUG() << "Options:" << options;
 
     // Make sure we know how to handle this command
-    csCommandHandlerBase::Ptr_t handler = m_handlers.FindHandler(m_command);
+    csCommandHandlerBase::Ptr_t handler = m_handlers.FindHandler(command);
     if(handler == nullptr) {
-        clERROR() << "Don't know how to handle command:" << m_command;
+        clERROR() << "Don't know how to handle command:" << command;
         return false;
     }
 
+    m_runningCommand = command;
+    m_runningCommandStart = clPerfTrace::Now();
+
+    JSON root(options);
+    JSONItem optionsItem = root.toElement();
+    handler->Process(optionsItem, m_stdoutClient);
+    return true;
+}
+
+void csManager::DoStartServing()
+{
+    m_serveMode = true;
+
+    // The serve options: { "listen": "<connection string>", "threads": <number of worker threads> }
     JSON root(m_options);
     JSONItem options = root.toElement();
-    handler->Process(options);
-    return true;
+    wxString connectionString;
+    int threads = CS_DEFAULT_THREADS;
+    if(options.isOk()) {
+        if(options.hasNamedObject("listen")) { connectionString = options.namedObject("listen").toString(); }
+        if(options.hasNamedObject("threads")) { threads = std::max(1, options.namedObject("threads").toInt()); }
+    }
+    m_dispatcher.Start(threads);
+
+    if(!connectionString.IsEmpty()) {
+        // Serve the clients connecting to the socket until we are killed
+        clDEBUG() << "Serving requests on" << connectionString;
+        m_networkThread = new csNetworkThread(this, connectionString);
+        m_networkThread->Start();
+        return;
+    }
+
+    clDEBUG() << "Serving requests from stdin";
+    // Read the requests on a background thread, the dispatcher processes them
+    std::thread thr([=]() {
+        std::string line;
+        while(std::getline(std::cin, line)) {
+            if(line.empty()) { continue; }
+            CallAfter(&csManager::OnRequestReceived, wxString(line.c_str(), wxConvUTF8));
+        }
+        CallAfter(&csManager::OnInputClosed);
+    });
+    thr.detach();
+}
+
+void csManager::OnRequestReceived(const wxString& request) { m_dispatcher.Queue(m_stdoutClient, request); }
+
+void csManager::OnInputClosed()
+{
+    clDEBUG() << "Input closed";
+    m_inputClosed = true;
+    DoExitIfDone();
+}
+
+void csManager::DoExitIfDone()
+{
+    // When reading from the stdin, exit once all the requests were answered
+    if(m_inputClosed && m_dispatcher.IsIdle()) { wxExit(); }
+}
+
+void csManager::OnRequestCompleted(csClient* client)
+{
+    m_dispatcher.Completed(client);
+    clCommandEvent completedEvent(wxEVT_COMMAND_PROCESSED);
+    AddPendingEvent(completedEvent);
+}
+
+void csManager::OnCommandProcessedCompleted(clCommandEvent& event)
+{
+    if(!m_serveMode) {
+        if(clPerfTrace::Get().IsEnabled()) {
+            clPerfTrace::Get().AddSpan("cli", m_runningCommand, m_runningCommandStart,
+                                       clPerfTrace::Now() - m_runningCommandStart);
+        }
+        wxExit();
+        return;
+    }
+    DoExitIfDone();
+}
+
+void csManager::OnConnectionReady(clCommandEvent& event)
+{
+    clSocketBase::Ptr_t socket(reinterpret_cast<clSocketBase*>(event.GetClientData()));
+    csConnectionThread* thread = new csConnectionThread(this, &m_dispatcher, socket);
+    m_connections.push_back(thread);
+    thread->Start();
+}
+
+void csManager::OnServerError(clCommandEvent& event)
+{
+    clERROR() << "Could not start the server, exiting";
+    wxExit();
+}
+
+void csManager::OnThreadGoingDown(clCommandEvent& event)
+{
+    csConnectionThread* thread = reinterpret_cast<csConnectionThread*>(event.GetClientData());
+    std::vector<csConnectionThread*>::iterator iter = std::find(m_connections.begin(), m_connections.end(), thread);
+    if(iter == m_connections.end()) { return; }
+    m_connections.erase(iter);
+    // The thread is done, this only joins it
+    delete thread;
 }
 
-void csManager::OnCommandProcessedCompleted(clCommandEvent& event) { wxExit(); }
+PHPLookupTable* csManager::GetPHPLookupTable(const wxFileName& dbpath)
+{
+    wxString key = dbpath.GetFullPath();
+    wxMutexLocker locker(m_phpLookupTablesMutex);
+    PHPLookupTableEntry& entry = m_phpLookupTables[key];
+    if(!entry.mutex) { entry.mutex.reset(new wxMutex()); }
+    if(!entry.table) {
+        wxSharedPtr<PHPLookupTable> lookup(new PHPLookupTable());
+        lookup->Open(dbpath);
+        if(!lookup->IsOpened()) { return nullptr; }
+        entry.table = lookup;
+    }
+    return entry.table.get();
+}
+
+wxMutex& csManager::GetPHPLookupTableMutex(const wxFileName& dbpath)
+{
+    wxString key = dbpath.GetFullPath();
+    wxMutexLocker locker(m_phpLookupTablesMutex);
+    PHPLookupTableEntry& entry = m_phpLookupTables[key];
+    if(!entry.mutex) { entry.mutex.reset(new wxMutex()); }
+    return *entry.mutex;
+}
+
+void csManager::WatchFolder(const wxString& folder)
+{
+    if(!m_serveMode) { return; }
+    CallAfter(&csManager::DoWatchFolder, folder);
+}
+
+void csManager::WatchPHPFolder(const wxString& folder, const wxString& mask, const wxFileName& dbpath)
+{
+    if(!m_serveMode) { return; }
+    {
+        std::lock_guard<std::mutex> lock(m_phpFoldersMutex);
+        PHPFolder& phpFolder = m_phpFolders[wxFileName(folder, "").GetPath()];
+        phpFolder.mask = mask;
+        phpFolder.dbpath = dbpath.GetFullPath();
+    }
+    CallAfter(&csManager::DoWatchFolder, folder);
+}
+
+void csManager::DoWatchFolder(const wxString& folder)
+{
+    wxString path = wxFileName(folder, "").GetPath();
+    if(m_watchedFolders.count(path)) { return; }
+    m_watchedFolders.insert(path);
+
+#if wxUSE_FSWATCHER
+    // The watcher must be created once the event loop is running
+    if(!m_watcher) {
+        m_watcher = new wxFileSystemWatcher();
+        m_watcher->SetOwner(this);
+        Bind(wxEVT_FSW, &csManager::OnFileSystemEvent, this);
+    }
+    clDEBUG() << "Watching folder" << path;
+    m_watcher->AddTree(wxFileName::DirName(path));
+#else
+    clWARNING() << "File system notifications are not supported, folder" << path << "will not be updated";
+#endif
+}
+
+#if wxUSE_FSWATCHER
+void csManager::OnFileSystemEvent(wxFileSystemWatcherEvent& event)
+{
+    wxString path = event.GetPath().GetFullPath();
+    switch(event.GetChangeType()) {
+    case wxFSW_EVENT_CREATE:
+        if(wxFileName::DirExists(path)) {
+            // A new folder: index the files it already contains
+            clFilesScanner scanner;
+            std::vector<wxString> files;
+            scanner.Scan(path, files, "*");
+            for(size_t i = 0; i < files.size(); ++i) {
+                m_fileIndex.AddFile(files[i]);
+                DoFileChanged(files[i]);
+            }
+        } else {
+            m_fileIndex.AddFile(path);
+            DoFileChanged(path);
+        }
+        break;
+    case wxFSW_EVENT_DELETE:
+        m_fileIndex.RemoveFile(path);
+        m_fileIndex.RemoveFolder(path);
+        DoFileChanged(path);
+        break;
+    case wxFSW_EVENT_RENAME: {
+        wxString newPath = event.GetNewPath().GetFullPath();
+        m_fileIndex.RemoveFile(path);
+        m_fileIndex.RemoveFolder(path);
+        if(wxFileName::FileExists(newPath)) { m_fileIndex.AddFile(newPath); }
+        DoFileChanged(path);
+        DoFileChanged(newPath);
+    } break;
+    case wxFSW_EVENT_MODIFY:
+        DoFileChanged(path);
+        break;
+    case wxFSW_EVENT_WARNING:
+        // Events were lost (e.g. the kernel queue overflowed): the index of the watched folders may be stale
+        clWARNING() << "File system watcher:" << event.GetErrorDescription();
+        break;
+    default:
+        break;
+    }
+}
+#endif
+
+void csManager::DoFileChanged(const wxString& path)
+{
+    // Re-parse the file into the PHP symbols databases of the folders containing it. The parse handler removes the
+    // symbols of a file that no longer exists
+    std::vector<PHPFolder> folders;
+    {
+        std::lock_guard<std::mutex> lock(m_phpFoldersMutex);
+        for(std::map<wxString, PHPFolder>::const_iterator iter = m_phpFolders.begin(); iter != m_phpFolders.end();
+            ++iter) {
+            if(path.StartsWith(iter->first + wxFileName::GetPathSeparator()) &&
+               FileUtils::WildMatch(iter->second.mask, path)) {
+                folders.push_back(iter->second);
+            }
+        }
+    }
+
+    for(size_t i = 0; i < folders.size(); ++i) {
+        JSON root(cJSON_Object);
+        JSONItem request = root.toElement();
+        request.addProperty("command", wxString("parse"));
+        JSONItem options = JSONItem::createObject("options");
+        options.addProperty("lang", wxString("php"));
+        options.addProperty("path", path);
+        options.addProperty("symbols-path", folders[i].dbpath);
+        request.append(options);
+        clDEBUG() << "Re-parsing" << path << "into" << folders[i].dbpath;
+        m_dispatcher.Queue(m_nullClient, request.format(false));
+    }
+}
+
+void csManager::QueueFindInFiles(csClient::Ptr_t client, SearchData* req)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_findClientsMutex);
+        m_findClients.push_back(client);
+    }
+    SearchThreadST::Get()->Add(req);
+}
 
 void csManager::OnSearchThreadMatch(wxCommandEvent& event)
 {
     SearchResultList* res = reinterpret_cast<SearchResultList*>(event.GetClientData());
+    if(!m_findInFilesMatches) { m_findInFilesMatches.reset(new JSON(cJSON_Array)); }
     SearchResultList::iterator iter = res->begin();
     JSONItem arr = m_findInFilesMatches->toElement();
     while(iter != res->end()) {
@@ -96,13 +391,26 @@ void csManager::OnSearchThreadCancelled(wxCommandEvent& event) { OnSearchThreadE
 void csManager::OnSearchThreadEneded(wxCommandEvent& event)
 {
     SearchSummary* summary = reinterpret_cast<SearchSummary*>(event.GetClientData());
+    if(!m_findInFilesMatches) { m_findInFilesMatches.reset(new JSON(cJSON_Array)); }
     m_findInFilesMatches->toElement().arrayAppend(summary->ToJSON());
     wxDELETE(summary);
     wxString output = m_findInFilesMatches->toElement().format(GetConfig().IsPrettyJSON());
-    std::cout << output << std::endl;
+    m_findInFilesMatches.reset(nullptr);
     clDEBUG1() << output;
     clDEBUG() << "Search completed";
-    wxExit();
+
+    // The search thread processes the requests in order: this is the reply to the oldest queued request
+    csClient::Ptr_t client;
+    {
+        std::lock_guard<std::mutex> lock(m_findClientsMutex);
+        if(m_findClients.empty()) { return; }
+        client = m_findClients.front();
+        m_findClients.pop_front();
+    }
+    client->Write(output);
+
+    // The find handler does not notify about its completion, we do it here
+    OnRequestCompleted(client.get());
 }
 
 void csManager::LoadCommandFromINI()
@@ -2,12 +2,31 @@
 #define CSMANAGER_H
 
 #include "codelite_events.h"
+#include "csClient.h"
 #include "csCommandHandlerManager.h"
 #include "csConfig.h"
+#include "csFileIndex.h"
+#include "csRequestDispatcher.h"
 #include "file_logger.h"
 #include <cl_command_event.h>
+#include <deque>
+#include <map>
+#include <mutex>
 #include <unordered_set>
+#include <vector>
 #include <wx/event.h>
+#include <wx/filename.h>
+#include <wx/thread.h>
+#include <wxStringHash.h>
+
+#if wxUSE_FSWATCHER
+#include <wx/fswatcher.h>
+#endif
+
+class PHPLookupTable;
+class SearchData;
+class csConnectionThread;
+class csNetworkThread;
 
 class csManager : public wxEvtHandler
 {
@@ -20,6 +39,48 @@ class csManager : public wxEvtHandler
     wxSharedPtr<JSON> m_findInFilesMatches;
     bool m_exitNow;
 
+    // The command being processed and its start time, used for the performance trace. When serving, the dispatcher
+    // traces the requests
+    wxString m_runningCommand;
+    long long m_runningCommandStart;
+
+    // "serve" mode: requests are read from the stdin (one JSON object per line) or from the clients connected to the
+    // server socket, and processed by the dispatcher
+    bool m_serveMode;
+    bool m_inputClosed;
+    csRequestDispatcher m_dispatcher;
+    csClient::Ptr_t m_stdoutClient;
+    csClient::Ptr_t m_nullClient; // the requests made by the server itself
+    csNetworkThread* m_networkThread;
+    std::vector<csConnectionThread*> m_connections;
+
+    // The clients of the queued find in files requests. The search thread processes them in order
+    std::mutex m_findClientsMutex;
+    std::deque<csClient::Ptr_t> m_findClients;
+
+    // The files of the folders the requests work on, kept current with the file system notifications
+    csFileIndex m_fileIndex;
+#if wxUSE_FSWATCHER
+    wxFileSystemWatcher* m_watcher;
+#endif
+    std::unordered_set<wxString> m_watchedFolders;
+
+    // The folders parsed into a PHP symbols database: their files are re-parsed when they change
+    struct PHPFolder {
+        wxString mask;
+        wxString dbpath;
+    };
+    std::mutex m_phpFoldersMutex;
+    std::map<wxString, PHPFolder> m_phpFolders;
+
+    // The symbols databases are kept open between requests. A database is used by one request at a time
+    struct PHPLookupTableEntry {
+        wxSharedPtr<PHPLookupTable> table;
+        wxSharedPtr<wxMutex> mutex;
+    };
+    wxMutex m_phpLookupTablesMutex;
+    std::unordered_map<wxString, PHPLookupTableEntry> m_phpLookupTables;
+
 public:
     csManager();
     virtual ~csManager();
@@ -32,13 +93,72 @@ public:
     const csConfig& GetConfig() const { return m_config; }
     void LoadCommandFromINI();
     void SetExitNow(bool b) { m_exitNow = b; }
-    
+
+    /**
+     * @brief register the command handlers in 'handlers'. Every worker thread has its own handlers
+     */
+    void RegisterHandlers(csCommandHandlerManager& handlers);
+
+    /**
+     * @brief the running request of 'client' completed. Can be called from any thread
+     */
+    void OnRequestCompleted(csClient* client);
+
+    /**
+     * @brief return the PHP symbols database found at dbpath. The database is opened on the first call
+     * and remains open for the lifetime of the process. The caller must hold GetPHPLookupTableMutex(dbpath) while
+     * using the database
+     * @return the lookup table or nullptr if the database could not be opened
+     */
+    PHPLookupTable* GetPHPLookupTable(const wxFileName& dbpath);
+
+    /**
+     * @brief return the mutex guarding the PHP symbols database found at dbpath
+     */
+    wxMutex& GetPHPLookupTableMutex(const wxFileName& dbpath);
+
+    csFileIndex& GetFileIndex() { return m_fileIndex; }
+
+    /**
+     * @brief when serving, keep the file index of 'folder' current with the file system notifications. Can be called
+     * from any thread
+     */
+    void WatchFolder(const wxString& folder);
+
+    /**
+     * @brief when serving, re-parse the files of 'folder' matching 'mask' into the PHP symbols database 'dbpath' as
+     * they change. Can be called from any thread
+     */
+    void WatchPHPFolder(const wxString& folder, const wxString& mask, const wxFileName& dbpath);
+
+    /**
+     * @brief queue a find in files request, the matches are written to 'client' once the search completes. Can be
+     * called from any thread
+     */
+    void QueueFindInFiles(csClient::Ptr_t client, SearchData* req);
+
 protected:
     void OnExit();
-    
+    bool DoProcessCommand(const wxString& command, const wxString& options);
+    void DoStartServing();
+    void DoExitIfDone();
+    void DoWatchFolder(const wxString& folder);
+    void DoFileChanged(const wxString& path);
+    void OnRequestReceived(const wxString& request);
+    void OnInputClosed();
+
     // The handler completed
     void OnCommandProcessedCompleted(clCommandEvent& event);
 
+    // Network events
+    void OnConnectionReady(clCommandEvent& event);
+    void OnServerError(clCommandEvent& event);
+    void OnThreadGoingDown(clCommandEvent& event);
+
+#if wxUSE_FSWATCHER
+    void OnFileSystemEvent(wxFileSystemWatcherEvent& event);
+#endif
+
     // Search events
     void OnSearchThreadMatch(wxCommandEvent& event);
     void OnSearchThreadStarted(wxCommandEvent& event);
@@ -3,7 +3,6 @@
 
 #include "SocketAPI/clSocketBase.h"
 #include "cl_command_event.h"
-#include "csConfig.h"
 #include "csJoinableThread.h"
 
 wxDECLARE_EVENT(wxEVT_SOCKET_CONNECTION_READY, clCommandEvent);
@@ -15,13 +14,18 @@ public:
     typedef clSocketBase* clSocketBasePtr_t;
 
 protected:
-    const csConfig& m_config;
+    wxString m_connectionString;
 
 protected:
     void* Entry();
 
 public:
-    csNetworkThread(wxEvtHandler* manager, const csConfig& config);
+    /**
+     * @brief accept the connections on 'connectionString' (e.g. "tcp://127.0.0.1:5555" or
+     * "unix:///tmp/codelite-cli.sock"). Each connection is sent to the manager with wxEVT_SOCKET_CONNECTION_READY,
+     * the event client data is the clSocketBase* to take
+     */
+    csNetworkThread(wxEvtHandler* manager, const wxString& connectionString);
     virtual ~csNetworkThread();
 };
 
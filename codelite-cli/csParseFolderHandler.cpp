@@ -1,4 +1,5 @@
 #include "csParseFolderHandler.h"
+#include "csParsePHPFileHandler.h"
 #include "csParsePHPFolderHandler.h"
 #include <file_logger.h>
 
@@ -6,6 +7,7 @@ csParseFolderHandler::csParseFolderHandler(csManager* manager)
     : csCommandHandlerBase(manager)
 {
     m_parseHandlers.Register("parse-php-folder", csParsePHPFolderHandler::Ptr_t(new csParsePHPFolderHandler(manager)));
+    m_parseHandlers.Register("parse-php-file", csParsePHPFileHandler::Ptr_t(new csParsePHPFileHandler(manager)));
 }
 
 csParseFolderHandler::~csParseFolderHandler() {}
@@ -24,5 +26,7 @@ void csParseFolderHandler::DoProcessCommand(const JSONItem& options)
         return;
     }
     clDEBUG() << "Using handler:" << handlerName;
+    handler->SetClient(m_client);
     handler->DoProcessCommand(options);
+    handler->SetClient(csClient::Ptr_t(nullptr));
 }
@@ -0,0 +1,46 @@
+#include "PHPLookupTable.h"
+#include "PHPSourceFile.h"
+#include "csManager.h"
+#include "csParsePHPFileHandler.h"
+#include <wx/filename.h>
+
+csParsePHPFileHandler::csParsePHPFileHandler(csManager* manager)
+    : csCommandHandlerBase(manager)
+{
+}
+
+csParsePHPFileHandler::~csParsePHPFileHandler() {}
+
+void csParsePHPFileHandler::DoProcessCommand(const JSONItem& options)
+{
+    CHECK_STR_PARAM("path", m_file);
+    CHECK_STR_PARAM("symbols-path", m_dbpath);
+
+    wxFileName dbpath(m_dbpath);
+    if(wxFileName::DirExists(m_dbpath)) {
+        // the provided path is the folder, build the symbols path
+        dbpath = wxFileName(m_dbpath, "phpsymbols.db");
+        dbpath.AppendDir(".codelite");
+    }
+
+    clDEBUG() << "Using symbols db:" << dbpath;
+    wxMutexLocker locker(m_manager->GetPHPLookupTableMutex(dbpath));
+    PHPLookupTable* lookup = m_manager->GetPHPLookupTable(dbpath);
+    if(!lookup) {
+        clERROR() << "Could not open file:" << dbpath;
+        return;
+    }
+
+    wxFileName filename(m_file);
+    if(!filename.FileExists()) {
+        // The file was deleted, remove its symbols
+        lookup->DeleteFileEntries(filename);
+        return;
+    }
+
+    // Re-parse this file only and replace its symbols in the database
+    PHPSourceFile sourceFile(filename, lookup);
+    sourceFile.SetParseFunctionBody(true);
+    sourceFile.Parse();
+    lookup->UpdateSourceFile(sourceFile);
+}
@@ -0,0 +1,20 @@
+#ifndef CSPARSEPHPFILEHANDLER_H
+#define CSPARSEPHPFILEHANDLER_H
+
+#include "csCommandHandlerBase.h"
+#include <wx/string.h>
+
+class csParsePHPFileHandler : public csCommandHandlerBase
+{
+    wxString m_file;
+    wxString m_dbpath;
+
+protected:
+    virtual void DoProcessCommand(const JSONItem& options);
+
+public:
+    csParsePHPFileHandler(csManager* manager);
+    virtual ~csParsePHPFileHandler();
+};
+
+#endif // CSPARSEPHPFILEHANDLER_H
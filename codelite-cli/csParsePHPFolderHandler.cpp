@@ -1,4 +1,5 @@
 #include "PHPLookupTable.h"
+#include "csManager.h"
 #include "csParsePHPFolderHandler.h"
 #include <wx/filename.h>
 
@@ -15,7 +16,6 @@ void csParsePHPFolderHandler::DoProcessCommand(const JSONItem& options)
     CHECK_STR_PARAM("mask", m_mask);
     CHECK_STR_PARAM_OPTIONAL("symbols-path", m_dbpath);
 
-    PHPLookupTable lookup;
     // Build the default symbols db path
     wxFileName dbpath(m_folder, "phpsymbols.db");
     dbpath.AppendDir(".codelite");
@@ -29,11 +29,15 @@ void csParsePHPFolderHandler::DoProcessCommand(const JSONItem& options)
     }
     
     clDEBUG() << "Using symbols db:" << dbpath;
-    lookup.Open(dbpath);
-    if(!lookup.IsOpened()) {
+    wxMutexLocker locker(m_manager->GetPHPLookupTableMutex(dbpath));
+    PHPLookupTable* lookup = m_manager->GetPHPLookupTable(dbpath);
+    if(!lookup) {
         clERROR() << "Could not open file:" << dbpath;
         return;
     }
     // Clear any content before we start the parsing
-    lookup.ParseFolder(m_folder, m_mask, PHPLookupTable::kUpdateMode_Fast);
+    lookup->ParseFolder(m_folder, m_mask, PHPLookupTable::kUpdateMode_Fast);
+
+    // When serving, the files of the folder are re-parsed as they change
+    m_manager->WatchPHPFolder(m_folder, m_mask, dbpath);
 }
@@ -0,0 +1,132 @@
+#include "JSON.h"
+#include "clPerfTrace.h"
+#include "csCommandHandlerManager.h"
+#include "csManager.h"
+#include "csRequestDispatcher.h"
+#include "file_logger.h"
+
+csRequestDispatcher::csRequestDispatcher(csManager* manager)
+    : m_manager(manager)
+    , m_shutdown(false)
+{
+}
+
+csRequestDispatcher::~csRequestDispatcher() { Stop(); }
+
+void csRequestDispatcher::Start(size_t threads)
+{
+    Stop();
+    m_shutdown = false;
+    for(size_t i = 0; i < threads; ++i) {
+        m_threads.push_back(new std::thread(&csRequestDispatcher::DoWork, this));
+    }
+    clDEBUG() << "Request dispatcher started with" << threads << "threads";
+}
+
+void csRequestDispatcher::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shutdown = true;
+        m_ready.clear();
+        m_clients.clear();
+    }
+    m_cond.notify_all();
+    for(size_t i = 0; i < m_threads.size(); ++i) {
+        m_threads[i]->join();
+        delete m_threads[i];
+    }
+    m_threads.clear();
+}
+
+void csRequestDispatcher::Queue(csClient::Ptr_t client, const wxString& request)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ClientQueue& queue = m_clients[client.get()];
+        queue.client = client;
+        queue.requests.push_back(request);
+        if(queue.busy || (queue.requests.size() > 1)) {
+            // the client is already running or waiting for a worker
+            return;
+        }
+        m_ready.push_back(client.get());
+    }
+    m_cond.notify_one();
+}
+
+void csRequestDispatcher::Completed(csClient* client)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::unordered_map<csClient*, ClientQueue>::iterator iter = m_clients.find(client);
+        if(iter == m_clients.end() || !iter->second.busy) { return; }
+
+        ClientQueue& queue = iter->second;
+        if(clPerfTrace::Get().IsEnabled()) {
+            clPerfTrace::Get().AddSpan("cli", queue.command, queue.start, clPerfTrace::Now() - queue.start);
+        }
+        queue.busy = false;
+        if(queue.requests.empty()) {
+            m_clients.erase(iter);
+            return;
+        }
+        m_ready.push_back(client);
+    }
+    m_cond.notify_one();
+}
+
+bool csRequestDispatcher::IsIdle()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_clients.empty();
+}
+
+void csRequestDispatcher::DoWork()
+{
+    CL_TRACE_THREAD_NAME("Request worker");
+
+    // Every worker has its own handlers: the handlers keep the options of the request they process
+    csCommandHandlerManager handlers;
+    m_manager->RegisterHandlers(handlers);
+
+    while(true) {
+        csClient::Ptr_t client;
+        wxString request;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cond.wait(lock, [&]() { return m_shutdown || !m_ready.empty(); });
+            if(m_shutdown) { break; }
+
+            ClientQueue& queue = m_clients[m_ready.front()];
+            m_ready.pop_front();
+            client = queue.client;
+            request = queue.requests.front();
+            queue.requests.pop_front();
+            queue.busy = true;
+            queue.start = clPerfTrace::Now();
+        }
+
+        // Each request is in the form of: { "command": "...", "options": {...} }
+        JSON root(request);
+        JSONItem item = root.toElement();
+        csCommandHandlerBase::Ptr_t handler;
+        wxString command;
+        if(item.isOk() && item.hasNamedObject("command")) {
+            command = item.namedObject("command").toString();
+            handler = handlers.FindHandler(command);
+        }
+        if(!handler) {
+            clERROR() << "Invalid request:" << request;
+            Completed(client.get());
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_clients[client.get()].command = command;
+        }
+        clDEBUG() << "Command:" << command;
+        handler->Process(item.namedObject("options"), client);
+    }
+}
@@ -0,0 +1,79 @@
+#ifndef CSREQUESTDISPATCHER_H
+#define CSREQUESTDISPATCHER_H
+
+#include "csClient.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <wx/string.h>
+
+class csManager;
+
+/**
+ * @class csRequestDispatcher
+ * @brief process the requests of the clients on a pool of worker threads. The requests of different clients run
+ * concurrently, the requests of a client run one after the other: a request starts once the previous request of
+ * its client has completed (see Completed())
+ */
+class csRequestDispatcher
+{
+    struct ClientQueue {
+        csClient::Ptr_t client;
+        std::deque<wxString> requests;
+        bool busy;
+        // The command being processed and its start time, used for the performance trace
+        wxString command;
+        long long start;
+
+        ClientQueue()
+            : busy(false)
+            , start(0)
+        {
+        }
+    };
+
+    csManager* m_manager;
+    std::vector<std::thread*> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::unordered_map<csClient*, ClientQueue> m_clients;
+    std::deque<csClient*> m_ready; // clients with pending requests and no running request
+    bool m_shutdown;
+
+protected:
+    void DoWork();
+
+public:
+    csRequestDispatcher(csManager* manager);
+    virtual ~csRequestDispatcher();
+
+    /**
+     * @brief start 'threads' workers
+     */
+    void Start(size_t threads);
+
+    /**
+     * @brief stop the workers, the pending requests are dropped
+     */
+    void Stop();
+
+    /**
+     * @brief queue a request: a JSON object in the form of { "command": "...", "options": {...} }
+     */
+    void Queue(csClient::Ptr_t client, const wxString& request);
+
+    /**
+     * @brief the running request of 'client' completed, its next request can start
+     */
+    void Completed(csClient* client);
+
+    /**
+     * @brief return true if there are no running nor pending requests
+     */
+    bool IsIdle();
+};
+
+#endif // CSREQUESTDISPATCHER_H
@@ -1,3 +1,4 @@
+#include "clPerfTrace.h"
 #include "cl_standard_paths.h"
 #include "csConfig.h"
 #include "file_logger.h"
@@ -12,6 +13,8 @@ IMPLEMENT_APP_CONSOLE(MainApp)
 static const wxCmdLineEntryDesc cmdLineDesc[] = {
     { wxCMD_LINE_SWITCH, "v", "version", "Print current version", wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
     { wxCMD_LINE_SWITCH, "h", "help", "Print usage", wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
+    { wxCMD_LINE_OPTION, "t", "trace", "Record a performance trace and save it to the given file (Chrome trace format)",
+      wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
     { wxCMD_LINE_PARAM, "c", "command", "command", wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
     { wxCMD_LINE_PARAM, "o", "options", "options", wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL },
     { wxCMD_LINE_NONE }
@@ -28,6 +31,7 @@ int MainApp::OnExit()
 {
     clDEBUG() << "Going down";
     wxDELETE(m_manager);
+    if(!m_traceFile.IsEmpty()) { clPerfTrace::Get().Save(m_traceFile); }
     return TRUE;
 }
 
@@ -63,6 +67,11 @@ bool MainApp::DoParseCommandLine(wxCmdLineParser& parser)
     
     m_manager->GetCommand() = parser.GetParam(0);
     m_manager->GetOptions() = parser.GetParam(1);
+
+    if(parser.Found("t", &m_traceFile)) {
+        clPerfTrace::Get().Enable(true);
+        CL_TRACE_THREAD_NAME("Main thread");
+    }
     
     if(parser.Found("v")) {
         // Print version and exit
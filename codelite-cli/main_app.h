@@ -9,6 +9,7 @@ class MainApp : public wxAppConsole
 {
 protected:
     csManager* m_manager;
+    wxString m_traceFile;
 
 protected:
     /**
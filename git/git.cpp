@@ -118,6 +118,7 @@ GitPlugin::GitPlugin(IManager* manager)
     , m_pathGITExecutable(wxT("git"))
     , m_pathGITKExecutable(wxT("gitk"))
     , m_bActionRequiresTreUpdate(false)
+    , m_fileTreeRebuilt(true)
     , m_process(NULL)
     , m_eventHandler(NULL)
     , m_topWindow(NULL)
@@ -145,6 +146,7 @@ GitPlugin::GitPlugin(IManager* manager)
                                   this);
     EventNotifier::Get()->Connect(wxEVT_PROJ_FILE_REMOVED, clCommandEventHandler(GitPlugin::OnFilesRemovedFromProject),
                                   NULL, this);
+    EventNotifier::Get()->Bind(wxEVT_FILE_VIEW_REFRESHED, &GitPlugin::OnFileViewRefreshed, this);
     EventNotifier::Get()->Connect(wxEVT_WORKSPACE_CONFIG_CHANGED,
                                   wxCommandEventHandler(GitPlugin::OnWorkspaceConfigurationChanged), NULL, this);
     EventNotifier::Get()->Connect(wxEVT_CL_FRAME_TITLE, clCommandEventHandler(GitPlugin::OnMainFrameTitle), NULL, this);
@@ -420,6 +422,7 @@ void GitPlugin::UnPlug()
                                      NULL, this);
     EventNotifier::Get()->Disconnect(wxEVT_WORKSPACE_CONFIG_CHANGED,
                                      wxCommandEventHandler(GitPlugin::OnWorkspaceConfigurationChanged), NULL, this);
+    EventNotifier::Get()->Unbind(wxEVT_FILE_VIEW_REFRESHED, &GitPlugin::OnFileViewRefreshed, this);
     EventNotifier::Get()->Unbind(wxEVT_ACTIVE_PROJECT_CHANGED, &GitPlugin::OnActiveProjectChanged, this);
     EventNotifier::Get()->Unbind(wxEVT_CODELITE_MAINFRAME_GOT_FOCUS, &GitPlugin::OnAppActivated, this);
     EventNotifier::Get()->Unbind(wxEVT_FILES_MODIFIED_REPLACE_IN_FILES, &GitPlugin::OnReplaceInFiles, this);
@@ -971,6 +974,7 @@ void GitPlugin::OnFileSaved(clCommandEvent& e)
     for(it = modifiedIDs.begin(); it != modifiedIDs.end(); ++it) {
         if(!it->second.IsOk()) {
             GIT_MESSAGE(wxT("Stored item not found in tree, rebuilding item IDs"));
+            m_fileTreeRebuilt = true;
             gitAction ga(gitListAll, wxT(""));
             m_gitActionQueue.push_back(ga);
             break;
@@ -992,6 +996,7 @@ void GitPlugin::OnFilesAddedToProject(clCommandEvent& e)
     const wxArrayString& files = e.GetStrings();
     if(!files.IsEmpty() && !m_repositoryDirectory.IsEmpty()) {
         GIT_MESSAGE(wxT("Files added to project, updating file list"));
+        m_fileTreeRebuilt = true;
         DoAddFiles(files);
         RefreshFileListView();
     }
@@ -1004,6 +1009,25 @@ void GitPlugin::OnFilesRemovedFromProject(clCommandEvent& e)
     RefreshFileListView(); // in git world, deleting a file is enough
 }
 
+/*******************************************************************************/
+void GitPlugin::OnFileViewRefreshed(wxCommandEvent& e)
+{
+    e.Skip();
+
+    // The file view items were recreated (e.g. a project was reloaded) and lost their overlays.
+    // Colour the entire tree on the next listing
+    m_fileTreeRebuilt = true;
+    if(m_repositoryDirectory.IsEmpty()) { return; }
+
+    std::list<gitAction>::const_iterator iter = m_gitActionQueue.begin();
+    for(; iter != m_gitActionQueue.end(); ++iter) {
+        if(iter->action == gitListModified) { return; }
+    }
+    gitAction ga(gitListModified, wxT(""));
+    m_gitActionQueue.push_back(ga);
+    ProcessGitActionQueue();
+}
+
 /*******************************************************************************/
 void GitPlugin::OnWorkspaceLoaded(wxCommandEvent& e)
 {
@@ -1040,6 +1064,19 @@ void GitPlugin::ProcessGitActionQueue()
 
     if(m_process) { return; }
 
+    // Listing the repository files is expensive on large repositories. If the same listing is queued again
+    // later on, skip this one: the later one will reflect the up to date state anyway
+    if(ga.action == gitListAll || ga.action == gitListModified) {
+        std::list<gitAction>::const_iterator iter = m_gitActionQueue.begin();
+        for(++iter; iter != m_gitActionQueue.end(); ++iter) {
+            if(iter->action == ga.action) {
+                m_gitActionQueue.pop_front();
+                ProcessGitActionQueue();
+                return;
+            }
+        }
+    }
+
     wxString command = m_pathGITExecutable;
 
     // Wrap the executable with quotes if needed
@@ -1308,47 +1345,69 @@ void GitPlugin::FinishGitListAction(const gitAction& ga)
 
     if(!(data.GetFlags() & GitEntry::Git_Colour_Tree_View)) return;
 
-    wxArrayString tmpArray = wxStringTokenize(m_commandOutput, wxT("\n"), wxTOKEN_STRTOK);
-
-    // Convert path to absolute
-    for(unsigned i = 0; i < tmpArray.GetCount(); ++i) {
-        wxFileName fname(tmpArray[i]);
-        fname.MakeAbsolute(m_repositoryDirectory);
-        tmpArray[i] = fname.GetFullPath();
-    }
-
-    // convert the array to set for performance
+    // git prints the paths relative to the repository root, using '/' as the separator
+    // Convert them to absolute paths with plain string operations: wxFileName is too slow for 100K files
+    wxString prefix = wxFileName(m_repositoryDirectory, "").GetPath(wxPATH_GET_VOLUME | wxPATH_GET_SEPARATOR);
     wxStringSet_t gitFileSet;
-    gitFileSet.insert(tmpArray.begin(), tmpArray.end());
+    size_t start = 0;
+    while(start < m_commandOutput.length()) {
+        size_t end = m_commandOutput.find('\n', start);
+        if(end == wxString::npos) { end = m_commandOutput.length(); }
+        wxString path = m_commandOutput.Mid(start, end - start);
+        start = end + 1;
+
+        path.Trim();
+        if(path.IsEmpty()) { continue; }
+#ifdef __WXMSW__
+        path.Replace("/", "\\");
+#endif
+        gitFileSet.insert(prefix + path);
+    }
 
     if(ga.action == gitListAll) {
-        m_mgr->SetStatusMessage(_("Colouring tracked git files..."), 0);
-        ColourFileTree(m_mgr->GetWorkspaceTree(), gitFileSet, OverlayTool::Bmp_OK);
-        m_trackedFiles.swap(gitFileSet);
+        if(m_fileTreeRebuilt) {
+            // The tree items have no overlay: colour all the tracked files and restore the modified ones
+            m_mgr->SetStatusMessage(_("Colouring tracked git files..."), 0);
+            ColourFileTree(m_mgr->GetWorkspaceTree(), gitFileSet, OverlayTool::Bmp_OK);
+            ColourFileTree(m_mgr->GetWorkspaceTree(), m_modifiedFiles, OverlayTool::Bmp_Modified);
+            m_trackedFiles.swap(gitFileSet);
+            m_fileTreeRebuilt = false;
+
+        } else if(gitFileSet != m_trackedFiles) {
+            m_mgr->SetStatusMessage(_("Colouring tracked git files..."), 0);
+            ColourFileTree(m_mgr->GetWorkspaceTree(), gitFileSet, OverlayTool::Bmp_OK);
+            m_trackedFiles.swap(gitFileSet);
+        }
 
-    } else if(ga.action == gitListModified) {
+    } else if(ga.action == gitListModified && m_fileTreeRebuilt) {
+        // The tree items have no overlay: the differences with the previous listing are not enough
         m_mgr->SetStatusMessage(_("Colouring modified git files..."), 0);
-        // Reset modified files
-        ColourFileTree(m_mgr->GetWorkspaceTree(), m_modifiedFiles, OverlayTool::Bmp_OK);
-        // First get an up to date map of the filepaths/treeitemids
-        // (Trying to cache these results in segfaults when the tree has been modified)
-        std::map<wxString, wxTreeItemId> IDs;
-        CreateFilesTreeIDsMap(IDs);
-
-        // Now filter using the list of modified files, gitFileList, to find which IDs to colour differently
-        wxStringSet_t toColour;
-        wxStringSet_t::const_iterator iter = gitFileSet.begin();
-        for(; iter != gitFileSet.end(); ++iter) {
-            wxTreeItemId id = IDs[(*iter)];
-            if(id.IsOk()) {
-                DoSetTreeItemImage(m_mgr->GetWorkspaceTree(), id, OverlayTool::Bmp_Modified);
+        ColourFileTree(m_mgr->GetWorkspaceTree(), m_trackedFiles, OverlayTool::Bmp_OK);
+        ColourFileTree(m_mgr->GetWorkspaceTree(), gitFileSet, OverlayTool::Bmp_Modified);
+        m_modifiedFiles.swap(gitFileSet);
+        m_fileTreeRebuilt = false;
 
-            } else {
-                toColour.insert(*iter);
-            }
+    } else if(ga.action == gitListModified) {
+        // Only the files whose state changed since the previous listing need to be updated in the tree
+        wxStringSet_t noLongerModified;
+        wxStringSet_t newlyModified;
+        wxStringSet_t::const_iterator iter = m_modifiedFiles.begin();
+        for(; iter != m_modifiedFiles.end(); ++iter) {
+            if(gitFileSet.count(*iter) == 0) { noLongerModified.insert(*iter); }
+        }
+        for(iter = gitFileSet.begin(); iter != gitFileSet.end(); ++iter) {
+            if(m_modifiedFiles.count(*iter) == 0) { newlyModified.insert(*iter); }
         }
 
-        if(!toColour.empty()) { ColourFileTree(m_mgr->GetWorkspaceTree(), toColour, OverlayTool::Bmp_Modified); }
+        if(!noLongerModified.empty() || !newlyModified.empty()) {
+            m_mgr->SetStatusMessage(_("Colouring modified git files..."), 0);
+            if(!noLongerModified.empty()) {
+                ColourFileTree(m_mgr->GetWorkspaceTree(), noLongerModified, OverlayTool::Bmp_OK);
+            }
+            if(!newlyModified.empty()) {
+                ColourFileTree(m_mgr->GetWorkspaceTree(), newlyModified, OverlayTool::Bmp_Modified);
+            }
+        }
 
         // Finally, cache the modified-files list: it's used in other functions
         m_modifiedFiles.swap(gitFileSet);
@@ -1879,6 +1938,8 @@ void GitPlugin::AddDefaultActions()
 /*******************************************************************************/
 void GitPlugin::ColourFileTree(clTreeCtrl* tree, const wxStringSet_t& files, OverlayTool::BmpType bmpType) const
 {
+    if(files.empty()) return;
+
     clConfig conf("git.conf");
     GitEntry data;
     conf.ReadItem(&data);
@@ -1989,6 +2050,7 @@ void GitPlugin::DoCleanup()
     m_progressMessage.Clear();
     m_commandOutput.Clear();
     m_bActionRequiresTreUpdate = false;
+    m_fileTreeRebuilt = true;
     wxDELETE(m_process);
     m_mgr->GetDockingManager()->GetPane(wxT("Workspace View")).Caption(wxT("Workspace View"));
     m_mgr->GetDockingManager()->Update();
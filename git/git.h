@@ -158,6 +158,7 @@ class GitPlugin : public IPlugin
     wxString m_progressMessage;
     wxString m_commandOutput;
     bool m_bActionRequiresTreUpdate;
+    bool m_fileTreeRebuilt; // the file view items were recreated since the tree was last coloured
     IProcess* m_process;
     wxEvtHandler* m_eventHandler;
     wxWindow* m_topWindow;
@@ -225,6 +226,7 @@ private:
     void OnFileSaved(clCommandEvent& e);
     void OnFilesAddedToProject(clCommandEvent& e);
     void OnFilesRemovedFromProject(clCommandEvent& e);
+    void OnFileViewRefreshed(wxCommandEvent& e);
     void OnWorkspaceLoaded(wxCommandEvent& e);
     void OnWorkspaceClosed(wxCommandEvent& e);
     void OnWorkspaceConfigurationChanged(wxCommandEvent& e);